@@ -0,0 +1,58 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "benchmark_shared.h"
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/indexed_set.h"
+#include "mcrl2/utilities/benchmark.h"
+
+using namespace atermpp;
+
+int main(int, char*[])
+{
+  std::size_t size = 1000000;
+  std::size_t iterations = 10;
+
+  // The elements are terms f(i, c), such that hashing and comparison are not trivial.
+  function_symbol f("f", 2);
+  aterm_appl c_term(function_symbol("c", 0));
+  std::vector<aterm_appl> elements;
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    elements.push_back(aterm_appl(f, aterm_int(i), c_term));
+  }
+
+  indexed_set<aterm_appl> set;
+  mcrl2::utilities::run_benchmark("indexed_set.insert", iterations * size, [&]()
+  {
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+      set.clear();
+      for (const aterm_appl& t: elements)
+      {
+        set.put(t);
+      }
+    }
+  });
+
+  std::size_t found = 0;
+  mcrl2::utilities::run_benchmark("indexed_set.find", iterations * size, [&]()
+  {
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+      for (const aterm_appl& t: elements)
+      {
+        found += set.index(t) != indexed_set<aterm_appl>::npos;
+      }
+    }
+  });
+
+  mcrl2::utilities::report_benchmarks("atermpp_indexed_set");
+  return found == iterations * size ? 0 : 1;
+}
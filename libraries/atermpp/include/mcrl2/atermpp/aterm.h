@@ -94,7 +94,10 @@ class aterm
          the reference count of t.m_term is increased, as otherwise if the terms are exactly
          the same, the reference count can temporarily become 0. */
       const_cast<aterm&>(t).increase_reference_count<true>();
-      m_term->decrease_reference_count();
+      if (m_term!=nullptr)
+      {
+        m_term->decrease_reference_count();
+      }
       m_term=t.m_term;
     }
 
@@ -133,12 +136,13 @@ class aterm
     }
 
     /// \brief Move constructor.
+    /// \details The term is handed over without changing its reference count. The
+    ///          term t is left empty, and may only be destroyed or assigned to.
     /// \param t Term that is moved to this.
     aterm(aterm&& t) noexcept 
       : m_term(t.m_term) 
     { 
-      t.increase_reference_count<true>();  // The use of swap is not possible, 
-                                           // as a term needs to be constructed. 
+      t.m_term=nullptr;
     } 
 
     /// \brief Assignment operator.
@@ -153,14 +157,19 @@ class aterm
     /// \param t a term to be assigned.
     aterm& operator=(aterm&& t) noexcept
     {
-      swap(t);
+      // No assertions on the reference counts, as one of the terms may be empty
+      // because it has been moved from.
+      std::swap(m_term,t.m_term);
       return *this;
     }
 
     /// \brief Destructor.
     ~aterm () noexcept
     {
-      decrease_reference_count();
+      if (m_term!=nullptr)
+      {
+        decrease_reference_count();
+      }
     }
 
     /// \brief Returns whether this term is a term_appl.
@@ -286,6 +295,66 @@ class aterm
     }
 };
 
+/// \brief A reference to a term that does not protect the term.
+/// \details Constructing, copying and destroying an unprotected_aterm does not change
+///          the reference count of the term, and does not even access it. It is only
+///          valid as long as the term is protected by an aterm, for instance a term of
+///          which it is a subterm. It is intended for temporary references to terms in
+///          builders, rewriters and traversers, and for keys of maps of which the terms
+///          are protected elsewhere.
+class unprotected_aterm
+{
+  protected:
+    detail::_aterm* m_term;
+
+  public:
+    /// \brief Default constructor. The result does not refer to a term.
+    unprotected_aterm() noexcept
+      : m_term(nullptr)
+    {}
+
+    /// \brief Constructor.
+    /// \param t The term that is referred to.
+    unprotected_aterm(const aterm& t) noexcept
+      : m_term(detail::address(t))
+    {}
+
+    /// \brief Returns true if this object does not refer to a term.
+    bool empty() const noexcept
+    {
+      return m_term==nullptr;
+    }
+
+    /// \brief Returns the term that is referred to, without protecting it.
+    /// \details The result is only valid as long as this object is.
+    template <class Term = aterm>
+    const Term& get() const noexcept
+    {
+      static_assert(std::is_base_of<aterm, Term>::value, "unprotected_aterm::get can only return terms");
+      static_assert(sizeof(Term) == sizeof(aterm),
+                    "unprotected_aterm::get cannot be applied types derived from aterms where extra fields are added");
+      assert(m_term!=nullptr);
+      return reinterpret_cast<const Term&>(m_term);
+    }
+
+    friend bool operator==(const unprotected_aterm& t1, const unprotected_aterm& t2) noexcept
+    {
+      return t1.m_term==t2.m_term;
+    }
+
+    friend bool operator!=(const unprotected_aterm& t1, const unprotected_aterm& t2) noexcept
+    {
+      return t1.m_term!=t2.m_term;
+    }
+
+    friend bool operator<(const unprotected_aterm& t1, const unprotected_aterm& t2) noexcept
+    {
+      return t1.m_term<t2.m_term;
+    }
+
+    friend struct std::hash<unprotected_aterm>;
+};
+
 template <class Term1, class Term2>
 struct is_convertible : public
     std::conditional<std::is_base_of<aterm, Term1>::value &&
@@ -420,6 +489,18 @@ struct hash<atermpp::aterm>
   }
 };
 
+/// \brief specialization of the standard std::hash function. An unprotected_aterm has
+///        the same hash value as the aterm it refers to.
+template<>
+struct hash<atermpp::unprotected_aterm>
+{
+  std::size_t operator()(const atermpp::unprotected_aterm& t) const
+  {
+    std::hash<atermpp::detail::_aterm*> aterm_hasher;
+    return aterm_hasher(t.m_term);
+  }
+};
+
 } // namespace std
 
 
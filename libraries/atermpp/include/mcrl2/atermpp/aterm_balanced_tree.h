@@ -121,6 +121,13 @@ class term_balanced_tree: public aterm_appl
     {
     }
 
+    /// \brief Creates a node with the given left and right branches.
+    /// \details To obtain a balanced tree, the size of left must be equal to the size of right, or one more.
+    term_balanced_tree(const term_balanced_tree& left, const term_balanced_tree& right)
+      : aterm_appl(tree_node_function(), left, right)
+    {
+    }
+
     /// \brief Creates an term_balanced_tree with a copy of a range.
     /// \param first The start of a range of elements.
     /// \param size The size of the range of elements.
@@ -74,7 +74,7 @@ struct found_term_exception
 /// \param op A unary function on terms
 /// \return The result of the algorithm
 template <typename UnaryFunction>
-UnaryFunction for_each_impl(aterm t, UnaryFunction op)
+UnaryFunction for_each_impl(const aterm& t, UnaryFunction op)
 {
   if (t.type_is_list())
   {
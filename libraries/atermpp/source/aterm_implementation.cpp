@@ -24,6 +24,7 @@
 
 
 #include "mcrl2/utilities/logger.h"
+#include "mcrl2/utilities/metrics.h"
 #include "mcrl2/atermpp/detail/aterm_implementation.h"
 #include "mcrl2/atermpp/detail/aterm_int.h"
 #include "mcrl2/atermpp/aterm_appl.h"
@@ -227,6 +228,9 @@ void collect_terms_with_reference_count_0()
   // This function puts all with reference count==0 in the freelist, in the reverse order as
   // the sequence of blocks.
 
+  static mcrl2::utilities::metrics_histogram& garbage_collection_time = mcrl2::utilities::metrics().histogram("atermpp.garbage_collection_time_us");
+  mcrl2::utilities::scoped_metrics_timer timer(garbage_collection_time);
+
 
   // First put all terms with reference count 0 in the freelist.
   for(std::size_t size=TERM_SIZE; size<terminfo_size; ++size)
@@ -296,6 +300,11 @@ void collect_terms_with_reference_count_0()
     }
   }
   garbage_collect_count_down=(1+number_of_blocks)*(BLOCK_SIZE/(sizeof(std::size_t)*16));
+
+  static mcrl2::utilities::metrics_gauge& load_factor = mcrl2::utilities::metrics().gauge("atermpp.term_table_load_factor");
+  static mcrl2::utilities::metrics_gauge& table_size = mcrl2::utilities::metrics().gauge("atermpp.term_table_size");
+  load_factor.set(static_cast<double>(total_nodes_in_hashtable)/aterm_table_size);
+  table_size.set(aterm_table_size);
 }
 
 #ifdef MCRL2_CHECK_ATERMPP_CLEANUP
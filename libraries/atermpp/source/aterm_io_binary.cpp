@@ -18,7 +18,11 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cassert>
+#include <cstdint>
+#include <atomic>
+#include <exception>
 #include <stdexcept>
+#include <thread>
 #include <unordered_set>
 #include <bitset>
 
@@ -107,190 +111,20 @@ static const std::size_t BAF_MAGIC = 0xbaf;
 // 23 November 2013  : version changed to 0x0302 (introduction of index for variable types)
 // 24 September 2014 : version changed to 0x0303 (introduction of stochastic distribution)
 //  2 April 2017     : version changed to 0x0304 (removed a few superfluous fields in the format)
+// 18 October 2026   : version changed to 0x0305 (the shared term graph is written in independently
+//                     decodable chunks preceded by an index, see write_baf)
+//
+// Files in version 0x0304 can still be read.
 
-static const std::size_t BAF_VERSION = 0x0304;
-
-struct top_symbol
-{
-  /// \brief index into the vector with all sym_write_entries
-  std::size_t index;
-  /// \brief Identification number of this function symbol in the output
-  std::size_t code;
-
-  top_symbol(std::size_t index_, std::size_t code_)
-   : index(index_), code(code_)
-  {}
-};
-
-class top_symbols_t
-{
-  public:
-    std::size_t code_width;          /* This is the log of the number of symbols both for "symbols" and "index_into_symbols". */
-    std::vector<top_symbol> symbols; /* The set of symbols that occur directly below the top symbol.
-                                        The order of the symbols in this vector is important. */
-    indexed_set<function_symbol> index_into_symbols;
-                                     /* This mapping helps to find the entry in symbols with the given
-                                        function symbol */
-};
-
-class sym_write_entry
-{
-  public:
-    /// \brief The function symbol that this write entry is about
-    const function_symbol id;
-    /**
-     * \brief After executing compute_num_bits, this stores the number of bits required
-     * to uniquely identify each occurrence of id.
-     */
-    std::size_t term_width;
-    /**
-     * \brief The number of unique occurrences of id, i.e. the number of term that
-     * have id as their function symbol.
-     */
-    std::size_t num_terms;
-    /**
-     * \brief Maps each argument index to a table with function symbols that may
-     * occur at that index
-     * top_symbols.size() == id.arity()
-     */
-    std::vector<top_symbols_t> top_symbols;
-    /**
-     * \brief Counter to indicate which argument is being worked on
-     */
-    std::size_t cur_index;
-
-    sym_write_entry(const function_symbol& id_)
-     : id(id_),
-       term_width(0),
-       num_terms(0),
-       cur_index(0)
-    {}
-};
-
-class sym_read_entry
-{
-  public:
-    function_symbol sym;
-    std::size_t term_width;
-    std::vector<aterm> terms;
-    std::vector<vector<std::size_t> > topsyms;
-    std::vector<std::size_t> sym_width;
+static const std::size_t BAF_VERSION = 0x0305;
+static const std::size_t BAF_VERSION_BIT_STREAM = 0x0304;
 
-    sym_read_entry():
-       term_width(0)
-    {
-    }
-};
+/// \brief The maximal number of term nodes that are stored in a single chunk.
+static const std::size_t BAF_CHUNK_SIZE = 1 << 16;
 
 static char* text_buffer = nullptr;
 static std::size_t text_buffer_size = 0;
 
-static std::size_t  bits_in_buffer = 0; /* how many bits in bit_buffer are used */
-/**
- * \brief Buffer that is filled starting from bit 127 when reading or writing
- */
-static std::bitset<128> read_write_buffer(0);
-
-/**
- * \brief Reverse the order of bits in val.
- * \detail In BAF version 0x0304 the bits are written in reverse order. When bumping
- * the version number, one should also consider to remove this reversal.
- */
-static void reverse_bit_order(std::size_t& val)
-{
-  if(std::numeric_limits<std::size_t>::digits == 64)
-  {
-    val = ((val << 32) & 0xFFFFFFFF00000000) | ((val >> 32) & 0x00000000FFFFFFFF);
-  }
-  val = ((val << 16) & 0xFFFF0000FFFF0000) | ((val >> 16) & 0x0000FFFF0000FFFF);
-  val = ((val << 8)  & 0xFF00FF00FF00FF00) | ((val >> 8)  & 0x00FF00FF00FF00FF);
-  val = ((val << 4)  & 0xF0F0F0F0F0F0F0F0) | ((val >> 4)  & 0x0F0F0F0F0F0F0F0F);
-  val = ((val << 2)  & 0xCCCCCCCCCCCCCCCC) | ((val >> 2)  & 0x3333333333333333);
-  val = ((val << 1)  & 0xAAAAAAAAAAAAAAAA) | ((val >> 1)  & 0x5555555555555555);
-}
-
-/**
- * \brief Write the nr_bits least significant bits from val to os
- */
-static void writeBits(std::size_t val, const std::size_t nr_bits, ostream& os)
-{
-  if(nr_bits == 0)
-  {
-    return;
-  }
-  reverse_bit_order(val);
-  // Add val to the buffer
-  read_write_buffer |= std::bitset<128>(val) << (128 - std::numeric_limits<std::size_t>::digits - bits_in_buffer);
-  bits_in_buffer += nr_bits;
-  // Write 8 bytes if available
-  if(bits_in_buffer >= 64)
-  {
-    unsigned long long write_value = (read_write_buffer >> 64).to_ullong();
-    read_write_buffer <<= 64;
-    bits_in_buffer -= 64;
-    for(uint32_t i = 8; i > 0; --i)
-    {
-      os.put((write_value >> (8*(i-1))) & 0xFF);
-    }
-  }
-}
-
-/**
- * \brief Flush the remaining bits in the buffer to os.
- */
-static void flushBitsToWriter(ostream& os)
-{
-  if (bits_in_buffer > 0)
-  {
-    unsigned long long write_value = (read_write_buffer >> 64).to_ullong();
-    for(uint32_t i = 8; i > 7 - bits_in_buffer / 8; --i)
-    {
-      os.put((write_value >> (8*(i-1))) & 0xFF);
-    }
-    if (os.fail())
-    {
-      throw mcrl2::runtime_error("Failed to write the last byte to the output file/stream.");
-    }
-    read_write_buffer = std::bitset<128>(0);
-    bits_in_buffer = 0;
-  }
-}
-
-/**
- * @brief readBits Reads an n-bit integer from the input stream.
- * @param val      Variable to store integer in.
- * @param nr_bits  Number of bits to read from the input stream.
- * @param is       The input stream.
- * @return true on success, false on failure (EOF).
- */
-static
-bool readBits(std::size_t& val, const unsigned int nr_bits, istream& is)
-{
-  val = 0;
-  if(nr_bits == 0)
-  {
-    return true;
-  }
-  while(bits_in_buffer < nr_bits)
-  {
-    // Read bytes until the buffer is sufficiently full
-    int byte = is.get();
-    if(is.fail())
-    {
-      return false;
-    }
-    read_write_buffer |= std::bitset<128>(byte) << (56 + 64 - bits_in_buffer);
-    bits_in_buffer += 8;
-  }
-  val = (read_write_buffer >> (128 - std::numeric_limits<std::size_t>::digits)).to_ullong() &
-      (std::numeric_limits<std::size_t>::max() <<
-         (std::numeric_limits<std::size_t>::digits - std::min(nr_bits, static_cast<unsigned int>(std::numeric_limits<std::size_t>::digits))));
-  bits_in_buffer -= nr_bits;
-  read_write_buffer <<= nr_bits;
-  reverse_bit_order(val);
-  return true;
-}
-
 static void writeString(const std::string& str, ostream& os)
 {
   /* Write length. */
@@ -335,6 +169,20 @@ static void write_symbol(const function_symbol& sym, ostream& os)
   writeInt(sym.arity(), os);
 }
 
+/**
+  * Read a single symbol from file.
+  */
+static function_symbol read_symbol(istream& is)
+{
+  std::size_t len=readString(is);
+
+  text_buffer[len] = '\0';
+
+  std::size_t arity = readInt(is);
+
+  return function_symbol(text_buffer, arity);
+}
+
 /**
  * \brief Get the function symbol from an aterm
  * \detail This function is necessary only becuase aterm::function() is protected
@@ -345,20 +193,6 @@ static const function_symbol& get_function_symbol(const aterm& t)
   return detail::address(t)->function();
 }
 
-/**
- * \brief Retrieve the index into the sym_write_entry table belonging to the top symbol
- * of a term. Could be a special symbol (AS_INT, etc) when the term is not an application.
- * \detail sym_entries[result].id == t.function()
- */
-static std::size_t get_fn_symbol_index(const aterm& t, const indexed_set<function_symbol>& index)
-{
-  const function_symbol& sym = get_function_symbol(t);
-  std::size_t result = index.index(sym);
-  assert(result != indexed_set<function_symbol>::npos);
-  return result;
-}
-
-
 /**
  * How many bits are needed to represent <val>
  * Basically, this function is equal to log2(val), except that it maps 0 to 0
@@ -381,6 +215,22 @@ static std::size_t bit_width(std::size_t val)
   return nr_bits;
 }
 
+/**
+ * \brief The number of bits that is needed to store each of the indices 0, ..., n-1.
+ */
+static std::size_t index_width(std::size_t n)
+{
+  std::size_t nr_bits = 0;
+  if (n > 1)
+  {
+    for (std::size_t val = n - 1; val != 0; val >>= 1)
+    {
+      nr_bits++;
+    }
+  }
+  return nr_bits;
+}
+
 /**
  * \brief Get argument number i (zero indexed) from term t.
  */
@@ -401,37 +251,188 @@ static const aterm& subterm(const aterm& t, std::size_t i)
 }
 
 /**
- * \brief Add a term to the global term table. Update the symbol tables.
+ * \brief A flat representation of (a contiguous part of) the shared term graph.
+ * \detail Node i has function symbol symbols[i] (an index into the symbol table) and
+ * arguments arguments[first_argument[i]], ..., arguments[first_argument[i+1]-1]. The
+ * arguments are indices of nodes that occur earlier in the graph, or the value of the
+ * node if it is an integer. The root of the graph is its last node.
  */
-static void add_term(sym_write_entry& entry, const aterm& term,
-  const indexed_set<function_symbol>& symbol_index_map,
-  std::unordered_map<aterm, std::size_t>& term_index_map,
-  std::vector<sym_write_entry>& sym_entries)
+struct term_graph
 {
-  term_index_map[term] = entry.num_terms++;
-  std::size_t arity = entry.id.arity();
-  // Initialize the vector if necessary
-  if(entry.top_symbols.size() != arity)
+  std::vector<std::size_t> symbols;
+  std::vector<std::size_t> first_argument = { 0 };
+  std::vector<std::size_t> arguments;
+
+  std::size_t size() const
   {
-    entry.top_symbols = std::vector<top_symbols_t>(arity);
+    return symbols.size();
   }
+};
+
+/**
+ * \brief Writes bit sequences into 64 bit words, starting at the most significant bit.
+ */
+class bit_writer
+{
+  protected:
+    std::vector<std::uint64_t> m_words;
+    std::uint64_t m_current = 0;
+    std::size_t m_bits_in_current = 0;
+
+  public:
+    /// \brief Write the nr_bits least significant bits of val.
+    void write(std::uint64_t val, std::size_t nr_bits)
+    {
+      assert(nr_bits <= 64);
+      assert(nr_bits == 64 || (val >> nr_bits) == 0);
+      if (nr_bits == 0)
+      {
+        return;
+      }
+      std::size_t free_bits = 64 - m_bits_in_current;
+      if (nr_bits < free_bits)
+      {
+        m_current |= val << (free_bits - nr_bits);
+        m_bits_in_current += nr_bits;
+      }
+      else
+      {
+        m_words.push_back(m_current | (val >> (nr_bits - free_bits)));
+        m_bits_in_current = nr_bits - free_bits;
+        m_current = m_bits_in_current == 0 ? 0 : val << (64 - m_bits_in_current);
+      }
+    }
 
-  if (entry.id != detail::function_adm.AS_INT)
+    /// \brief Flushes the pending bits and returns the bytes in big endian order.
+    std::string bytes()
+    {
+      if (m_bits_in_current > 0)
+      {
+        m_words.push_back(m_current);
+        m_current = 0;
+        m_bits_in_current = 0;
+      }
+      std::string result(8 * m_words.size(), '\0');
+      for (std::size_t i = 0; i < m_words.size(); ++i)
+      {
+        for (std::size_t j = 0; j < 8; ++j)
+        {
+          result[8*i + j] = static_cast<char>((m_words[i] >> (56 - 8*j)) & 0xFF);
+        }
+      }
+      return result;
+    }
+};
+
+/**
+ * \brief Reads bit sequences written by a bit_writer from a block of bytes.
+ */
+class bit_reader
+{
+  protected:
+    const unsigned char* m_data;
+    std::size_t m_nr_words;
+    std::size_t m_next_word = 0;
+    std::uint64_t m_current = 0;
+    std::size_t m_bits_in_current = 0;
+
+    static std::uint64_t mask(std::size_t nr_bits)
+    {
+      return nr_bits >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << nr_bits) - 1;
+    }
+
+    std::uint64_t next_word()
+    {
+      if (m_next_word >= m_nr_words)
+      {
+        throw mcrl2::runtime_error("Could not read valid aterm from stream.");
+      }
+      const unsigned char* p = m_data + 8 * m_next_word++;
+      std::uint64_t result = 0;
+      for (std::size_t j = 0; j < 8; ++j)
+      {
+        result = (result << 8) | p[j];
+      }
+      return result;
+    }
+
+  public:
+    bit_reader(const unsigned char* data, std::size_t nr_bytes)
+      : m_data(data), m_nr_words(nr_bytes / 8)
+    {}
+
+    /// \brief Read an nr_bits bit integer.
+    std::uint64_t read(std::size_t nr_bits)
+    {
+      assert(nr_bits <= 64);
+      if (nr_bits <= m_bits_in_current)
+      {
+        m_bits_in_current -= nr_bits;
+        return (m_current >> m_bits_in_current) & mask(nr_bits);
+      }
+      std::uint64_t result = m_current & mask(m_bits_in_current);
+      std::size_t missing_bits = nr_bits - m_bits_in_current;
+      m_current = next_word();
+      m_bits_in_current = 64 - missing_bits;
+      if (missing_bits == 64)
+      {
+        return m_current;
+      }
+      return (result << missing_bits) | (m_current >> m_bits_in_current);
+    }
+};
+
+/**
+ * \brief Applies f to 0, ..., n-1 using the available hardware threads. An exception
+ * thrown by f is rethrown in the calling thread.
+ */
+template <typename Function>
+static void parallel_for_each_index(std::size_t n, Function f)
+{
+  std::size_t nr_threads = std::min<std::size_t>(n, std::max(1u, std::thread::hardware_concurrency()));
+  if (nr_threads <= 1)
   {
-    // For every argument, check whether the term should be added to the table
-    for (std::size_t cur_arg=0; cur_arg<arity; cur_arg++)
+    for (std::size_t i = 0; i < n; ++i)
     {
-      const aterm& arg = subterm(term, cur_arg);
-      top_symbols_t& tss = entry.top_symbols[cur_arg];
-      std::size_t top_symbol_index = get_fn_symbol_index(arg, symbol_index_map);
-      const function_symbol& top_symbol = sym_entries[top_symbol_index].id;
+      f(i);
+    }
+    return;
+  }
 
-      auto put_result = tss.index_into_symbols.put(top_symbol);
-      if (put_result.second)
+  std::atomic<std::size_t> next(0);
+  std::vector<std::exception_ptr> errors(nr_threads);
+  auto worker = [&](std::size_t thread_index)
+  {
+    try
+    {
+      for (std::size_t i = next++; i < n; i = next++)
       {
-        tss.symbols.emplace_back(top_symbol_index, put_result.first);
+        f(i);
       }
     }
+    catch (...)
+    {
+      errors[thread_index] = std::current_exception();
+      next = n;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 1; t < nr_threads; ++t)
+  {
+    threads.emplace_back(worker, t);
+  }
+  worker(0);
+  for (std::thread& thread: threads)
+  {
+    thread.join();
+  }
+  for (const std::exception_ptr& error: errors)
+  {
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
   }
 }
 
@@ -447,44 +448,42 @@ struct write_todo
 };
 
 /**
- * \brief If we see this function symbol for the first time, we initialize data
- * for it in symbol_index_map and sym_entries.
- * \return The sym_write_entry belonging to func.
- */
-static sym_write_entry& initialize_function_symbol(const function_symbol& func,
-  indexed_set<function_symbol>& symbol_index_map,
-  std::vector<sym_write_entry>& sym_entries)
-{
-  auto insert_result = symbol_index_map.put(func);
-  if(insert_result.second)
-  {
-    // We just found a new function symbol, it has 1 occurrence so far
-    sym_entries.emplace_back(func);
-  }
-  return sym_entries[insert_result.first];
-}
-
-/**
- * \brief Collect all terms in the term tables of each symbol
+ * \brief Collect the shared term graph of t in postfix order, i.e., every
+ * node is preceded by its arguments.
  */
 static void collect_terms(const aterm& t,
   indexed_set<function_symbol>& symbol_index_map,
-  std::unordered_map<aterm, std::size_t>& term_index_map,
-  std::vector<sym_write_entry>& sym_entries)
+  term_graph& graph)
 {
+  // All terms in this map are subterms of t, so they need not be protected.
+  std::unordered_map<unprotected_aterm, std::size_t> term_index_map;
   std::stack<write_todo> stack;
   stack.emplace(t);
 
-  // Traverse the term in a postfix order: for every term, we first process each
-  // of its arguments, before processing the term itself
   do
   {
     write_todo& current = stack.top();
-    if (current.term.type_is_int() || current.arg >= get_function_symbol(current.term).arity())
+    const function_symbol& f = get_function_symbol(current.term);
+    if (current.term.type_is_int() || current.arg >= f.arity())
     {
       // This term is an int or we are finished processing its arguments (arg >= arity)
-      sym_write_entry& we = initialize_function_symbol(get_function_symbol(current.term), symbol_index_map, sym_entries);
-      add_term(we, current.term, symbol_index_map, term_index_map, sym_entries);
+      if (term_index_map.count(current.term) == 0)
+      {
+        term_index_map[current.term] = graph.size();
+        graph.symbols.push_back(symbol_index_map.put(f).first);
+        if (current.term.type_is_int())
+        {
+          graph.arguments.push_back(aterm_int(current.term).value());
+        }
+        else
+        {
+          for (std::size_t i = 0; i < f.arity(); ++i)
+          {
+            graph.arguments.push_back(term_index_map.at(subterm(current.term, i)));
+          }
+        }
+        graph.first_argument.push_back(graph.arguments.size());
+      }
       stack.pop();
     }
     else
@@ -501,140 +500,286 @@ static void collect_terms(const aterm& t,
 }
 
 /**
- * \brief Calculate the amount of bits required to store the top symbol for every
- * argument of every function symbol and the term for every function symbol.
+ * \brief Encode the nodes first, ..., last-1 of the graph. The symbol index of node n is
+ * written using index_width(number of symbols) bits and each argument using index_width(n)
+ * bits, as it refers to an earlier node. Integers are written using INT_SIZE_IN_BAF bits.
  */
-static void compute_num_bits(std::vector<sym_write_entry>& sym_entries)
+static std::string encode_chunk(const term_graph& graph, std::size_t first, std::size_t last,
+  const std::vector<function_symbol>& symbols)
 {
-  for(sym_write_entry& cur_entry: sym_entries)
+  bit_writer writer;
+  std::size_t symbol_width = index_width(symbols.size());
+  for (std::size_t n = first; n < last; ++n)
   {
-    for(std::size_t cur_arg = 0; cur_arg < cur_entry.id.arity(); cur_arg++)
+    writer.write(graph.symbols[n], symbol_width);
+    std::size_t width = symbols[graph.symbols[n]] == detail::function_adm.AS_INT ? INT_SIZE_IN_BAF : index_width(n);
+    for (std::size_t i = graph.first_argument[n]; i < graph.first_argument[n+1]; ++i)
     {
-      top_symbols_t& tss = cur_entry.top_symbols[cur_arg];
-      tss.code_width = bit_width(tss.symbols.size());
+      writer.write(graph.arguments[i], width);
     }
-    cur_entry.term_width = bit_width(cur_entry.num_terms);
   }
+  return writer.bytes();
 }
 
 /**
- * Write all symbols in a term to file.
+ * \brief Write t to os in BAF.
+ * \detail After the header and the symbol table, the shared term graph of t is split in chunks
+ * of at most BAF_CHUNK_SIZE nodes. An index with the number of nodes and the number of bytes of
+ * each chunk precedes the chunks themselves, such that every chunk can be decoded independently.
  */
-static void write_all_symbols(ostream& os, const std::vector<sym_write_entry>& sym_entries)
+static void write_baf(const aterm& t, ostream& os)
 {
-  for(const sym_write_entry& cur_sym: sym_entries)
+  indexed_set<function_symbol> symbol_index_map;
+  term_graph graph;
+  collect_terms(t, symbol_index_map, graph);
+
+  std::vector<function_symbol> symbols;
+  for (std::size_t i = 0; i < symbol_index_map.size(); ++i)
+  {
+    symbols.push_back(symbol_index_map.get(i));
+  }
+
+  std::size_t nr_chunks = (graph.size() + BAF_CHUNK_SIZE - 1) / BAF_CHUNK_SIZE;
+  std::vector<std::string> chunks(nr_chunks);
+  parallel_for_each_index(nr_chunks, [&](std::size_t i)
   {
-    write_symbol(cur_sym.id, os);
-    writeInt(cur_sym.num_terms, os);
+    chunks[i] = encode_chunk(graph, i * BAF_CHUNK_SIZE, std::min(graph.size(), (i + 1) * BAF_CHUNK_SIZE), symbols);
+  });
 
-    for (std::size_t arg_idx=0; arg_idx<cur_sym.id.arity(); arg_idx++)
+  /* write header */
+  writeInt(0, os);
+  writeInt(BAF_MAGIC, os);
+  writeInt(BAF_VERSION, os);
+  writeInt(symbols.size(), os);
+  for (const function_symbol& f: symbols)
+  {
+    write_symbol(f, os);
+  }
+
+  /* write the chunk index, followed by the chunks */
+  writeInt(nr_chunks, os);
+  for (std::size_t i = 0; i < nr_chunks; ++i)
+  {
+    writeInt(std::min(graph.size() - i * BAF_CHUNK_SIZE, BAF_CHUNK_SIZE), os);
+    writeInt(chunks[i].size(), os);
+  }
+  for (const std::string& chunk: chunks)
+  {
+    os.write(chunk.data(), chunk.size());
+  }
+  if (os.fail())
+  {
+    throw mcrl2::runtime_error("Failed to write the term to the output file/stream.");
+  }
+}
+
+void write_term_to_binary_stream(const aterm& t, std::ostream& os)
+{
+  aterm_io_init(os);
+  write_baf(t, os);
+}
+
+/**
+ * \brief Decode a chunk with nr_nodes nodes, the first of which is node first_node.
+ */
+static void decode_chunk(const unsigned char* data, std::size_t nr_bytes,
+  std::size_t first_node, std::size_t nr_nodes,
+  const std::vector<function_symbol>& symbols,
+  term_graph& chunk)
+{
+  bit_reader reader(data, nr_bytes);
+  std::size_t symbol_width = index_width(symbols.size());
+  chunk.symbols.reserve(nr_nodes);
+  chunk.first_argument.reserve(nr_nodes + 1);
+  for (std::size_t n = first_node; n < first_node + nr_nodes; ++n)
+  {
+    std::size_t symbol = reader.read(symbol_width);
+    if (symbol >= symbols.size())
+    {
+      throw mcrl2::runtime_error("Could not read valid aterm from stream.");
+    }
+    chunk.symbols.push_back(symbol);
+    const function_symbol& f = symbols[symbol];
+    if (f == detail::function_adm.AS_INT)
     {
-      std::size_t nr_symbols = cur_sym.top_symbols[arg_idx].symbols.size();
-      writeInt(nr_symbols, os);
-      for (std::size_t top_idx=0; top_idx<nr_symbols; top_idx++)
+      chunk.arguments.push_back(reader.read(INT_SIZE_IN_BAF));
+    }
+    else
+    {
+      std::size_t width = index_width(n);
+      for (std::size_t i = 0; i < f.arity(); ++i)
       {
-        const top_symbol& ts = cur_sym.top_symbols[arg_idx].symbols[top_idx];
-        writeInt(ts.index, os);
+        std::size_t argument = reader.read(width);
+        if (argument >= n)
+        {
+          throw mcrl2::runtime_error("Could not read valid aterm from stream.");
+        }
+        chunk.arguments.push_back(argument);
       }
     }
+    chunk.first_argument.push_back(chunk.arguments.size());
   }
 }
 
 /**
- * \brief Write the term t to os in BAF
+ * \brief Read a term in the chunked format of version BAF_VERSION, after the version number.
+ * \detail The chunks are decoded in parallel. The terms themselves are constructed sequentially
+ * afterwards, because the term administration is not thread safe.
  */
-static void write_term(const aterm& t, ostream& os,
-  const indexed_set<function_symbol>& symbol_index_map,
-  const std::unordered_map<aterm, std::size_t>& term_index_map,
-  std::vector<sym_write_entry>& sym_entries)
+static aterm read_baf_chunks(istream& is)
 {
-  std::stack<write_todo> stack;
-  stack.emplace(t);
-
-  do
+  std::size_t nr_symbols = readInt(is);
+  std::vector<function_symbol> symbols;
+  symbols.reserve(nr_symbols);
+  for (std::size_t i = 0; i < nr_symbols; ++i)
   {
-    write_todo& current = stack.top();
-    sym_write_entry& cur_entry = sym_entries[symbol_index_map.index(get_function_symbol(current.term))];
-
-    if (current.term.type_is_int())
-    {
-      // If aterm integers are > 32 bits, then they cannot be read on a 32 bit machine.
-      writeBits(aterm_int(current.term).value(), INT_SIZE_IN_BAF, os);
-    }
-    else if (current.arg < get_function_symbol(current.term).arity())
-    {
-      write_todo item(subterm(current.term, current.arg));
-      sym_write_entry& item_entry = sym_entries[symbol_index_map.index(get_function_symbol(item.term))];
+    symbols.push_back(read_symbol(is));
+  }
 
-      const top_symbols_t& symbol_table = cur_entry.top_symbols.at(current.arg);
-      const top_symbol& ts = symbol_table.symbols.at(symbol_table.index_into_symbols.index(item_entry.id));
-      writeBits(ts.code, symbol_table.code_width, os);
-      const sym_write_entry& arg_sym = sym_entries.at(ts.index);
-      std::size_t arg_trm_idx = term_index_map.at(item.term);
-      writeBits(arg_trm_idx, arg_sym.term_width, os);
+  std::size_t nr_chunks = readInt(is);
+  std::vector<std::size_t> first_node(nr_chunks + 1, 0);
+  std::vector<std::size_t> first_byte(nr_chunks + 1, 0);
+  for (std::size_t i = 0; i < nr_chunks; ++i)
+  {
+    first_node[i+1] = first_node[i] + readInt(is);
+    first_byte[i+1] = first_byte[i] + readInt(is);
+  }
+  if (first_node[nr_chunks] == 0)
+  {
+    throw mcrl2::runtime_error("Could not read valid aterm from stream.");
+  }
 
-      ++current.arg;
+  std::vector<unsigned char> data(first_byte[nr_chunks]);
+  is.read(reinterpret_cast<char*>(data.data()), data.size());
+  if (static_cast<std::size_t>(is.gcount()) != data.size())
+  {
+    throw mcrl2::runtime_error("Could not read valid aterm from stream.");
+  }
 
-      if (arg_trm_idx >= arg_sym.cur_index)
+  std::vector<term_graph> chunks(nr_chunks);
+  parallel_for_each_index(nr_chunks, [&](std::size_t i)
+  {
+    decode_chunk(data.data() + first_byte[i], first_byte[i+1] - first_byte[i], first_node[i], first_node[i+1] - first_node[i], symbols, chunks[i]);
+  });
+  data = std::vector<unsigned char>();
+
+  std::vector<aterm> terms(first_node[nr_chunks]);
+  std::vector<aterm> arguments;
+  std::size_t n = 0;
+  for (term_graph& chunk: chunks)
+  {
+    for (std::size_t i = 0; i < chunk.size(); ++i, ++n)
+    {
+      const function_symbol& f = symbols[chunk.symbols[i]];
+      const std::size_t* args = chunk.arguments.data() + chunk.first_argument[i];
+      if (f == detail::function_adm.AS_INT)
+      {
+        terms[n] = aterm_int(args[0]);
+      }
+      else if (f == detail::function_adm.AS_EMPTY_LIST)
       {
-        stack.push(item);
+        terms[n] = aterm_list();
+      }
+      else if (f == detail::function_adm.AS_LIST)
+      {
+        if (!terms[args[1]].type_is_list())
+        {
+          throw mcrl2::runtime_error("Could not read valid aterm from stream.");
+        }
+        aterm_list result = atermpp::down_cast<aterm_list>(terms[args[1]]);
+        result.push_front(terms[args[0]]);
+        terms[n] = result;
+      }
+      else // f is the symbol of a function application
+      {
+        arguments.clear();
+        for (std::size_t j = 0; j < f.arity(); ++j)
+        {
+          arguments.push_back(terms[args[j]]);
+        }
+        terms[n] = aterm_appl(f, arguments.begin(), arguments.end());
       }
-      continue;
     }
-
-    ++cur_entry.cur_index;
-    stack.pop();
+    chunk = term_graph();
   }
-  while (!stack.empty());
-  flushBitsToWriter(os);
+  return terms.back();
 }
 
+/* The remainder of this section reads terms in the bit stream format of version
+ * BAF_VERSION_BIT_STREAM, in which a term is written as a single sequence of bits.
+ */
 
-static void write_baf(const aterm& t, ostream& os)
+class sym_read_entry
 {
-  /* Initialize bit buffer */
-  read_write_buffer = std::bitset<128>(0);
-  bits_in_buffer = 0; /* how many bits in bit_buffer are used */
-
-  indexed_set<function_symbol> symbol_index_map;
-  std::unordered_map<aterm, std::size_t> term_index_map;
-  std::vector<sym_write_entry> sym_entries;
-
-  collect_terms(t, symbol_index_map, term_index_map, sym_entries);
-  compute_num_bits(sym_entries);
-
-  /* write header */
-  writeInt(0, os);
-  writeInt(BAF_MAGIC, os);
-  writeInt(BAF_VERSION, os);
-  writeInt(sym_entries.size(), os);
-  write_all_symbols(os, sym_entries);
+  public:
+    function_symbol sym;
+    std::size_t term_width;
+    std::vector<aterm> terms;
+    std::vector<vector<std::size_t> > topsyms;
+    std::vector<std::size_t> sym_width;
 
-  /* Write the top symbol */
-  writeInt(get_fn_symbol_index(t,symbol_index_map), os);
+    sym_read_entry():
+       term_width(0)
+    {
+    }
+};
 
-  write_term(t, os, symbol_index_map, term_index_map, sym_entries);
-}
+static std::size_t  bits_in_buffer = 0; /* how many bits in bit_buffer are used */
+/**
+ * \brief Buffer that is filled starting from bit 127 when reading
+ */
+static std::bitset<128> read_buffer(0);
 
-void write_term_to_binary_stream(const aterm& t, std::ostream& os)
+/**
+ * \brief Reverse the order of bits in val.
+ * \detail In BAF version 0x0304 the bits are written in reverse order.
+ */
+static void reverse_bit_order(std::size_t& val)
 {
-  aterm_io_init(os);
-  write_baf(t, os);
+  if(std::numeric_limits<std::size_t>::digits == 64)
+  {
+    val = ((val << 32) & 0xFFFFFFFF00000000) | ((val >> 32) & 0x00000000FFFFFFFF);
+  }
+  val = ((val << 16) & 0xFFFF0000FFFF0000) | ((val >> 16) & 0x0000FFFF0000FFFF);
+  val = ((val << 8)  & 0xFF00FF00FF00FF00) | ((val >> 8)  & 0x00FF00FF00FF00FF);
+  val = ((val << 4)  & 0xF0F0F0F0F0F0F0F0) | ((val >> 4)  & 0x0F0F0F0F0F0F0F0F);
+  val = ((val << 2)  & 0xCCCCCCCCCCCCCCCC) | ((val >> 2)  & 0x3333333333333333);
+  val = ((val << 1)  & 0xAAAAAAAAAAAAAAAA) | ((val >> 1)  & 0x5555555555555555);
 }
 
 /**
-  * Read a single symbol from file.
-  */
-
-static function_symbol read_symbol(istream& is)
+ * @brief readBits Reads an n-bit integer from the input stream.
+ * @param val      Variable to store integer in.
+ * @param nr_bits  Number of bits to read from the input stream.
+ * @param is       The input stream.
+ * @return true on success, false on failure (EOF).
+ */
+static
+bool readBits(std::size_t& val, const unsigned int nr_bits, istream& is)
 {
-  std::size_t len=readString(is);
-
-  text_buffer[len] = '\0';
-
-  std::size_t arity = readInt(is);
-
-  return function_symbol(text_buffer, arity);
+  val = 0;
+  if(nr_bits == 0)
+  {
+    return true;
+  }
+  while(bits_in_buffer < nr_bits)
+  {
+    // Read bytes until the buffer is sufficiently full
+    int byte = is.get();
+    if(is.fail())
+    {
+      return false;
+    }
+    read_buffer |= std::bitset<128>(byte) << (56 + 64 - bits_in_buffer);
+    bits_in_buffer += 8;
+  }
+  val = (read_buffer >> (128 - std::numeric_limits<std::size_t>::digits)).to_ullong() &
+      (std::numeric_limits<std::size_t>::max() <<
+         (std::numeric_limits<std::size_t>::digits - std::min(nr_bits, static_cast<unsigned int>(std::numeric_limits<std::size_t>::digits))));
+  bits_in_buffer -= nr_bits;
+  read_buffer <<= nr_bits;
+  reverse_bit_order(val);
+  return true;
 }
 
 /**
@@ -760,6 +905,31 @@ static aterm read_term(sym_read_entry* sym, istream& is, std::vector<sym_read_en
   return result;
 }
 
+/**
+ * \brief Read a term in the bit stream format of version BAF_VERSION_BIT_STREAM, after the version number.
+ */
+static aterm read_baf_bit_stream(istream& is)
+{
+  // Initialize bit buffer
+  read_buffer = std::bitset<128>(0);
+  bits_in_buffer = 0; // how many bits in bit_buffer are used
+
+  std::size_t nr_unique_symbols = readInt(is);
+
+  // Allocate symbol space
+  std::vector<sym_read_entry> read_symbols(nr_unique_symbols);
+
+  read_all_symbols(is, nr_unique_symbols, read_symbols);
+
+  std::size_t val = readInt(is);
+  if (val >= nr_unique_symbols)
+  {
+    throw mcrl2::runtime_error("Could not read valid aterm from stream.");
+  }
+  aterm result=read_term(&read_symbols[val], is, read_symbols);
+  return result;
+}
+
 /**
  * Read a term from a BAF reader.
  */
@@ -767,10 +937,6 @@ static aterm read_term(sym_read_entry* sym, istream& is, std::vector<sym_read_en
 static
 aterm read_baf(istream& is)
 {
-  // Initialize bit buffer
-  read_write_buffer = std::bitset<128>(0);
-  bits_in_buffer = 0; // how many bits in bit_buffer are used
-
   // Read header
   std::size_t val = readInt(is);
   if (val == 0)
@@ -783,22 +949,16 @@ aterm read_baf(istream& is)
   }
 
   std::size_t version = readInt(is);
-  if (version != BAF_VERSION)
+  if (version == BAF_VERSION)
   {
-    throw mcrl2::runtime_error("The BAF version (" + std::to_string(version) + ") of the input file is incompatible with the version (" + std::to_string(BAF_VERSION) +
-                               ") of this tool. The input file must be regenerated. ");
+    return read_baf_chunks(is);
   }
-
-  std::size_t nr_unique_symbols = readInt(is);
-
-  // Allocate symbol space
-  std::vector<sym_read_entry> read_symbols(nr_unique_symbols);
-
-  read_all_symbols(is, nr_unique_symbols, read_symbols);
-
-  val = readInt(is);
-  aterm result=read_term(&read_symbols[val], is, read_symbols);
-  return result;
+  if (version == BAF_VERSION_BIT_STREAM)
+  {
+    return read_baf_bit_stream(is);
+  }
+  throw mcrl2::runtime_error("The BAF version (" + std::to_string(version) + ") of the input file is incompatible with the version (" + std::to_string(BAF_VERSION) +
+                             ") of this tool. The input file must be regenerated. ");
 }
 
 
@@ -12,6 +12,7 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <limits>
 #include <boost/test/minimal.hpp>
 
 #include "mcrl2/atermpp/aterm_io.h"
@@ -83,11 +84,81 @@ void test_aterm_io()
   test_aterm_io("f([a,f(x),[]],2,[g,g(34566)])"); 
 }
 
+// A term with more nodes than fit in a single chunk of the binary format.
+void test_aterm_io_large_term()
+{
+  function_symbol f("f", 2);
+  aterm_list l;
+  for (std::size_t i = 0; i < 200000; ++i)
+  {
+    l.push_front(aterm_appl(f, aterm_int(i), aterm_int(std::numeric_limits<std::size_t>::max() - i % 7)));
+  }
+
+  std::stringbuf buf;
+  std::iostream binary_stream(&buf);
+  write_term_to_binary_stream(l, binary_stream);
+  write_term_to_binary_stream(aterm_int(3), binary_stream);
+  BOOST_CHECK(read_term_from_binary_stream(binary_stream) == l);
+  BOOST_CHECK(read_term_from_binary_stream(binary_stream) == aterm_int(3));
+}
+
+// Terms in the previous version (0x0304) of the binary format can still be read.
+void test_aterm_io_legacy_format()
+{
+  const std::string legacy(
+    "\x00\x8b\xaf\x83\x04\x09\x01\x61\x00\x01\x01\x78\x00\x01\x01\x66"
+    "\x01\x01\x01\x01\x0c\x3c\x65\x6d\x70\x74\x79\x5f\x6c\x69\x73\x74"
+    "\x3e\x00\x01\x12\x3c\x6c\x69\x73\x74\x5f\x63\x6f\x6e\x73\x74\x72"
+    "\x75\x63\x74\x6f\x72\x3e\x02\x05\x05\x03\x02\x00\x07\x06\x02\x03"
+    "\x04\x0b\x3c\x61\x74\x65\x72\x6d\x5f\x69\x6e\x74\x3e\x01\x02\x00"
+    "\x01\x67\x00\x01\x01\x67\x01\x01\x01\x05\x01\x66\x03\x01\x01\x04"
+    "\x01\x05\x01\x04\x08\x4a\x92\x00\x10\x00\x00\x00\x00\x00\x00\x00"
+    "\x09\xb6\x98\x38\x40\x00\x00\x00\x00\x00\x00", 123);
+  std::istringstream in(legacy);
+  BOOST_CHECK(read_term_from_binary_stream(in) == read_term_from_string("f([a,f(x),[]],2,[g,g(34566)])"));
+}
+
+void test_aterm_move()
+{
+  aterm a = read_term_from_string("f(x)");
+  aterm b = a;
+  aterm c(std::move(b));
+  BOOST_CHECK(c == a);
+
+  // A term that has been moved from can be assigned to.
+  b = read_term_from_string("g(y)");
+  BOOST_CHECK(b == read_term_from_string("g(y)"));
+  aterm d(std::move(b));
+  b = a;
+  BOOST_CHECK(b == a);
+  aterm e(std::move(c));
+  c = std::move(d);
+  BOOST_CHECK(c == read_term_from_string("g(y)"));
+}
+
+void test_unprotected_aterm()
+{
+  const aterm a = read_term_from_string("f(x,[a,b])");
+  const aterm_appl& f = down_cast<aterm_appl>(a);
+  unprotected_aterm u(f[0]);
+  BOOST_CHECK(u == f[0]);
+  BOOST_CHECK(u != f[1]);
+  BOOST_CHECK(u.get() == read_term_from_string("x"));
+  unprotected_aterm v(f[1]);
+  BOOST_CHECK(v.get<aterm_list>().size() == 2);
+  BOOST_CHECK(std::hash<unprotected_aterm>()(u) == std::hash<aterm>()(f[0]));
+  BOOST_CHECK(unprotected_aterm().empty());
+}
+
 int test_main(int argc, char* argv[])
 {
   test_aterm();
   test_aterm_string(); 
   test_aterm_io();
+  test_aterm_io_large_term();
+  test_aterm_io_legacy_format();
+  test_aterm_move();
+  test_unprotected_aterm();
 
   return 0;
 }
@@ -0,0 +1,289 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/bes/indexed_boolean_equation_system.h
+/// \brief A compact representation of a boolean equation system, in which
+///        variables are numbered and right hand sides are flat conjunctions
+///        or disjunctions of variables.
+
+#ifndef MCRL2_BES_INDEXED_BOOLEAN_EQUATION_SYSTEM_H
+#define MCRL2_BES_INDEXED_BOOLEAN_EQUATION_SYSTEM_H
+
+#include "mcrl2/bes/boolean_equation_system.h"
+#include "mcrl2/bes/print.h"
+#include "mcrl2/utilities/exception.h"
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mcrl2
+{
+
+namespace bes
+{
+
+/// \brief A boolean equation system in which the variables are numbered 0, 1, ..., size() - 1.
+/// \details The right hand side of every equation is a conjunction or a disjunction of variables.
+/// The constant true is represented by an empty conjunction and false by an empty disjunction.
+/// The successors of all variables are stored consecutively in one array, and instead of a
+/// fixpoint symbol every variable has a rank. Equations of rank 0 are the outermost ones.
+///
+/// The equations of a boolean_equation_system keep their index in the indexed representation.
+/// Right hand sides that mix conjunctions and disjunctions are split using auxiliary variables,
+/// which get the rank of the equation in which they occur and are numbered after the original ones.
+class indexed_boolean_equation_system
+{
+  public:
+    typedef std::uint32_t index_type;
+
+  protected:
+    typedef std::unordered_map<boolean_variable, index_type, std::hash<atermpp::aterm> > variable_map;
+
+    std::vector<std::size_t> m_rank;             // the rank of every variable
+    std::vector<bool> m_is_conjunctive;          // whether the right hand side of a variable is a conjunction
+    std::vector<std::size_t> m_successor_offset; // the successors of variable i are m_successors[m_successor_offset[i], m_successor_offset[i + 1])
+    std::vector<index_type> m_successors;
+    std::vector<bool> m_rank_is_nu;              // whether the equations of a rank are greatest fixpoint equations
+    std::size_t m_original_size;                 // the number of equations of the original equation system
+    index_type m_initial_variable;
+
+    struct pending_equation
+    {
+      std::size_t rank;
+      boolean_expression formula;
+    };
+
+    static bool is_conjunction(const boolean_expression& x)
+    {
+      return is_and(x) || is_true(x);
+    }
+
+    // Adds the successors of the conjunction (or disjunction) x. Operands with a different operator
+    // are assigned to auxiliary variables that are added to pending. Returns false if x contains an
+    // operand false (true), i.e. if the conjunction (disjunction) is equal to false (true).
+    bool add_operands(const boolean_expression& x,
+                      bool conjunctive,
+                      std::size_t rank,
+                      const variable_map& index,
+                      std::vector<pending_equation>& pending)
+    {
+      if (is_boolean_variable(x))
+      {
+        auto i = index.find(atermpp::down_cast<boolean_variable>(x));
+        if (i == index.end())
+        {
+          throw mcrl2::runtime_error("The variable " + bes::pp(x) + " has no equation.");
+        }
+        m_successors.push_back(i->second);
+        return true;
+      }
+      else if (is_true(x))
+      {
+        return conjunctive;
+      }
+      else if (is_false(x))
+      {
+        return !conjunctive;
+      }
+      else if (conjunctive ? is_and(x) : is_or(x))
+      {
+        const boolean_expression& left = conjunctive ? atermpp::down_cast<and_>(x).left() : atermpp::down_cast<or_>(x).left();
+        const boolean_expression& right = conjunctive ? atermpp::down_cast<and_>(x).right() : atermpp::down_cast<or_>(x).right();
+        return add_operands(left, conjunctive, rank, index, pending) && add_operands(right, conjunctive, rank, index, pending);
+      }
+      else if (is_and(x) || is_or(x))
+      {
+        m_successors.push_back(new_index(m_original_size + pending.size()));
+        pending.push_back(pending_equation{rank, x});
+        return true;
+      }
+      throw mcrl2::runtime_error("The expression " + bes::pp(x) + " is not supported by the indexed boolean equation system; only conjunctions and disjunctions are allowed.");
+    }
+
+    // Adds the right hand side x of the next variable.
+    void add_equation(const boolean_expression& x,
+                      std::size_t rank,
+                      const variable_map& index,
+                      std::vector<pending_equation>& pending)
+    {
+      bool conjunctive = is_conjunction(x);
+      std::size_t first = m_successors.size();
+      if (!add_operands(x, conjunctive, rank, index, pending))
+      {
+        // The right hand side is equal to the constant !conjunctive.
+        m_successors.resize(first);
+        conjunctive = !conjunctive;
+      }
+      m_rank.push_back(rank);
+      m_is_conjunctive.push_back(conjunctive);
+      m_successor_offset.push_back(m_successors.size());
+    }
+
+    static index_type new_index(std::size_t i)
+    {
+      if (i >= std::numeric_limits<index_type>::max())
+      {
+        throw mcrl2::runtime_error("The boolean equation system has too many variables for the indexed representation.");
+      }
+      return static_cast<index_type>(i);
+    }
+
+  public:
+    indexed_boolean_equation_system()
+      : m_successor_offset(1, 0), m_original_size(0), m_initial_variable(0)
+    {}
+
+    explicit indexed_boolean_equation_system(const boolean_equation_system& b)
+      : m_successor_offset(1, 0), m_original_size(b.equations().size()), m_initial_variable(0)
+    {
+      const std::vector<boolean_equation>& equations = b.equations();
+
+      variable_map index;
+      index.reserve(equations.size());
+      for (std::size_t i = 0; i < equations.size(); i++)
+      {
+        index[equations[i].variable()] = new_index(i);
+      }
+
+      m_rank.reserve(equations.size());
+      m_is_conjunctive.reserve(equations.size());
+      m_successor_offset.reserve(equations.size() + 1);
+
+      // The auxiliary variables of the right hand sides are numbered in order of occurrence, and
+      // their equations are added after the original ones.
+      std::vector<pending_equation> pending;
+      std::size_t rank = 0;
+      for (std::size_t i = 0; i < equations.size(); i++)
+      {
+        if (i == 0)
+        {
+          m_rank_is_nu.push_back(equations[i].symbol().is_nu());
+        }
+        else if (equations[i].symbol() != equations[i - 1].symbol())
+        {
+          rank++;
+          m_rank_is_nu.push_back(equations[i].symbol().is_nu());
+        }
+        add_equation(equations[i].formula(), rank, index, pending);
+      }
+
+      if (is_boolean_variable(b.initial_state()))
+      {
+        auto i = index.find(atermpp::down_cast<boolean_variable>(b.initial_state()));
+        if (i == index.end())
+        {
+          throw mcrl2::runtime_error("The initial variable " + bes::pp(b.initial_state()) + " has no equation.");
+        }
+        m_initial_variable = i->second;
+      }
+      else
+      {
+        // The initial state gets an auxiliary variable, which does not occur in any right hand side.
+        if (m_rank_is_nu.empty())
+        {
+          m_rank_is_nu.push_back(true);
+        }
+        m_initial_variable = new_index(m_original_size + pending.size());
+        pending.push_back(pending_equation{0, b.initial_state()});
+      }
+
+      for (std::size_t i = 0; i < pending.size(); i++)
+      {
+        // N.B. pending may grow during this loop, hence the copy.
+        const pending_equation eq = pending[i];
+        add_equation(eq.formula, eq.rank, index, pending);
+      }
+    }
+
+    /// \brief Returns the number of variables, including the auxiliary ones.
+    std::size_t size() const
+    {
+      return m_rank.size();
+    }
+
+    /// \brief Returns the number of equations of the original boolean equation system.
+    std::size_t original_size() const
+    {
+      return m_original_size;
+    }
+
+    /// \brief Returns the number of ranks.
+    std::size_t rank_count() const
+    {
+      return m_rank_is_nu.size();
+    }
+
+    /// \brief Returns the rank of variable i.
+    std::size_t rank(std::size_t i) const
+    {
+      return m_rank[i];
+    }
+
+    /// \brief Returns true if the equations of rank r are greatest fixpoint equations.
+    bool is_nu_rank(std::size_t r) const
+    {
+      return m_rank_is_nu[r];
+    }
+
+    /// \brief Returns true if the right hand side of variable i is a conjunction.
+    bool is_conjunctive(std::size_t i) const
+    {
+      return m_is_conjunctive[i];
+    }
+
+    /// \brief Returns the range of successors of variable i.
+    std::pair<const index_type*, const index_type*> successors(std::size_t i) const
+    {
+      const index_type* first = m_successors.data();
+      return std::make_pair(first + m_successor_offset[i], first + m_successor_offset[i + 1]);
+    }
+
+    /// \brief Returns the total number of successors of all variables.
+    std::size_t successor_count() const
+    {
+      return m_successors.size();
+    }
+
+    /// \brief Returns the variable that corresponds to the initial state.
+    index_type initial_variable() const
+    {
+      return m_initial_variable;
+    }
+
+    /// \brief Computes the predecessors of all variables, in the same format as the successors.
+    /// \param offset Is set such that the predecessors of variable i are predecessors[offset[i], offset[i + 1]).
+    void compute_predecessors(std::vector<std::size_t>& offset, std::vector<index_type>& predecessors) const
+    {
+      offset.assign(size() + 1, 0);
+      for (index_type j: m_successors)
+      {
+        offset[j + 1]++;
+      }
+      for (std::size_t i = 0; i < size(); i++)
+      {
+        offset[i + 1] += offset[i];
+      }
+      predecessors.resize(m_successors.size());
+      std::vector<std::size_t> next(offset.begin(), offset.end() - 1);
+      for (std::size_t i = 0; i < size(); i++)
+      {
+        for (std::size_t k = m_successor_offset[i]; k < m_successor_offset[i + 1]; k++)
+        {
+          predecessors[next[m_successors[k]]++] = static_cast<index_type>(i);
+        }
+      }
+    }
+};
+
+} // namespace bes
+
+} // namespace mcrl2
+
+#endif // MCRL2_BES_INDEXED_BOOLEAN_EQUATION_SYSTEM_H
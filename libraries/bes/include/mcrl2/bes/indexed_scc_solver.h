@@ -0,0 +1,384 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/bes/indexed_scc_solver.h
+/// \brief Solves an indexed boolean equation system per strongly connected component
+///        of its dependency graph.
+
+#ifndef MCRL2_BES_INDEXED_SCC_SOLVER_H
+#define MCRL2_BES_INDEXED_SCC_SOLVER_H
+
+#include "mcrl2/bes/indexed_boolean_equation_system.h"
+#include "mcrl2/utilities/logger.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mcrl2
+{
+
+namespace bes
+{
+
+/// \brief Solves an indexed boolean equation system by decomposing its dependency graph into
+///        strongly connected components.
+/// \details A component only depends on itself and on components below it. The components are
+/// solved bottom up, such that the solutions of the variables outside a component are known when
+/// it is solved. Within a component the local fixpoint algorithm is applied to the ranks that occur
+/// in it. Components of which all successor components are solved are independent, and are solved
+/// concurrently by a number of worker threads.
+class indexed_scc_solver
+{
+  protected:
+    typedef indexed_boolean_equation_system::index_type index_type;
+
+    const indexed_boolean_equation_system& m_bes;
+    std::size_t m_thread_count;
+
+    // The variables of component c are m_component_variables[m_component_offset[c], m_component_offset[c + 1]).
+    // Components are numbered in the order in which they are found, i.e. successor components first.
+    std::vector<index_type> m_component;
+    std::vector<std::size_t> m_component_offset;
+    std::vector<index_type> m_component_variables;
+
+    std::vector<std::size_t> m_predecessor_offset;
+    std::vector<index_type> m_predecessors;
+
+    // N.B. A vector of char is used instead of a vector of bool, since different threads write the values
+    // of different components.
+    std::vector<char> m_value;
+    std::vector<char> m_in_todo;
+
+    // Computes the strongly connected components using an iterative version of Tarjan's algorithm.
+    void compute_components()
+    {
+      const std::size_t n = m_bes.size();
+      const index_type undefined = static_cast<index_type>(-1);
+      std::vector<index_type> low(n);
+      std::vector<index_type> number(n, undefined);
+      std::vector<char> on_stack(n, 0);
+      std::vector<index_type> stack;
+      std::vector<std::pair<index_type, const index_type*> > call_stack;
+      index_type counter = 0;
+
+      m_component.assign(n, 0);
+      m_component_offset.assign(1, 0);
+      m_component_variables.clear();
+      m_component_variables.reserve(n);
+
+      for (std::size_t root = 0; root < n; root++)
+      {
+        if (number[root] != undefined)
+        {
+          continue;
+        }
+        number[root] = low[root] = counter++;
+        stack.push_back(static_cast<index_type>(root));
+        on_stack[root] = 1;
+        call_stack.emplace_back(static_cast<index_type>(root), m_bes.successors(root).first);
+        while (!call_stack.empty())
+        {
+          index_type i = call_stack.back().first;
+          const index_type*& next = call_stack.back().second;
+          if (next != m_bes.successors(i).second)
+          {
+            index_type j = *next++;
+            if (number[j] == undefined)
+            {
+              number[j] = low[j] = counter++;
+              stack.push_back(j);
+              on_stack[j] = 1;
+              call_stack.emplace_back(j, m_bes.successors(j).first);
+            }
+            else if (on_stack[j])
+            {
+              low[i] = std::min(low[i], number[j]);
+            }
+            continue;
+          }
+
+          call_stack.pop_back();
+          if (!call_stack.empty())
+          {
+            index_type parent = call_stack.back().first;
+            low[parent] = std::min(low[parent], low[i]);
+          }
+          if (low[i] == number[i])
+          {
+            index_type c = static_cast<index_type>(m_component_offset.size() - 1);
+            index_type j;
+            do
+            {
+              j = stack.back();
+              stack.pop_back();
+              on_stack[j] = 0;
+              m_component[j] = c;
+              m_component_variables.push_back(j);
+            }
+            while (j != i);
+            m_component_offset.push_back(m_component_variables.size());
+          }
+        }
+      }
+    }
+
+    std::size_t component_count() const
+    {
+      return m_component_offset.size() - 1;
+    }
+
+    bool evaluate(std::size_t i) const
+    {
+      auto succ = m_bes.successors(i);
+      if (m_bes.is_conjunctive(i))
+      {
+        return std::all_of(succ.first, succ.second, [&](index_type j) { return m_value[j] != 0; });
+      }
+      return std::any_of(succ.first, succ.second, [&](index_type j) { return m_value[j] != 0; });
+    }
+
+    // Computes the fixpoint of the variables [first, last) of one rank of component c, with all other
+    // values fixed. Returns true if a value has changed.
+    bool local_fixpoint(const index_type* first, const index_type* last, std::size_t rank, index_type c, std::vector<index_type>& todo)
+    {
+      bool changed = false;
+      for (const index_type* k = first; k != last; ++k)
+      {
+        todo.push_back(*k);
+        m_in_todo[*k] = 1;
+      }
+      while (!todo.empty())
+      {
+        index_type i = todo.back();
+        todo.pop_back();
+        m_in_todo[i] = 0;
+        char value = evaluate(i) ? 1 : 0;
+        if (value != m_value[i])
+        {
+          m_value[i] = value;
+          changed = true;
+          for (std::size_t k = m_predecessor_offset[i]; k < m_predecessor_offset[i + 1]; k++)
+          {
+            index_type j = m_predecessors[k];
+            if (m_component[j] == c && m_bes.rank(j) == rank && !m_in_todo[j])
+            {
+              m_in_todo[j] = 1;
+              todo.push_back(j);
+            }
+          }
+        }
+      }
+      return changed;
+    }
+
+    // Solves the ranks [level, ...) of a component. The variables of the i-th rank of the component are
+    // variables[offset[i], offset[i + 1]).
+    void solve_ranks(std::size_t level, const std::vector<index_type>& variables, const std::vector<std::size_t>& offset, index_type c, std::vector<index_type>& todo)
+    {
+      if (level + 1 == offset.size())
+      {
+        return;
+      }
+      const index_type* first = variables.data() + offset[level];
+      const index_type* last = variables.data() + offset[level + 1];
+      std::size_t rank = m_bes.rank(*first);
+      for (const index_type* k = first; k != last; ++k)
+      {
+        m_value[*k] = m_bes.is_nu_rank(rank) ? 1 : 0;
+      }
+      solve_ranks(level + 1, variables, offset, c, todo);
+      while (local_fixpoint(first, last, rank, c, todo) && level + 2 < offset.size())
+      {
+        solve_ranks(level + 1, variables, offset, c, todo);
+      }
+    }
+
+    void solve_component(index_type c, std::vector<index_type>& todo)
+    {
+      const index_type* first = m_component_variables.data() + m_component_offset[c];
+      const index_type* last = m_component_variables.data() + m_component_offset[c + 1];
+
+      // A single variable that does not depend on itself can be evaluated directly.
+      if (last - first == 1)
+      {
+        auto succ = m_bes.successors(*first);
+        if (std::find(succ.first, succ.second, *first) == succ.second)
+        {
+          m_value[*first] = evaluate(*first) ? 1 : 0;
+          return;
+        }
+      }
+
+      std::vector<index_type> variables(first, last);
+      std::stable_sort(variables.begin(), variables.end(), [&](index_type i, index_type j) { return m_bes.rank(i) < m_bes.rank(j); });
+      std::vector<std::size_t> offset(1, 0);
+      for (std::size_t k = 1; k < variables.size(); k++)
+      {
+        if (m_bes.rank(variables[k]) != m_bes.rank(variables[k - 1]))
+        {
+          offset.push_back(k);
+        }
+      }
+      offset.push_back(variables.size());
+      solve_ranks(0, variables, offset, c, todo);
+    }
+
+    void solve_sequential()
+    {
+      std::vector<index_type> todo;
+      for (std::size_t c = 0; c < component_count(); c++)
+      {
+        solve_component(static_cast<index_type>(c), todo);
+      }
+    }
+
+    void solve_parallel()
+    {
+      // The number of successor components of every component that are not yet solved, and
+      // the predecessor components of every component.
+      std::vector<std::size_t> waiting(component_count(), 0);
+      std::vector<std::size_t> dependent_offset(component_count() + 1, 0);
+      std::vector<index_type> dependents;
+      {
+        std::vector<std::pair<index_type, index_type> > edges;
+        for (std::size_t i = 0; i < m_bes.size(); i++)
+        {
+          auto succ = m_bes.successors(i);
+          for (const index_type* j = succ.first; j != succ.second; ++j)
+          {
+            if (m_component[i] != m_component[*j])
+            {
+              edges.emplace_back(m_component[*j], m_component[i]);
+            }
+          }
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        for (const auto& e: edges)
+        {
+          waiting[e.second]++;
+          dependent_offset[e.first + 1]++;
+        }
+        for (std::size_t c = 0; c < component_count(); c++)
+        {
+          dependent_offset[c + 1] += dependent_offset[c];
+        }
+        dependents.resize(edges.size());
+        std::vector<std::size_t> next(dependent_offset.begin(), dependent_offset.end() - 1);
+        for (const auto& e: edges)
+        {
+          dependents[next[e.first]++] = e.second;
+        }
+      }
+
+      std::mutex mutex;
+      std::condition_variable ready_condition;
+      std::deque<index_type> ready;
+      std::size_t unsolved = component_count();
+      for (std::size_t c = 0; c < component_count(); c++)
+      {
+        if (waiting[c] == 0)
+        {
+          ready.push_back(static_cast<index_type>(c));
+        }
+      }
+
+      auto worker = [&]()
+      {
+        std::vector<index_type> todo;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;)
+        {
+          ready_condition.wait(lock, [&]() { return !ready.empty() || unsolved == 0; });
+          if (ready.empty())
+          {
+            return;
+          }
+          index_type c = ready.front();
+          ready.pop_front();
+          lock.unlock();
+          solve_component(c, todo);
+          lock.lock();
+          unsolved--;
+          for (std::size_t k = dependent_offset[c]; k < dependent_offset[c + 1]; k++)
+          {
+            if (--waiting[dependents[k]] == 0)
+            {
+              ready.push_back(dependents[k]);
+            }
+          }
+          ready_condition.notify_all();
+        }
+      };
+
+      std::vector<std::thread> threads;
+      for (std::size_t t = 1; t < m_thread_count; t++)
+      {
+        threads.emplace_back(worker);
+      }
+      worker();
+      for (std::thread& t: threads)
+      {
+        t.join();
+      }
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param thread_count The number of threads that solve components. If it is 0, the number of hardware threads is used.
+    indexed_scc_solver(const indexed_boolean_equation_system& b, std::size_t thread_count = 0)
+      : m_bes(b),
+        m_thread_count(thread_count == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : thread_count),
+        m_value(b.size(), 0),
+        m_in_todo(b.size(), 0)
+    {
+      compute_components();
+      b.compute_predecessors(m_predecessor_offset, m_predecessors);
+    }
+
+    /// \brief Solves the equation system.
+    /// \param full_solution If it is not null, it is set to the solution of the variables of the original equation system.
+    /// \return The solution of the initial variable.
+    bool run(std::vector<bool>* full_solution = nullptr)
+    {
+      mCRL2log(log::verbose) << "Solving an indexed BES with " << m_bes.size() << " equations in " << component_count() <<
+              " strongly connected components using " << m_thread_count << " thread(s)." << std::endl;
+      if (m_thread_count <= 1 || component_count() <= 1)
+      {
+        solve_sequential();
+      }
+      else
+      {
+        solve_parallel();
+      }
+      if (full_solution)
+      {
+        full_solution->assign(m_value.begin(), m_value.begin() + m_bes.original_size());
+      }
+      return m_value[m_bes.initial_variable()] != 0;
+    }
+};
+
+/// \brief Solves an indexed boolean equation system per strongly connected component of its dependency graph.
+/// \param full_solution If it is not null, it is set to the solution of the variables of the original equation system.
+/// \param thread_count The number of threads. If it is 0, the number of hardware threads is used.
+inline
+bool indexed_scc_solve(const indexed_boolean_equation_system& b, std::vector<bool>* full_solution = nullptr, std::size_t thread_count = 0)
+{
+  indexed_scc_solver solver(b, thread_count);
+  return solver.run(full_solution);
+}
+
+} // namespace bes
+
+} // namespace mcrl2
+
+#endif // MCRL2_BES_INDEXED_SCC_SOLVER_H
@@ -0,0 +1,354 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/bes/indexed_solvers.h
+/// \brief Solvers that work directly on an indexed boolean equation system.
+
+#ifndef MCRL2_BES_INDEXED_SOLVERS_H
+#define MCRL2_BES_INDEXED_SOLVERS_H
+
+#include "mcrl2/bes/indexed_boolean_equation_system.h"
+#include "mcrl2/utilities/logger.h"
+#include <algorithm>
+#include <vector>
+
+namespace mcrl2
+{
+
+namespace bes
+{
+
+/// \brief Solves an indexed boolean equation system by computing local fixpoints for the
+///        equations of one rank at a time, starting with the outermost rank.
+/// \details For every approximation of the equations of rank r, the equations of the ranks
+/// above r are solved first. Then the fixpoint of the equations of rank r is computed with the
+/// values of the other ranks fixed, using a work list of variables of which a successor has
+/// changed. This is repeated until the approximation of rank r is stable. Without alternation
+/// of fixpoints every rank is solved exactly once.
+class indexed_local_fixpoints_algorithm
+{
+  protected:
+    typedef indexed_boolean_equation_system::index_type index_type;
+
+    const indexed_boolean_equation_system& m_bes;
+    std::vector<bool> m_value;
+    std::vector<std::size_t> m_rank_offset;    // the variables of rank r are m_rank_variables[m_rank_offset[r], m_rank_offset[r + 1])
+    std::vector<index_type> m_rank_variables;
+    std::vector<std::size_t> m_predecessor_offset;
+    std::vector<index_type> m_predecessors;
+    std::vector<bool> m_in_todo;
+    std::vector<index_type> m_todo;
+
+    bool evaluate(std::size_t i) const
+    {
+      auto succ = m_bes.successors(i);
+      if (m_bes.is_conjunctive(i))
+      {
+        return std::all_of(succ.first, succ.second, [&](index_type j) { return m_value[j]; });
+      }
+      return std::any_of(succ.first, succ.second, [&](index_type j) { return m_value[j]; });
+    }
+
+    void initialize(std::size_t rank)
+    {
+      for (std::size_t k = m_rank_offset[rank]; k < m_rank_offset[rank + 1]; k++)
+      {
+        m_value[m_rank_variables[k]] = m_bes.is_nu_rank(rank);
+      }
+    }
+
+    // Computes the fixpoint of the equations of the given rank, with all other values fixed.
+    // Returns true if a value has changed.
+    bool local_fixpoint(std::size_t rank)
+    {
+      bool changed = false;
+      for (std::size_t k = m_rank_offset[rank]; k < m_rank_offset[rank + 1]; k++)
+      {
+        m_todo.push_back(m_rank_variables[k]);
+        m_in_todo[m_rank_variables[k]] = true;
+      }
+      while (!m_todo.empty())
+      {
+        index_type i = m_todo.back();
+        m_todo.pop_back();
+        m_in_todo[i] = false;
+        bool value = evaluate(i);
+        if (value != m_value[i])
+        {
+          m_value[i] = value;
+          changed = true;
+          for (std::size_t k = m_predecessor_offset[i]; k < m_predecessor_offset[i + 1]; k++)
+          {
+            index_type j = m_predecessors[k];
+            if (m_bes.rank(j) == rank && !m_in_todo[j])
+            {
+              m_in_todo[j] = true;
+              m_todo.push_back(j);
+            }
+          }
+        }
+      }
+      return changed;
+    }
+
+    // Solves the equations of the ranks rank, rank + 1, ..., with the values of the lower ranks fixed.
+    void solve(std::size_t rank)
+    {
+      if (rank == m_bes.rank_count())
+      {
+        return;
+      }
+      initialize(rank);
+      solve(rank + 1);
+      while (local_fixpoint(rank) && rank + 1 < m_bes.rank_count())
+      {
+        solve(rank + 1);
+      }
+    }
+
+  public:
+    indexed_local_fixpoints_algorithm(const indexed_boolean_equation_system& b)
+      : m_bes(b), m_value(b.size()), m_rank_offset(b.rank_count() + 1, 0), m_rank_variables(b.size()), m_in_todo(b.size(), false)
+    {
+      for (std::size_t i = 0; i < b.size(); i++)
+      {
+        m_rank_offset[b.rank(i) + 1]++;
+      }
+      for (std::size_t r = 0; r < b.rank_count(); r++)
+      {
+        m_rank_offset[r + 1] += m_rank_offset[r];
+      }
+      std::vector<std::size_t> next(m_rank_offset.begin(), m_rank_offset.end() - 1);
+      for (std::size_t i = 0; i < b.size(); i++)
+      {
+        m_rank_variables[next[b.rank(i)]++] = static_cast<index_type>(i);
+      }
+      b.compute_predecessors(m_predecessor_offset, m_predecessors);
+    }
+
+    /// \brief Solves the equation system.
+    /// \param full_solution If it is not null, it is set to the solution of the variables of the original equation system.
+    /// \return The solution of the initial variable.
+    bool run(std::vector<bool>* full_solution = nullptr)
+    {
+      mCRL2log(log::verbose) << "Solving an indexed BES with " << m_bes.size() <<
+              " equations using the local fixed point algorithm." << std::endl;
+      solve(0);
+      if (full_solution)
+      {
+        full_solution->assign(m_value.begin(), m_value.begin() + m_bes.original_size());
+      }
+      return m_value[m_bes.initial_variable()];
+    }
+};
+
+/// \brief Solves an indexed boolean equation system using the small progress measures algorithm
+///        for the corresponding parity game.
+/// \details Disjunctive variables belong to the player that wants to make the solution true,
+/// and greatest fixpoints have an even priority. A variable is true if its progress measure
+/// is not top. Variables are only lifted again if the measure of a successor has increased.
+class indexed_small_progress_measures_algorithm
+{
+  protected:
+    typedef indexed_boolean_equation_system::index_type index_type;
+
+    const indexed_boolean_equation_system& m_bes;
+    std::size_t m_priority_offset;   // the priority of variable i is m_bes.rank(i) + m_priority_offset
+    std::size_t m_d;                 // the number of priorities
+    std::vector<int> m_beta;         // the maximal value of the measures for each priority
+    std::vector<int> m_measure;      // the measure of variable i is m_measure[i * m_d, (i + 1) * m_d); top is represented by -1 at position 0
+
+    std::size_t priority(std::size_t i) const
+    {
+      return m_bes.rank(i) + m_priority_offset;
+    }
+
+    int* measure(std::size_t i)
+    {
+      return &m_measure[i * m_d];
+    }
+
+    bool is_top(std::size_t i) const
+    {
+      return m_measure[i * m_d] == -1;
+    }
+
+    // Returns -1, 0 or 1 if the measure of i is smaller than, equal to or greater than the measure
+    // of j, taking only the positions [0, ..., m] into account.
+    int compare(std::size_t i, std::size_t j, std::size_t m) const
+    {
+      if (is_top(i) || is_top(j))
+      {
+        return is_top(i) == is_top(j) ? 0 : (is_top(i) ? 1 : -1);
+      }
+      const int* x = &m_measure[i * m_d];
+      const int* y = &m_measure[j * m_d];
+      for (std::size_t k = 0; k <= m; k++)
+      {
+        if (x[k] != y[k])
+        {
+          return x[k] < y[k] ? -1 : 1;
+        }
+      }
+      return 0;
+    }
+
+    // Recomputes the measure of variable i. Returns true if it has changed.
+    bool lift(std::size_t i, std::vector<int>& alpha)
+    {
+      auto succ = m_bes.successors(i);
+      if (succ.first == succ.second || is_top(i))
+      {
+        return false;
+      }
+      std::size_t m = priority(i);
+      const index_type* best = succ.first;
+      for (const index_type* j = succ.first + 1; j != succ.second; ++j)
+      {
+        int c = compare(*j, *best, m);
+        if (m_bes.is_conjunctive(i) ? c > 0 : c < 0)
+        {
+          best = j;
+        }
+      }
+
+      std::fill(alpha.begin(), alpha.end(), 0);
+      if (is_top(*best))
+      {
+        alpha[0] = -1;
+      }
+      else
+      {
+        std::copy(measure(*best), measure(*best) + m + 1, alpha.begin());
+        if (m % 2 != 0)
+        {
+          // Increment position m, with carry to the lower positions.
+          std::size_t k = m + 1;
+          for (;;)
+          {
+            if (k == 0)
+            {
+              alpha[0] = -1;
+              break;
+            }
+            k--;
+            if (alpha[k] < m_beta[k])
+            {
+              alpha[k]++;
+              break;
+            }
+            alpha[k] = 0;
+          }
+        }
+      }
+
+      if (std::equal(alpha.begin(), alpha.end(), measure(i)))
+      {
+        return false;
+      }
+      std::copy(alpha.begin(), alpha.end(), measure(i));
+      return true;
+    }
+
+  public:
+    indexed_small_progress_measures_algorithm(const indexed_boolean_equation_system& b)
+      : m_bes(b),
+        m_priority_offset(b.rank_count() > 0 && !b.is_nu_rank(0) ? 1 : 0),
+        m_d(b.rank_count() + m_priority_offset)
+    {
+      m_beta.assign(m_d, 0);
+      for (std::size_t i = 0; i < b.size(); i++)
+      {
+        if (priority(i) % 2 != 0)
+        {
+          m_beta[priority(i)]++;
+        }
+      }
+      m_measure.assign(b.size() * m_d, 0);
+    }
+
+    /// \brief Solves the equation system.
+    /// \param full_solution If it is not null, it is set to the solution of the variables of the original equation system.
+    /// \return The solution of the initial variable.
+    bool run(std::vector<bool>* full_solution = nullptr)
+    {
+      mCRL2log(log::verbose) << "Solving an indexed BES with " << m_bes.size() <<
+              " equations using small progress measures." << std::endl;
+
+      std::vector<std::size_t> predecessor_offset;
+      std::vector<index_type> predecessors;
+      m_bes.compute_predecessors(predecessor_offset, predecessors);
+
+      // The empty disjunction false has measure top. Initially all variables need to be lifted.
+      std::vector<index_type> todo;
+      std::vector<bool> in_todo(m_bes.size(), true);
+      for (std::size_t i = 0; i < m_bes.size(); i++)
+      {
+        auto succ = m_bes.successors(i);
+        if (succ.first == succ.second && !m_bes.is_conjunctive(i))
+        {
+          measure(i)[0] = -1;
+        }
+        todo.push_back(static_cast<index_type>(i));
+      }
+
+      std::vector<int> alpha(m_d);
+      while (!todo.empty())
+      {
+        index_type i = todo.back();
+        todo.pop_back();
+        in_todo[i] = false;
+        if (lift(i, alpha))
+        {
+          for (std::size_t k = predecessor_offset[i]; k < predecessor_offset[i + 1]; k++)
+          {
+            index_type j = predecessors[k];
+            if (!in_todo[j])
+            {
+              in_todo[j] = true;
+              todo.push_back(j);
+            }
+          }
+        }
+      }
+
+      if (full_solution)
+      {
+        full_solution->resize(m_bes.original_size());
+        for (std::size_t i = 0; i < m_bes.original_size(); i++)
+        {
+          (*full_solution)[i] = !is_top(i);
+        }
+      }
+      return !is_top(m_bes.initial_variable());
+    }
+};
+
+/// \brief Solves an indexed boolean equation system using local fixpoints.
+/// \param full_solution If it is not null, it is set to the solution of the variables of the original equation system.
+inline
+bool indexed_local_fixpoints(const indexed_boolean_equation_system& b, std::vector<bool>* full_solution = nullptr)
+{
+  indexed_local_fixpoints_algorithm algorithm(b);
+  return algorithm.run(full_solution);
+}
+
+/// \brief Solves an indexed boolean equation system using small progress measures.
+/// \param full_solution If it is not null, it is set to the solution of the variables of the original equation system.
+inline
+bool indexed_small_progress_measures(const indexed_boolean_equation_system& b, std::vector<bool>* full_solution = nullptr)
+{
+  indexed_small_progress_measures_algorithm algorithm(b);
+  return algorithm.run(full_solution);
+}
+
+} // namespace bes
+
+} // namespace mcrl2
+
+#endif // MCRL2_BES_INDEXED_SOLVERS_H
@@ -10,10 +10,14 @@
 /// \brief Test for BES solvers.
 
 #include "mcrl2/bes/gauss_elimination.h"
+#include "mcrl2/bes/indexed_scc_solver.h"
+#include "mcrl2/bes/indexed_solvers.h"
+#include "mcrl2/bes/local_fixpoints.h"
 #include "mcrl2/bes/parse.h"
 #include "mcrl2/bes/print.h"
 #include "mcrl2/bes/small_progress_measures.h"
 #include <boost/test/included/unit_test_framework.hpp>
+#include <random>
 #include <sstream>
 #include <string>
 
@@ -29,6 +33,11 @@ void run_all_algorithms(std::string const& b, bool expected_outcome)
 
   std::clog << "solving the following input bes: \n" << bes::pp(b1) << std::endl;
 
+  indexed_boolean_equation_system b2(b1);
+  BOOST_CHECK_EQUAL(indexed_local_fixpoints(b2), expected_outcome);
+  BOOST_CHECK_EQUAL(indexed_small_progress_measures(b2), expected_outcome);
+  BOOST_CHECK_EQUAL(indexed_scc_solve(b2, nullptr, 1), expected_outcome);
+  BOOST_CHECK_EQUAL(indexed_scc_solve(b2, nullptr, 4), expected_outcome);
   BOOST_CHECK_EQUAL(small_progress_measures(b1), expected_outcome);
   BOOST_CHECK_EQUAL(gauss_elimination(b1), expected_outcome);
 }
@@ -65,6 +74,85 @@ BOOST_AUTO_TEST_CASE(test_simple)
   run_all_algorithms(b, false);
 }
 
+BOOST_AUTO_TEST_CASE(test_constants)
+{
+  std::string b(
+    "nu X1 = (X2 || false) && (X3 || X1); \n"
+    "mu X2 = X2 || true;                  \n"
+    "nu X3 = false && X1;                 \n"
+    "                                     \n"
+    "init X1;                             \n"
+  );
+  run_all_algorithms(b, true);
+}
+
+// Generates a random BES with n equations and the given number of alternating blocks.
+std::string random_bes(std::mt19937& generator, std::size_t n, std::size_t blocks)
+{
+  std::uniform_int_distribution<std::size_t> variable(1, n);
+  std::uniform_int_distribution<std::size_t> size(0, 3);
+  std::uniform_int_distribution<std::size_t> coin(0, 1);
+  std::uniform_int_distribution<std::size_t> block(0, blocks - 1);
+  std::vector<std::size_t> block_of(n + 1);
+  for (std::size_t i = 1; i <= n; i++)
+  {
+    block_of[i] = block(generator);
+  }
+  std::sort(block_of.begin() + 1, block_of.end());
+
+  std::ostringstream out;
+  for (std::size_t i = 1; i <= n; i++)
+  {
+    out << (block_of[i] % 2 == 0 ? "nu" : "mu") << " X" << i << " = ";
+    std::size_t k = size(generator);
+    if (k == 0)
+    {
+      out << (coin(generator) ? "true" : "false");
+    }
+    for (std::size_t j = 0; j < k; j++)
+    {
+      if (j > 0)
+      {
+        out << (coin(generator) ? " && " : " || ");
+      }
+      out << "X" << variable(generator);
+    }
+    out << ";\n";
+  }
+  out << "init X1;\n";
+  return out.str();
+}
+
+BOOST_AUTO_TEST_CASE(test_indexed_random)
+{
+  std::mt19937 generator(12345);
+  for (std::size_t i = 0; i < 200; i++)
+  {
+    boolean_equation_system b;
+    std::stringstream from;
+    from << "pbes\n" << random_bes(generator, 2 + i % 20, 1 + i % 4) << std::endl;
+    from >> b;
+
+    std::vector<bool> expected;
+    bool expected_outcome = local_fixpoints(b, &expected);
+
+    indexed_boolean_equation_system b1(b);
+    std::vector<bool> solution1;
+    std::vector<bool> solution2;
+    std::vector<bool> solution3;
+    std::vector<bool> solution4;
+    BOOST_CHECK_EQUAL(indexed_local_fixpoints(b1, &solution1), expected_outcome);
+    BOOST_CHECK_EQUAL(indexed_small_progress_measures(b1, &solution2), expected_outcome);
+    BOOST_CHECK(solution1 == expected);
+    BOOST_CHECK_EQUAL(indexed_scc_solve(b1, &solution3, 1), expected_outcome);
+    BOOST_CHECK_EQUAL(indexed_scc_solve(b1, &solution4, 4), expected_outcome);
+    BOOST_CHECK(solution2 == expected);
+    BOOST_CHECK(solution3 == expected);
+    BOOST_CHECK(solution4 == expected);
+    BOOST_CHECK_EQUAL(gauss_elimination(b), expected_outcome);
+  }
+}
+
 boost::unit_test::test_suite* init_unit_test_suite(int argc, char* argv[])
 {
   return nullptr;
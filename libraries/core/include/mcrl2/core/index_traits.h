@@ -14,6 +14,7 @@
 #define MCRL2_CORE_INDEX_TRAITS_H
 
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <stack>
 #include <unordered_map>
@@ -47,6 +48,15 @@ std::size_t& variable_map_max_index()
   return s;
 }
 
+/// \brief The mutex that protects the index map of Variable, such that variables can be
+/// created and destroyed by several threads at the same time.
+template <typename Variable, typename KeyType>
+std::mutex& variable_map_mutex()
+{
+  static std::mutex m;
+  return m;
+}
+
 /// \brief For several variable types in mCRL2 an implicit mapping of these variables
 /// to integers is available. This is done for efficiency reasons. Examples are:
 ///
@@ -56,6 +66,8 @@ std::size_t& variable_map_max_index()
 /// prevent pollution of the public interface of the classes that represent these variables.
 ///
 /// N is the position of the index in the aterm_appl.
+///
+/// The functions that access the index map are thread safe.
 template <typename Variable, typename KeyType, const int N>
 struct index_traits
 {
@@ -71,6 +83,7 @@ struct index_traits
   static inline
   std::size_t max_index()
   {
+    std::lock_guard<std::mutex> lock(variable_map_mutex<Variable, KeyType>());
     return variable_map_max_index<Variable, KeyType>();
   }
 
@@ -79,6 +92,7 @@ struct index_traits
   static inline
   std::size_t insert(const KeyType& x)
   {
+    std::lock_guard<std::mutex> lock(variable_map_mutex<Variable, KeyType>());
     auto& m = variable_index_map<Variable, KeyType>();
     auto i = m.find(x);
     if (i == m.end())
@@ -106,6 +120,7 @@ struct index_traits
   static inline
   void erase(const KeyType& x)
   {
+    std::lock_guard<std::mutex> lock(variable_map_mutex<Variable, KeyType>());
     auto& m = variable_index_map<Variable, KeyType>();
     auto& s = variable_map_free_numbers<Variable, KeyType>();
     auto i = m.find(x);
@@ -119,6 +134,7 @@ struct index_traits
   static inline
   std::size_t size()
   {
+    std::lock_guard<std::mutex> lock(variable_map_mutex<Variable, KeyType>());
     auto& m = variable_index_map<Variable, KeyType>();
     return m.size();
   }
@@ -0,0 +1,109 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file enumerator.cpp
+/// \brief Benchmark for the throughput of the enumerator.
+
+#include <deque>
+#include "mcrl2/data/enumerator.h"
+#include "mcrl2/data/enumerator_queue.h"
+#include "mcrl2/data/nat.h"
+#include "mcrl2/data/parse.h"
+#include "mcrl2/data/rewriter.h"
+#include "mcrl2/data/substitutions/mutable_indexed_substitution.h"
+#include "mcrl2/utilities/benchmark.h"
+
+using namespace mcrl2;
+
+typedef data::enumerator_list_element_with_substitution<> enumerator_element;
+
+// Returns the number of solutions of the condition with the given variables, using the todo list P.
+template <typename Queue>
+std::size_t enumerate(const data::data_specification& dataspec,
+                      const data::rewriter& R,
+                      data::enumerator_identifier_generator& id_generator,
+                      Queue& P,
+                      const data::variable_list& variables,
+                      const data::data_expression& condition)
+{
+  typedef data::enumerator_algorithm_with_iterator<data::rewriter, enumerator_element, data::is_not_false, data::rewriter, data::mutable_indexed_substitution<>, Queue> enumerator_type;
+
+  id_generator.clear();
+  enumerator_type enumerator(R, dataspec, R, id_generator);
+  data::mutable_indexed_substitution<> sigma;
+  P.clear();
+  P.push_back(enumerator_element(variables, condition));
+
+  std::size_t result = 0;
+  for (auto i = enumerator.begin(sigma, P); i != enumerator.end(); ++i)
+  {
+    result++;
+  }
+  return result;
+}
+
+// Returns the number of solutions of the condition with the given variables.
+std::size_t enumerate(const data::data_specification& dataspec, const std::string& variable_text, const std::string& condition_text)
+{
+  data::variable_vector v;
+  data::parse_variables(variable_text, std::back_inserter(v), dataspec);
+  data::data_expression condition = data::parse_data_expression(condition_text, v, dataspec);
+  data::rewriter R(dataspec);
+  data::enumerator_identifier_generator id_generator;
+  std::deque<enumerator_element> P;
+  return enumerate(dataspec, R, id_generator, P, data::variable_list(v.begin(), v.end()), condition);
+}
+
+// Enumerates the same small condition many times, as is done for the summands of an LPS
+// in every state, and returns the total number of solutions.
+template <typename Queue>
+std::size_t enumerate_repeatedly(const data::data_specification& dataspec, std::size_t count)
+{
+  data::variable_vector v;
+  data::parse_variables("b: Bool; d: D;", std::back_inserter(v), dataspec);
+  data::data_expression condition = data::parse_data_expression("b || d != d1", v, dataspec);
+  data::variable_list variables(v.begin(), v.end());
+  data::rewriter R(dataspec);
+  data::enumerator_identifier_generator id_generator;
+  Queue P;
+  std::size_t result = 0;
+  for (std::size_t i = 0; i < count; i++)
+  {
+    result += enumerate(dataspec, R, id_generator, P, variables, condition);
+  }
+  return result;
+}
+
+int main(int, char*[])
+{
+  data::data_specification dataspec = data::parse_data_specification("sort D = struct d1 | d2 | d3 | d4;");
+  dataspec.add_context_sort(data::sort_nat::nat());
+
+  std::size_t solutions = 0;
+  utilities::run_benchmark("enumerator.nat", 40 * 40, [&]()
+  {
+    solutions += enumerate(dataspec, "x, y: Nat;", "x < 40 && y < 40");
+  });
+  utilities::run_benchmark("enumerator.structured", 4 * 4 * 4 * 4 * 4 * 4 * 4, [&]()
+  {
+    solutions += enumerate(dataspec, "a, b, c, d, e, f, g: D;", "true");
+  });
+
+  const std::size_t repetitions = 20000;
+  utilities::run_benchmark("enumerator.repeated_deque", repetitions * 7, [&]()
+  {
+    solutions += enumerate_repeatedly<std::deque<enumerator_element> >(dataspec, repetitions);
+  });
+  utilities::run_benchmark("enumerator.repeated_enumerator_queue", repetitions * 7, [&]()
+  {
+    solutions += enumerate_repeatedly<data::enumerator_queue<enumerator_element> >(dataspec, repetitions);
+  });
+
+  utilities::report_benchmarks("data_enumerator");
+  return solutions == 40 * 40 + 4 * 4 * 4 * 4 * 4 * 4 * 4 + 2 * repetitions * 7 ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file rewriter.cpp
+/// \brief Benchmark for the rewriter. The rewrite strategy is passed as the first argument.
+
+#include <iostream>
+#include "mcrl2/data/parse.h"
+#include "mcrl2/data/rewriter.h"
+#include "mcrl2/data/standard_numbers_utility.h"
+#include "mcrl2/utilities/benchmark.h"
+
+using namespace mcrl2;
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " STRATEGY" << std::endl;
+    return 1;
+  }
+
+  data::data_specification dataspec = data::parse_data_specification(
+    "map fib: Nat -> Nat;                                         \n"
+    "    upto: Nat -> List(Nat);                                  \n"
+    "    total: List(Nat) -> Nat;                                 \n"
+    "var n: Nat;                                                  \n"
+    "    l: List(Nat);                                            \n"
+    "eqn n <= 1 -> fib(n) = n;                                    \n"
+    "    n > 1 -> fib(n) = fib(Int2Nat(n - 1)) + fib(Int2Nat(n - 2));\n"
+    "    upto(0) = [];                                            \n"
+    "    n > 0 -> upto(n) = Int2Nat(n - 1) |> upto(Int2Nat(n - 1));\n"
+    "    total([]) = 0;                                           \n"
+    "    total(n |> l) = n + total(l);                             \n"
+  );
+
+  data::rewriter::strategy strategy = data::parse_rewrite_strategy(argv[1]);
+  data::rewriter R;
+  utilities::run_benchmark("rewriter." + std::string(argv[1]) + ".construction", 1, [&]()
+  {
+    R = data::rewriter(dataspec, strategy);
+  });
+
+  data::data_expression fib = data::parse_data_expression("fib(20)", dataspec);
+  data::data_expression total = data::parse_data_expression("total(upto(2000))", dataspec);
+  data::data_expression fib_result;
+  data::data_expression total_result;
+
+  const std::size_t iterations = 10;
+  utilities::run_benchmark("rewriter." + std::string(argv[1]) + ".fib", iterations, [&]()
+  {
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+      fib_result = R(fib);
+    }
+  });
+  utilities::run_benchmark("rewriter." + std::string(argv[1]) + ".total", iterations, [&]()
+  {
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+      total_result = R(total);
+    }
+  });
+
+  utilities::report_benchmarks("data_rewriter");
+  return fib_result == R(data::sort_nat::nat("6765")) &&
+         total_result == R(data::sort_nat::nat("1999000")) ? 0 : 1;
+}
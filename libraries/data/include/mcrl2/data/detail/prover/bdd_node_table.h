@@ -0,0 +1,191 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/data/detail/prover/bdd_node_table.h
+/// \brief A table of hash-consed EQ-BDD nodes that are represented by integers.
+
+#ifndef MCRL2_DATA_DETAIL_PROVER_BDD_NODE_TABLE_H
+#define MCRL2_DATA_DETAIL_PROVER_BDD_NODE_TABLE_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "mcrl2/data/bool.h"
+#include "mcrl2/data/standard.h"
+#include "mcrl2/utilities/hash_utility.h"
+
+namespace mcrl2
+{
+namespace data
+{
+namespace detail
+{
+
+/// \brief A table of EQ-BDD nodes, in which a node is represented by an integer.
+/// \details A node is either a leaf, that contains an arbitrary expression, or an if-then-else node
+/// with a guard and two branches. The nodes are hash-consed, so two nodes are equal if and only if
+/// their numbers are equal, and reduced: an if-then-else node with equal branches is never created.
+/// The leaves true and false are always present, with numbers BDD_Node_Table::true_node and
+/// BDD_Node_Table::false_node. A node can be converted to the corresponding if-then-else expression
+/// using to_expression. Since the number of nodes only grows, the table must be cleared from time to
+/// time, at a point where no node numbers are in use anymore.
+class BDD_Node_Table
+{
+  public:
+    typedef std::size_t node;
+
+    /// \brief The node of the leaf false.
+    static constexpr node false_node = 0;
+
+    /// \brief The node of the leaf true.
+    static constexpr node true_node = 1;
+
+  protected:
+    /// \brief The value of the branches of a leaf.
+    static constexpr node no_node = static_cast<node>(-1);
+
+    struct node_data
+    {
+      // The guard of an if-then-else node, or the expression of a leaf.
+      data_expression expression;
+      node high;
+      node low;
+
+      node_data(const data_expression& expression_, node high_, node low_)
+        : expression(expression_), high(high_), low(low_)
+      {}
+
+      bool operator==(const node_data& other) const
+      {
+        return expression == other.expression && high == other.high && low == other.low;
+      }
+    };
+
+    struct node_data_hash
+    {
+      std::size_t operator()(const node_data& x) const
+      {
+        std::size_t h = std::hash<atermpp::aterm>()(x.expression);
+        h = utilities::detail::hash_combine(h, x.high);
+        return utilities::detail::hash_combine(h, x.low);
+      }
+    };
+
+    std::vector<node_data> m_nodes;
+    std::unordered_map<node_data, node, node_data_hash> m_unique_table;
+
+    // The expressions of the nodes that have been converted by to_expression.
+    std::vector<data_expression> m_expressions;
+
+    node insert(const node_data& x)
+    {
+      auto i = m_unique_table.find(x);
+      if (i != m_unique_table.end())
+      {
+        return i->second;
+      }
+      node result = m_nodes.size();
+      m_nodes.push_back(x);
+      m_unique_table.emplace(x, result);
+      return result;
+    }
+
+  public:
+    BDD_Node_Table()
+    {
+      clear();
+    }
+
+    /// \brief Removes all nodes, except the leaves true and false.
+    void clear()
+    {
+      m_nodes.clear();
+      m_unique_table.clear();
+      m_expressions.clear();
+      insert(node_data(sort_bool::false_(), no_node, no_node));
+      insert(node_data(sort_bool::true_(), no_node, no_node));
+    }
+
+    /// \brief Returns the number of nodes.
+    std::size_t size() const
+    {
+      return m_nodes.size();
+    }
+
+    /// \brief Returns the leaf with expression x.
+    node leaf(const data_expression& x)
+    {
+      return insert(node_data(x, no_node, no_node));
+    }
+
+    /// \brief Returns the node with guard a_guard, true-branch a_high and false-branch a_low. If a_high
+    ///        equals a_low, a_high is returned instead.
+    node if_then_else(const data_expression& a_guard, node a_high, node a_low)
+    {
+      if (a_high == a_low)
+      {
+        return a_high;
+      }
+      return insert(node_data(a_guard, a_high, a_low));
+    }
+
+    /// \brief Returns true if n is an if-then-else node.
+    bool is_if_then_else(node n) const
+    {
+      return m_nodes[n].high != no_node;
+    }
+
+    /// \brief Returns the guard of an if-then-else node, or the expression of a leaf.
+    const data_expression& expression(node n) const
+    {
+      return m_nodes[n].expression;
+    }
+
+    /// \brief Returns the true-branch of an if-then-else node.
+    node high(node n) const
+    {
+      return m_nodes[n].high;
+    }
+
+    /// \brief Returns the false-branch of an if-then-else node.
+    node low(node n) const
+    {
+      return m_nodes[n].low;
+    }
+
+    /// \brief Returns the expression that corresponds to node n, in which if-then-else nodes are
+    ///        represented by applications of if.
+    data_expression to_expression(node n)
+    {
+      if (!is_if_then_else(n))
+      {
+        return m_nodes[n].expression;
+      }
+      if (m_expressions.size() <= n)
+      {
+        m_expressions.resize(m_nodes.size());
+      }
+      if (m_expressions[n] == data_expression())
+      {
+        // The nodes are copied, since the recursive calls may resize m_nodes.
+        const data_expression guard = m_nodes[n].expression;
+        const node high = m_nodes[n].high;
+        const node low = m_nodes[n].low;
+        const data_expression high_expression = to_expression(high);
+        const data_expression low_expression = to_expression(low);
+        m_expressions[n] = if_(guard, high_expression, low_expression);
+      }
+      return m_expressions[n];
+    }
+};
+
+} // namespace detail
+} // namespace data
+} // namespace mcrl2
+
+#endif // MCRL2_DATA_DETAIL_PROVER_BDD_NODE_TABLE_H
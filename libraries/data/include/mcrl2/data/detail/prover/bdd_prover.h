@@ -13,6 +13,7 @@
 #define MCRL2_DATA_DETAIL_BDD_PROVER_H
 
 #include "mcrl2/data/data_specification.h"
+#include "mcrl2/data/detail/prover/bdd_node_table.h"
 #include "mcrl2/data/detail/prover/bdd_path_eliminator.h"
 #include "mcrl2/data/detail/prover/bdd_simplifier.h"
 #include "mcrl2/data/detail/prover/induction.h"
@@ -78,6 +79,14 @@ namespace detail
  * BDD_Prover::get_witness and BDD_Prover::get_counter_example. A
  * witness is a valuation for which the formula holds, a counter
  * example is a valuation for which it does not hold.
+ *
+ * While an EQ-BDD is constructed, its nodes are kept in a table of
+ * hash-consed integer nodes (see BDD_Node_Table), and the results of
+ * rewriting and orienting the branches of a formula are kept in a
+ * computed table. These tables, and the table that maps formulas to
+ * their EQ-BDDs, are reused for subsequent formulas. When they contain
+ * more than BDD_Prover::get_table_limit entries, they are cleared
+ * before the next formula is processed.
 */
 
 enum Answer
@@ -137,9 +146,18 @@ class BDD_Prover: protected rewriter
     /// \brief A data specification.
     // const data_specification& f_data_spec;
 
+    /// \brief The nodes of the BDDs.
+    BDD_Node_Table f_bdd_nodes;
+
     /// \brief A hashtable that maps formulas to BDDs.
-    /// \brief If the BDD of a formula is unknown, it maps this formula to 0.
-    std::unordered_map < data_expression, data_expression > f_formula_to_bdd;
+    std::unordered_map < data_expression, BDD_Node_Table::node > f_formula_to_bdd;
+
+    /// \brief A computed table that maps the formulas in which a guard has been replaced by true or
+    /// \brief false to their rewritten and oriented form.
+    std::unordered_map < data_expression, data_expression > f_rewritten;
+
+    /// \brief The maximal number of entries of the tables before they are cleared.
+    std::size_t f_table_limit = 1000000;
 
     /// \brief A hashtable that maps formulas to the smallest guard occuring in those formulas.
     /// \brief If the smallest guard of a formula is unknown, it maps this formula to 0.
@@ -151,10 +169,45 @@ class BDD_Prover: protected rewriter
     /// \brief Class that creates all statements needed to prove a given property using induction.
     Induction f_induction;
 
+    /// \brief Clears the tables that depend on the substitution of the prover.
+    void clear_tables()
+    {
+      f_bdd_nodes.clear();
+      f_formula_to_bdd.clear();
+      f_rewritten.clear();
+    }
+
+    /// \brief Clears all tables if they have grown beyond BDD_Prover::f_table_limit.
+    void collect_garbage()
+    {
+      if (f_bdd_nodes.size() + f_rewritten.size() + f_smallest.size() + f_manipulator.size() > f_table_limit)
+      {
+        mCRL2log(log::debug) << "Clearing the tables of the BDD prover." << std::endl;
+        clear_tables();
+        f_smallest.clear();
+        f_manipulator.clear();
+      }
+    }
+
+    /// \brief Returns the rewritten and oriented form of a_formula, which is a formula in which a guard has been
+    /// \brief replaced by true or false.
+    data_expression rewrite_and_orient(const data_expression& a_formula)
+    {
+      const std::unordered_map < data_expression, data_expression >::const_iterator i = f_rewritten.find(a_formula);
+      if (i != f_rewritten.end())
+      {
+        return i->second;
+      }
+      data_expression result = f_manipulator.orient(m_rewriter->rewrite(a_formula, bdd_sigma));
+      f_rewritten[a_formula] = result;
+      return result;
+    }
+
     /// \brief Constructs the EQ-BDD corresponding to the formula Prover::f_formula.
     void build_bdd()
     {
       f_deadline = time(nullptr) + f_time_limit;
+      collect_garbage();
 
       data_expression v_previous_1;
       data_expression v_previous_2;
@@ -172,7 +225,7 @@ class BDD_Prover: protected rewriter
       {
         v_previous_2 = v_previous_1;
         v_previous_1 = intermediate_bdd;
-        intermediate_bdd = bdd_down(intermediate_bdd);
+        intermediate_bdd = f_bdd_nodes.to_expression(bdd_down(intermediate_bdd));
         mCRL2log(log::debug) << "End of iteration." << std::endl;
         mCRL2log(log::debug) << "Intermediate BDD: " << intermediate_bdd << std::endl;
       }
@@ -189,31 +242,31 @@ class BDD_Prover: protected rewriter
     }
 
     /// \brief Creates the EQ-BDD corresponding to the formula a_formula.
-    data_expression bdd_down(const data_expression& a_formula, const size_t a_indent=0)
+    BDD_Node_Table::node bdd_down(const data_expression& a_formula, const size_t a_indent=0)
     {
 
       if (f_time_limit != 0 && (f_deadline - time(nullptr)) <= 0)
       {
         mCRL2log(log::debug) << "The time limit has passed." << std::endl;
-        return a_formula;
+        return f_bdd_nodes.leaf(a_formula);
       }
 
       if (a_formula==sort_bool::true_())
       {
-        return a_formula;
+        return BDD_Node_Table::true_node;
       }
       if (a_formula==sort_bool::false_())
       {
-        return a_formula;
+        return BDD_Node_Table::false_node;
       }
 
       if (is_abstraction(a_formula))
       {
         const abstraction& a = atermpp::down_cast<abstraction>(a_formula);
-        return abstraction(a.binding_operator(), a.variables(), bdd_down(a.body(), a_indent));
+        return f_bdd_nodes.leaf(abstraction(a.binding_operator(), a.variables(), f_bdd_nodes.to_expression(bdd_down(a.body(), a_indent))));
       }
 
-      const std::unordered_map < data_expression, data_expression >::const_iterator i = f_formula_to_bdd.find(a_formula);
+      const std::unordered_map < data_expression, BDD_Node_Table::node >::const_iterator i = f_formula_to_bdd.find(a_formula);
       if (i!=f_formula_to_bdd.end()) // found
       {
         return i->second;
@@ -222,7 +275,7 @@ class BDD_Prover: protected rewriter
       data_expression v_guard = smallest(a_formula);
       if (v_guard==data_expression())
       {
-        return a_formula;
+        return f_bdd_nodes.leaf(a_formula);
       }
       else
       {
@@ -231,21 +284,17 @@ class BDD_Prover: protected rewriter
 
       const size_t extra_indent = a_indent + 2;
 
-      data_expression v_term1 = f_manipulator.set_true(a_formula, v_guard);
-      v_term1 = m_rewriter->rewrite(v_term1,bdd_sigma);
-      v_term1 = f_manipulator.orient(v_term1);
+      const data_expression v_term1 = rewrite_and_orient(f_manipulator.set_true(a_formula, v_guard));
       mCRL2log(log::debug) << indent(extra_indent) << "True-branch after rewriting and orienting: " << v_term1 << std::endl;
-      v_term1 = bdd_down(v_term1, extra_indent);
-      mCRL2log(log::debug) << indent(extra_indent) << "BDD of the true-branch: " << v_term1 << std::endl;
+      const BDD_Node_Table::node v_bdd1 = bdd_down(v_term1, extra_indent);
+      mCRL2log(log::debug) << indent(extra_indent) << "BDD of the true-branch: " << f_bdd_nodes.to_expression(v_bdd1) << std::endl;
 
-      data_expression v_term2 = f_manipulator.set_false(a_formula, v_guard);
-      v_term2 = m_rewriter->rewrite(v_term2,bdd_sigma);
-      v_term2 = f_manipulator.orient(v_term2);
+      const data_expression v_term2 = rewrite_and_orient(f_manipulator.set_false(a_formula, v_guard));
       mCRL2log(log::debug) << indent(extra_indent) << "False-branch after rewriting and orienting: " << v_term2 << std::endl;
-      v_term2 = bdd_down(v_term2, extra_indent);
-      mCRL2log(log::debug) << indent(extra_indent) << "BDD of the false-branch: " << v_term2 << std::endl;
+      const BDD_Node_Table::node v_bdd2 = bdd_down(v_term2, extra_indent);
+      mCRL2log(log::debug) << indent(extra_indent) << "BDD of the false-branch: " << f_bdd_nodes.to_expression(v_bdd2) << std::endl;
 
-      data_expression v_bdd = Manipulator::make_reduced_if_then_else(v_guard, v_term1, v_term2);
+      const BDD_Node_Table::node v_bdd = f_bdd_nodes.if_then_else(v_guard, v_bdd1, v_bdd2);
       f_formula_to_bdd[a_formula]=v_bdd;
 
       return v_bdd;
@@ -490,6 +539,7 @@ class BDD_Prover: protected rewriter
       switch (a_rewrite_strategy)
       {
         case(jitty):
+        case(jitty_bytecode):
 #ifdef MCRL2_JITTYC_AVAILABLE
         case(jitty_compiling):
 #endif
@@ -527,12 +577,27 @@ class BDD_Prover: protected rewriter
     void set_substitution(substitution_type& sigma)
     {
       bdd_sigma = sigma;
+      clear_tables();
     }
 
     /// \brief Set the substitution in internal format to be used to construct the BDD
     void set_substitution_internal(substitution_type& sigma)
     {
       bdd_sigma = sigma;
+      clear_tables();
+    }
+
+    /// \brief Returns the maximal number of entries of the tables of the prover. If the tables contain more
+    /// \brief entries, they are cleared before the next formula is processed.
+    std::size_t get_table_limit() const
+    {
+      return f_table_limit;
+    }
+
+    /// \brief Sets the maximal number of entries of the tables of the prover.
+    void set_table_limit(std::size_t a_table_limit)
+    {
+      f_table_limit = a_table_limit;
     }
 
     /// \brief Indicates whether or not the formula Prover::f_formula is a tautology.
@@ -190,6 +190,18 @@ class Manipulator
       return v_result;
     }
 
+    /// \brief Returns the number of entries of the table Manipulator::f_orient.
+    std::size_t size() const
+    {
+      return f_orient.size();
+    }
+
+    /// \brief Clears the table Manipulator::f_orient.
+    void clear()
+    {
+      f_orient.clear();
+    }
+
     /// \brief Initializes the table Manipulator::f_set_true and calls
     /// \brief f_set_true_auxiliary.
     data_expression set_true(
@@ -80,6 +80,15 @@ class Rewriter
      **/
     virtual rewrite_strategy getStrategy() = 0;
 
+    /**
+     * \brief Create a rewriter that shares the rewrite rules with this rewriter, but that
+     *        has its own internal state, such that both can be used independently.
+     * \details This is much cheaper than creating a new rewriter for the same specification.
+     *          Rewriters that do not support this throw an exception.
+     * \return A (pointer to a) rewriter with the same strategy and rewrite rules.
+     **/
+    virtual std::shared_ptr<Rewriter> clone();
+
     /**
      * \brief Rewrite an mCRL2 data term.
      * \param Term The term to be rewritten. This term should be a data_term
@@ -14,6 +14,8 @@
 #include "mcrl2/data/detail/rewrite.h"
 #include "mcrl2/data/data_specification.h"
 #include "mcrl2/data/detail/rewrite/strategy_rule.h"
+#include "mcrl2/data/function_sort.h"
+#include "mcrl2/data/untyped_sort.h"
 
 namespace mcrl2
 {
@@ -22,6 +24,46 @@ namespace data
 namespace detail
 {
 
+typedef atermpp::detail::_aterm* unprotected_variable;           // Variable that is not protected (so a copy should exist at some other place)
+typedef atermpp::detail::_aterm* unprotected_data_expression;    // Idem, but now a data expression.
+
+struct jitty_variable_assignment_for_a_rewrite_rule
+{
+  unprotected_variable var;
+  unprotected_data_expression term;
+  bool variable_is_a_normal_form;
+};
+
+struct jitty_assignments_for_a_rewrite_rule
+{
+  std::size_t size;
+  jitty_variable_assignment_for_a_rewrite_rule* assignment;
+
+  jitty_assignments_for_a_rewrite_rule(jitty_variable_assignment_for_a_rewrite_rule* a)
+   : size(0),
+     assignment(a)
+  {}
+
+};
+
+// The function symbol below is used to administrate that a term is in normal form. It is put around a term.
+// Terms with this auxiliary function symbol cannot be printed using the pretty printer for data expressions.
+inline
+const function_symbol& this_term_is_in_normal_form()
+{
+  static const function_symbol this_term_is_in_normal_form(
+                         std::string("Rewritten@@term"),
+                         function_sort({ untyped_sort() },untyped_sort()));
+  return this_term_is_in_normal_form;
+}
+
+/// \brief Applies the assignments to t. Variables that are assigned a normal form are
+///        marked with this_term_is_in_normal_form.
+data_expression subst_values(
+            const jitty_assignments_for_a_rewrite_rule& assignments,
+            const data_expression& t,
+            data::enumerator_identifier_generator& generator);
+
 class RewriterJitty: public Rewriter
 {
   public:
@@ -32,14 +74,22 @@ class RewriterJitty: public Rewriter
 
     rewrite_strategy getStrategy();
 
+    std::shared_ptr<Rewriter> clone();
+
     data_expression rewrite(const data_expression &term, substitution_type &sigma);
 
     RewriterJitty& operator=(const RewriterJitty& other)=delete;
 
-  private:
-    std::map< function_symbol, data_equation_list > jitty_eqns;
-    std::vector<strategy> jitty_strat;
+  protected:
+    // The strategies of the function symbols, indexed by the index of the function symbol. They are
+    // not changed after construction, and they are shared with the clones of this rewriter.
+    std::shared_ptr<const std::vector<strategy> > jitty_strat;
     std::size_t MAX_LEN; 
+    bool m_profiling; // True if the applications of rewrite rules are recorded in global_rewrite_profile().
+
+    /// \brief Constructor for clone. The strategies are shared with other.
+    RewriterJitty(const RewriterJitty& other);
+
     data_expression rewrite_aux(const data_expression& term, substitution_type& sigma);
     void build_strategies();
 
@@ -52,11 +102,16 @@ class RewriterJitty: public Rewriter
                       const function_symbol& op,
                       substitution_type& sigma);
 
-    /* Auxiliary function to take care that the array jitty_strat is sufficiently large
-       to access element i */
-    void make_jitty_strat_sufficiently_larger(const std::size_t i);
+    /* Returns the strategy of the function symbol with index i. Function symbols that did
+       not exist when the rewriter was created have no rewrite rules. */
+    const strategy& get_strategy(const std::size_t i) const
+    {
+      static const strategy no_rules;
+      return i < jitty_strat->size() ? (*jitty_strat)[i] : no_rules;
+    }
+
     strategy create_strategy(const data_equation_list& rules1);
-    void rebuild_strategy();
+    void rebuild_strategy(const std::map< function_symbol, data_equation_list >& jitty_eqns);
 };
 
 /// \brief removes auxiliary expressions this_term_is_in_normal_form from data_expressions that are being rewritten.
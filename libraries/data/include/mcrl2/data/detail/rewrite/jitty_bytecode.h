@@ -0,0 +1,85 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/data/detail/rewrite/jitty_bytecode.h
+/// \brief A jitty rewriter that executes the rewrite strategies as bytecode.
+
+#ifndef MCRL2_DATA_DETAIL_REWRITE_JITTY_BYTECODE_H
+#define MCRL2_DATA_DETAIL_REWRITE_JITTY_BYTECODE_H
+
+#include "mcrl2/data/detail/rewrite/jitty.h"
+
+namespace mcrl2
+{
+namespace data
+{
+namespace detail
+{
+
+/// \brief The bytecode of the rewrite strategy of a single function symbol.
+/// \details The matching code consists of instructions on the arguments of a term, and
+/// is executed by RewriterJittyBytecode::execute. The conditions and right hand sides of
+/// the rewrite rules are compiled to separate build code, that constructs the instance of
+/// a condition or right hand side on a stack. Both are sequences of integers, in which
+/// an opcode is followed by its operands.
+struct bytecode_program
+{
+  std::vector<std::size_t> match_code;
+  std::vector<std::size_t> build_code;
+
+  // The terms and rewrite rules that are referred to by the instructions.
+  std::vector<data_expression> constants;
+  std::vector<data_equation> equations;
+
+  // The maximal number of variables of a rewrite rule, and the maximal nesting depth
+  // of the left hand side of a rewrite rule.
+  std::size_t number_of_variables = 0;
+  std::size_t max_depth = 0;
+};
+
+/// \brief A rewriter that uses the same strategies as the jitty rewriter, but compiles
+///        them into bytecode that is executed by a single interpreter loop.
+/// \details In contrast to the compiling jitty rewriter it requires no C++ compiler at
+///          runtime, while the cost of interpreting the strategies and matching the left
+///          hand sides of the rewrite rules is much lower than in the jitty rewriter.
+class RewriterJittyBytecode: public RewriterJitty
+{
+  public:
+    typedef Rewriter::substitution_type substitution_type;
+
+    RewriterJittyBytecode(const data_specification& data_spec, const used_data_equation_selector& equation_selector);
+
+    rewrite_strategy getStrategy();
+
+    std::shared_ptr<Rewriter> clone();
+
+    data_expression rewrite(const data_expression& term, substitution_type& sigma);
+
+  private:
+    // The programs of the function symbols, indexed by the index of the function symbol. They are
+    // shared with the clones of this rewriter.
+    std::shared_ptr<const std::vector<bytecode_program> > m_programs;
+
+    // The stack on which the build code constructs terms.
+    std::vector<data_expression> m_build_stack;
+
+    /// \brief Constructor for clone. The strategies and programs are shared with other.
+    RewriterJittyBytecode(const RewriterJittyBytecode& other);
+
+    void compile_strategies();
+
+    data_expression rewrite_aux(const data_expression& term, substitution_type& sigma);
+
+    data_expression rewrite_aux_function_symbol(const function_symbol& op, const data_expression& term, substitution_type& sigma);
+};
+
+} // namespace detail
+} // namespace data
+} // namespace mcrl2
+
+#endif // MCRL2_DATA_DETAIL_REWRITE_JITTY_BYTECODE_H
@@ -0,0 +1,224 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/data/detail/rewrite_profile.h
+/// \brief Global profile of the rewrite rules that are applied by the rewriter.
+
+#ifndef MCRL2_DATA_DETAIL_REWRITE_PROFILE_H
+#define MCRL2_DATA_DETAIL_REWRITE_PROFILE_H
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mcrl2/data/data_equation.h"
+#include "mcrl2/data/print.h"
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2
+{
+
+namespace data
+{
+
+namespace detail
+{
+
+/// \brief Counts how often the rewriter tries to apply a rewrite rule, how often it succeeds, and
+///        how much time it takes.
+/// \details The time of an attempt is the time needed to match the left hand side and to rewrite
+/// the condition, so it includes the time of the rewrite steps that are needed for the condition.
+/// A profile that is written to a file can be read back, in which case the rewriter orders the rewrite
+/// rules that it may try at the same point by decreasing success rate (see rule_order).
+class rewrite_profile
+{
+  public:
+    struct equation_profile
+    {
+      std::size_t attempts = 0;
+      std::size_t successes = 0;
+      std::chrono::steady_clock::duration time = std::chrono::steady_clock::duration::zero();
+    };
+
+  protected:
+    bool m_enabled = false;
+    std::unordered_map<data_equation, equation_profile, std::hash<atermpp::aterm> > m_profiles;
+    std::mutex m_mutex; // Protects m_profiles in add.
+
+    // The success rates of a profile that was read from a file, indexed by the printed equations.
+    std::map<std::string, double> m_success_rates;
+
+  public:
+    /// \brief Returns true if the rewriters must record the applications of rewrite rules.
+    bool enabled() const
+    {
+      return m_enabled;
+    }
+
+    void set_enabled(bool enabled)
+    {
+      m_enabled = enabled;
+    }
+
+    /// \brief Records an attempt to apply the rewrite rule eq. This function is thread safe.
+    void add(const data_equation& eq, bool success, std::chrono::steady_clock::duration time)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      equation_profile& p = m_profiles[eq];
+      p.attempts++;
+      if (success)
+      {
+        p.successes++;
+      }
+      p.time += time;
+    }
+
+    const std::unordered_map<data_equation, equation_profile, std::hash<atermpp::aterm> >& profiles() const
+    {
+      return m_profiles;
+    }
+
+    /// \brief Writes a report with a line for each rewrite rule that has been tried, containing the number
+    ///        of attempts, the number of successes, the time in milliseconds and the rewrite rule.
+    /// \details The rewrite rules are grouped by the head symbol of the left hand side. The groups are
+    /// sorted by decreasing total time, and within a group the rules are sorted by decreasing time.
+    void write_report(std::ostream& out) const
+    {
+      typedef std::pair<data_equation, equation_profile> entry;
+      std::map<std::string, std::vector<entry> > groups;
+      for (const auto& p: m_profiles)
+      {
+        data_expression head = p.first.lhs();
+        while (is_application(head))
+        {
+          head = atermpp::down_cast<application>(head).head();
+        }
+        groups[data::pp(head)].push_back(p);
+      }
+
+      auto total_time = [](const std::vector<entry>& v)
+      {
+        std::chrono::steady_clock::duration result = std::chrono::steady_clock::duration::zero();
+        for (const entry& e: v)
+        {
+          result += e.second.time;
+        }
+        return result;
+      };
+
+      std::vector<std::pair<std::string, std::vector<entry> > > sorted_groups(groups.begin(), groups.end());
+      std::stable_sort(sorted_groups.begin(), sorted_groups.end(), [&](const std::pair<std::string, std::vector<entry> >& x, const std::pair<std::string, std::vector<entry> >& y)
+      {
+        return total_time(x.second) > total_time(y.second);
+      });
+
+      out << "# attempts successes time(ms) equation" << std::endl;
+      for (auto& group: sorted_groups)
+      {
+        std::vector<entry>& v = group.second;
+        std::stable_sort(v.begin(), v.end(), [](const entry& x, const entry& y)
+        {
+          return x.second.time > y.second.time;
+        });
+        out << "# " << group.first << ": " << std::fixed << std::setprecision(3)
+            << std::chrono::duration<double, std::milli>(total_time(v)).count() << " ms" << std::endl;
+        for (const entry& e: v)
+        {
+          out << e.second.attempts << " " << e.second.successes << " " << std::fixed << std::setprecision(3)
+              << std::chrono::duration<double, std::milli>(e.second.time).count() << " " << data::pp(e.first) << std::endl;
+        }
+      }
+    }
+
+    /// \brief Writes the report to the file with the given name.
+    void write_report(const std::string& filename) const
+    {
+      std::ofstream out(filename);
+      if (!out)
+      {
+        throw mcrl2::runtime_error("Could not open file " + filename + " for writing the rewrite profile.");
+      }
+      write_report(out);
+    }
+
+    /// \brief Reads a report that was written by write_report. The success rates in the report are
+    ///        used by rule_order.
+    void read_report(std::istream& in)
+    {
+      std::string line;
+      while (std::getline(in, line))
+      {
+        if (line.empty() || line[0] == '#')
+        {
+          continue;
+        }
+        std::istringstream is(line);
+        std::size_t attempts;
+        std::size_t successes;
+        double time;
+        if (!(is >> attempts >> successes >> time))
+        {
+          throw mcrl2::runtime_error("Invalid line in rewrite profile: " + line);
+        }
+        std::string equation;
+        std::getline(is >> std::ws, equation);
+        m_success_rates[equation] = attempts == 0 ? 0.0 : static_cast<double>(successes) / attempts;
+      }
+    }
+
+    /// \brief Reads the report in the file with the given name.
+    void read_report(const std::string& filename)
+    {
+      std::ifstream in(filename);
+      if (!in)
+      {
+        throw mcrl2::runtime_error("Could not open file " + filename + " for reading the rewrite profile.");
+      }
+      read_report(in);
+    }
+
+    /// \brief Returns true if a profile has been read.
+    bool has_rule_order() const
+    {
+      return !m_success_rates.empty();
+    }
+
+    /// \brief Returns a key for ordering rewrite rules, such that rules with a smaller key are
+    ///        tried first. Rules that do not occur in the profile that has been read come last.
+    double rule_order(const data_equation& eq) const
+    {
+      auto i = m_success_rates.find(data::pp(eq));
+      if (i == m_success_rates.end())
+      {
+        return 1.0;
+      }
+      return -i->second;
+    }
+};
+
+/// \brief The profile of the rewrite rules of all rewriters of this process.
+inline
+rewrite_profile& global_rewrite_profile()
+{
+  static rewrite_profile profile;
+  return profile;
+}
+
+} // namespace detail
+
+} // namespace data
+
+} // namespace mcrl2
+
+#endif // MCRL2_DATA_DETAIL_REWRITE_PROFILE_H
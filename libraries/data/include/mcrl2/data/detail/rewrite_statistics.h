@@ -7,12 +7,13 @@
 // http://www.boost.org/LICENSE_1_0.txt)
 //
 /// \file mcrl2/data/detail/rewrite_statistics.h
-/// \brief Global variable for collecting rewrite statistics.
+/// \brief Global counter for collecting rewrite statistics.
 
 #ifndef MCRL2_DATA_DETAIL_REWRITE_STATISTICS_H
 #define MCRL2_DATA_DETAIL_REWRITE_STATISTICS_H
 
 #include "mcrl2/utilities/logger.h"
+#include "mcrl2/utilities/metrics.h"
 
 namespace mcrl2
 {
@@ -23,19 +24,18 @@ namespace data
 namespace detail
 {
 
-template <class T> // note, T is only a dummy
-struct rewrite_statistics
+/// \brief The counter of the number of calls to the rewriter, which is available as the metric data.rewrite_count.
+inline
+utilities::metrics_counter& rewrite_counter()
 {
-  static std::size_t rewrite_count;
-};
-
-template <class T>
-std::size_t rewrite_statistics<T>::rewrite_count = 0;
+  static utilities::metrics_counter& counter = utilities::metrics().counter("data.rewrite_count");
+  return counter;
+}
 
 inline
 std::size_t rewrite_count()
 {
-  return rewrite_statistics<int>::rewrite_count;
+  return rewrite_counter().value();
 }
 
 inline
@@ -47,11 +47,13 @@ void display_rewrite_statistics()
 inline
 void increment_rewrite_count()
 {
-  rewrite_statistics<int>::rewrite_count++;
+  rewrite_counter().increment();
+#ifdef MCRL2_DISPLAY_REWRITE_STATISTICS
   if (rewrite_count() % 10000 == 0)
   {
     display_rewrite_statistics();
   }
+#endif
 }
 
 } // namespace detail
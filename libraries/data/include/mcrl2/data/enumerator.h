@@ -15,11 +15,13 @@
 #include "mcrl2/core/detail/print_utility.h"
 #include "mcrl2/data/detail/enumerator_identifier_generator.h"
 #include "mcrl2/data/detail/enumerator_variable_limit.h"
+#include "mcrl2/data/enumerator_queue.h"
 #include "mcrl2/data/identifier_generator.h"
 #include "mcrl2/data/rewriter.h"
 #include "mcrl2/data/substitutions/enumerator_substitution.h"
 #include "mcrl2/data/substitutions/mutable_indexed_substitution.h"
 #include "mcrl2/utilities/math.h"
+#include "mcrl2/utilities/metrics.h"
 #include <boost/iterator/iterator_facade.hpp>
 #include <deque>
 #include <limits>
@@ -395,6 +397,10 @@ class enumerator_algorithm
     /// \brief throw_exceptions If true, an exception is thrown when the enumeration is aborted.
     bool m_throw_exceptions;
 
+    /// \brief Contains for sorts with constructors that have a small finite number of elements
+    /// all elements in normal form. An empty vector means that the elements of the sort are not cached.
+    mutable std::map<sort_expression, data_expression_vector> m_finite_domains;
+
     std::string print(const data::variable& x) const
     {
       std::ostringstream out;
@@ -418,8 +424,8 @@ class enumerator_algorithm
     }
 
     // add element without additional variables
-    template <typename EnumeratorListElement, typename MutableSubstitution, typename Filter, typename Expression>
-    void add_element(std::deque<EnumeratorListElement>& P,
+    template <typename Queue, typename EnumeratorListElement, typename MutableSubstitution, typename Filter, typename Expression>
+    void add_element(Queue& P,
                      MutableSubstitution& sigma,
                      Filter accept,
                      const data::variable_list& variables,
@@ -431,14 +437,14 @@ class enumerator_algorithm
       auto phi1 = const_cast<Rewriter&>(m_rewr)(phi, sigma);
       if (accept(phi1))
       {
-        P.emplace_back(EnumeratorListElement(variables, phi1, p, v, e));
+        P.emplace_back(variables, phi1, p, v, e);
         //mCRL2log(log::debug) << "  <add-element> " << P.back() << " with assignment " << v << " := " << e << std::endl;
       }
     }
 
     // add element with additional variables
-    template <typename EnumeratorListElement, typename MutableSubstitution, typename Filter, typename Expression>
-    void add_element(std::deque<EnumeratorListElement>& P,
+    template <typename Queue, typename EnumeratorListElement, typename MutableSubstitution, typename Filter, typename Expression>
+    void add_element(Queue& P,
                      MutableSubstitution& sigma,
                      Filter accept,
                      const data::variable_list& variables,
@@ -452,15 +458,15 @@ class enumerator_algorithm
       if (accept(phi1))
       {
         // Additional variables are put at the end of the list!
-        P.emplace_back(EnumeratorListElement(variables + added_variables, phi1, p, v, e));
+        P.emplace_back(variables + added_variables, phi1, p, v, e);
         //mCRL2log(log::debug) << "  <add-element> " << P.back() << " with assignment " << v << " := " << e << std::endl;
       }
     }
 
     // specialization for enumerator_list_element; in this case we are not interested in the substitutions,
     // and this allows an optimization
-    template <typename MutableSubstitution, typename Filter, typename Expression>
-    void add_element(std::deque<enumerator_list_element<Expression> >& P,
+    template <typename Queue, typename MutableSubstitution, typename Filter, typename Expression>
+    void add_element(Queue& P,
                      MutableSubstitution& sigma,
                      Filter accept,
                      const data::variable_list& variables,
@@ -476,17 +482,88 @@ class enumerator_algorithm
         if (phi1 == phi)
         {
           // Discard the added_variables, since we know they do not appear in phi1
-          P.emplace_back(enumerator_list_element<Expression>(variables, phi1, p, v, e));
+          P.emplace_back(variables, phi1, p, v, e);
         }
         else
         {
           // Additional variables are put at the end of the list!
-          P.emplace_back(enumerator_list_element<Expression>(variables + added_variables, phi1, p, v, e));
+          P.emplace_back(variables + added_variables, phi1, p, v, e);
         }
         //mCRL2log(log::debug) << "  <add-element> " << P.back() << " with assignment " << v << " := " << e << std::endl;
       }
     }
 
+    // Returns the elements of a sort with constructors that has at most finite_domain_limit elements, or an
+    // empty vector if there is no such sort. Since the elements are closed terms, they do not depend on the
+    // names generated by id_generator, and they can be reused in all subsequent enumerations.
+    template <typename MutableSubstitution>
+    const data_expression_vector& finite_domain(const sort_expression& sort, MutableSubstitution& sigma) const
+    {
+      const std::size_t finite_domain_limit = 1000;
+
+      auto i = m_finite_domains.find(sort);
+      if (i != m_finite_domains.end())
+      {
+        return i->second;
+      }
+      data_expression_vector& result = m_finite_domains[sort];
+      if (is_function_sort(sort) || is_container_sort(sort) || !dataspec.is_certainly_finite(sort))
+      {
+        return result;
+      }
+
+      data_expression_vector elements;
+      for (const function_symbol& constructor: dataspec.constructors(sort))
+      {
+        if (!data::is_function_sort(constructor.sort()))
+        {
+          elements.push_back(datar(constructor, sigma));
+          continue;
+        }
+
+        // Combine the elements of the argument sorts in all possible ways.
+        const auto& domain = atermpp::down_cast<data::function_sort>(constructor.sort()).domain();
+        std::vector<const data_expression_vector*> arguments;
+        for (const sort_expression& s: domain)
+        {
+          const data_expression_vector& d = finite_domain(s, sigma);
+          if (d.empty())
+          {
+            return result;
+          }
+          arguments.push_back(&d);
+        }
+        std::vector<std::size_t> index(arguments.size(), 0);
+        data_expression_vector args(arguments.size());
+        for (;;)
+        {
+          if (elements.size() >= finite_domain_limit)
+          {
+            return result;
+          }
+          for (std::size_t k = 0; k < arguments.size(); k++)
+          {
+            args[k] = (*arguments[k])[index[k]];
+          }
+          elements.push_back(datar(application(constructor, args.begin(), args.end()), sigma));
+          std::size_t k = 0;
+          while (k < arguments.size() && ++index[k] == arguments[k]->size())
+          {
+            index[k++] = 0;
+          }
+          if (k == arguments.size())
+          {
+            break;
+          }
+        }
+      }
+      if (elements.size() <= finite_domain_limit)
+      {
+        result.swap(elements);
+      }
+      return result;
+    }
+
   public:
     enumerator_algorithm(const Rewriter& R_,
                          const data::data_specification& dataspec_,
@@ -505,16 +582,17 @@ class enumerator_algorithm
 
   public:
     /// \brief Enumerates the front element of the todo list P.
-    /// \param P The todo list of the algorithm.
+    /// \param P The todo list of the algorithm. This is a std::deque or an enumerator_queue of
+    ///          enumerator list elements.
     /// \param sigma A mutable substitution that is applied by the rewriter.
     /// \param accept Elements p for which accept(p) is false are discarded.
     /// \pre !P.empty()
-    template <typename EnumeratorListElement, typename MutableSubstitution, typename Filter>
-    void enumerate_front(std::deque<EnumeratorListElement>& P, MutableSubstitution& sigma, Filter accept) const
+    template <typename Queue, typename MutableSubstitution, typename Filter>
+    void enumerate_front(Queue& P, MutableSubstitution& sigma, Filter accept) const
     {
       assert(!P.empty());
 
-      auto p = P.front();
+      auto p = std::move(P.front());
       const auto& v = p.variables();
       const auto& phi = p.expression();
       //mCRL2log(log::debug) << "  <process-element> " << p << std::endl;
@@ -607,6 +685,19 @@ class enumerator_algorithm
       }
       else
       {
+        // The elements of small finite sorts are enumerated at once.
+        const data_expression_vector& elements = finite_domain(sort, sigma);
+        if (!elements.empty())
+        {
+          for (const data_expression& e: elements)
+          {
+            sigma[v1] = e;
+            add_element(P, sigma, accept, vtail, phi, p, v1, e);
+          }
+          sigma[v1] = v1;
+          return;
+        }
+
         const function_symbol_vector& C = dataspec.constructors(sort);
         if (!C.empty())
         {
@@ -647,8 +738,8 @@ class enumerator_algorithm
     /// \param accept Elements p for which accept(p) is false are discarded.
     /// \return The number of elements that have been processed
     /// \post Either P.empty() or P.front().is_solution()
-    template <typename EnumeratorListElement, typename MutableSubstitution, typename Filter>
-    std::size_t next(std::deque<EnumeratorListElement>& P, MutableSubstitution& sigma, Filter accept) const
+    template <typename Queue, typename MutableSubstitution, typename Filter>
+    std::size_t next(Queue& P, MutableSubstitution& sigma, Filter accept) const
     {
       //mCRL2log(log::debug) << "  <next> " << core::detail::print_list(P) << std::endl;
       std::size_t count = 0;
@@ -669,6 +760,8 @@ class enumerator_algorithm
           }
         }
       }
+      static utilities::metrics_histogram& queue_size = utilities::metrics().histogram("data.enumerator_queue_size");
+      queue_size.observe(P.size());
       return count;
     }
 
@@ -684,7 +777,9 @@ class enumerator_algorithm
 };
 
 /// \brief An enumerator algorithm with an iterator interface.
-template <typename Rewriter = data::rewriter, typename EnumeratorListElement = enumerator_list_element_with_substitution<>, typename Filter = data::is_not_false, typename DataRewriter = data::rewriter, typename MutableSubstitution = data::mutable_indexed_substitution<> >
+/// \details The todo list has type Queue, which can be std::deque or enumerator_queue. The latter
+/// avoids memory allocations if the same todo list is used for many enumerations.
+template <typename Rewriter = data::rewriter, typename EnumeratorListElement = enumerator_list_element_with_substitution<>, typename Filter = data::is_not_false, typename DataRewriter = data::rewriter, typename MutableSubstitution = data::mutable_indexed_substitution<>, typename Queue = std::deque<EnumeratorListElement> >
 class enumerator_algorithm_with_iterator: public enumerator_algorithm<Rewriter, DataRewriter>
 {
   protected:
@@ -700,21 +795,21 @@ class enumerator_algorithm_with_iterator: public enumerator_algorithm<Rewriter,
     class iterator: public boost::iterator_facade<iterator, const EnumeratorListElement, boost::forward_traversal_tag>
     {
       protected:
-        enumerator_algorithm_with_iterator<Rewriter, EnumeratorListElement, Filter, DataRewriter, MutableSubstitution>* E;
+        enumerator_algorithm_with_iterator<Rewriter, EnumeratorListElement, Filter, DataRewriter, MutableSubstitution, Queue>* E;
         MutableSubstitution* sigma;
-        std::deque<EnumeratorListElement>* P;
+        Queue* P;
         Filter accept;
         std::size_t count;
 
-        static std::deque<EnumeratorListElement>& default_deque()
+        static Queue& default_deque()
         {
-          static std::deque<EnumeratorListElement> result;
+          static Queue result;
           return result;
         }
 
       public:
-        iterator(enumerator_algorithm_with_iterator<Rewriter, EnumeratorListElement, Filter, DataRewriter, MutableSubstitution>* E_,
-                 std::deque<EnumeratorListElement>* P_,
+        iterator(enumerator_algorithm_with_iterator<Rewriter, EnumeratorListElement, Filter, DataRewriter, MutableSubstitution, Queue>* E_,
+                 Queue* P_,
                  MutableSubstitution* sigma_,
                  Filter accept_ = Filter()
                 )
@@ -779,14 +874,14 @@ class enumerator_algorithm_with_iterator: public enumerator_algorithm<Rewriter,
     /// \param sigma A mutable substitution that is applied by the rewriter contained in E
     /// \param P The condition that is solved, together with the list of variables
     /// Otherwise an invalidated enumerator element is returned when it is dereferenced.
-    iterator begin(MutableSubstitution& sigma, std::deque<EnumeratorListElement>& P)
+    iterator begin(MutableSubstitution& sigma, Queue& P)
     {
       assert(P.size() == 1);
       auto& p = P.front();
       p.expression() = super::m_rewr(p.expression(), sigma);
       if (m_accept(p.expression()))
       {
-        return iterator(const_cast<enumerator_algorithm_with_iterator<Rewriter, EnumeratorListElement, Filter, DataRewriter, MutableSubstitution>*>(this), &P, &sigma, m_accept);
+        return iterator(const_cast<enumerator_algorithm_with_iterator<Rewriter, EnumeratorListElement, Filter, DataRewriter, MutableSubstitution, Queue>*>(this), &P, &sigma, m_accept);
       }
       else
       {
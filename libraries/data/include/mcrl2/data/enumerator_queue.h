@@ -0,0 +1,241 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/data/enumerator_queue.h
+/// \brief A queue for the todo list of the enumerator that reuses its storage.
+
+#ifndef MCRL2_DATA_ENUMERATOR_QUEUE_H
+#define MCRL2_DATA_ENUMERATOR_QUEUE_H
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mcrl2
+{
+
+namespace data
+{
+
+/// \brief A double ended queue that can be used instead of std::deque for the todo list of
+///        the enumerator.
+/// \details The elements are stored in a circular buffer of which the capacity is a power of two.
+/// Elements are constructed in place and destroyed when they are removed, but the buffer is only
+/// released when the queue is destroyed. Hence a queue that is reused, e.g. for every state in a
+/// state space exploration, does not allocate memory once it has reached its maximal size.
+template <typename T>
+class enumerator_queue
+{
+  protected:
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_type;
+
+    std::vector<storage_type> m_storage;
+    std::size_t m_first;
+    std::size_t m_size;
+
+    T* element(std::size_t i)
+    {
+      return reinterpret_cast<T*>(&m_storage[(m_first + i) & (m_storage.size() - 1)]);
+    }
+
+    const T* element(std::size_t i) const
+    {
+      return reinterpret_cast<const T*>(&m_storage[(m_first + i) & (m_storage.size() - 1)]);
+    }
+
+    // Makes sure that there is room for at least one more element.
+    void reserve_one()
+    {
+      if (m_size < m_storage.size())
+      {
+        return;
+      }
+      std::vector<storage_type> storage(m_storage.empty() ? 16 : 2 * m_storage.size());
+      for (std::size_t i = 0; i < m_size; i++)
+      {
+        T* x = element(i);
+        new (&storage[i]) T(std::move(*x));
+        x->~T();
+      }
+      m_storage.swap(storage);
+      m_first = 0;
+    }
+
+  public:
+    typedef T value_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+
+    /// \brief Constructs an empty queue.
+    enumerator_queue()
+      : m_first(0), m_size(0)
+    {}
+
+    /// \brief Constructs a queue with n copies of x.
+    enumerator_queue(std::size_t n, const T& x)
+      : m_first(0), m_size(0)
+    {
+      for (std::size_t i = 0; i < n; i++)
+      {
+        push_back(x);
+      }
+    }
+
+    enumerator_queue(const enumerator_queue& other)
+      : m_first(0), m_size(0)
+    {
+      for (std::size_t i = 0; i < other.size(); i++)
+      {
+        push_back(*other.element(i));
+      }
+    }
+
+    enumerator_queue(enumerator_queue&& other)
+      : m_storage(std::move(other.m_storage)), m_first(other.m_first), m_size(other.m_size)
+    {
+      other.m_storage.clear();
+      other.m_first = 0;
+      other.m_size = 0;
+    }
+
+    enumerator_queue& operator=(const enumerator_queue& other)
+    {
+      if (this != &other)
+      {
+        clear();
+        for (std::size_t i = 0; i < other.size(); i++)
+        {
+          push_back(*other.element(i));
+        }
+      }
+      return *this;
+    }
+
+    enumerator_queue& operator=(enumerator_queue&& other)
+    {
+      if (this != &other)
+      {
+        clear();
+        m_storage.swap(other.m_storage);
+        std::swap(m_first, other.m_first);
+        std::swap(m_size, other.m_size);
+      }
+      return *this;
+    }
+
+    ~enumerator_queue()
+    {
+      clear();
+    }
+
+    bool empty() const
+    {
+      return m_size == 0;
+    }
+
+    std::size_t size() const
+    {
+      return m_size;
+    }
+
+    /// \brief Returns the number of elements that fit in the queue without allocating memory.
+    std::size_t capacity() const
+    {
+      return m_storage.size();
+    }
+
+    T& front()
+    {
+      assert(!empty());
+      return *element(0);
+    }
+
+    const T& front() const
+    {
+      assert(!empty());
+      return *element(0);
+    }
+
+    T& back()
+    {
+      assert(!empty());
+      return *element(m_size - 1);
+    }
+
+    const T& back() const
+    {
+      assert(!empty());
+      return *element(m_size - 1);
+    }
+
+    T& operator[](std::size_t i)
+    {
+      assert(i < m_size);
+      return *element(i);
+    }
+
+    const T& operator[](std::size_t i) const
+    {
+      assert(i < m_size);
+      return *element(i);
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args)
+    {
+      reserve_one();
+      new (element(m_size)) T(std::forward<Args>(args)...);
+      m_size++;
+    }
+
+    void push_back(const T& x)
+    {
+      emplace_back(x);
+    }
+
+    void push_back(T&& x)
+    {
+      emplace_back(std::move(x));
+    }
+
+    void pop_front()
+    {
+      assert(!empty());
+      element(0)->~T();
+      m_first = (m_first + 1) & (m_storage.size() - 1);
+      m_size--;
+    }
+
+    void pop_back()
+    {
+      assert(!empty());
+      element(m_size - 1)->~T();
+      m_size--;
+    }
+
+    /// \brief Removes all elements. The storage is kept for later use.
+    void clear()
+    {
+      for (std::size_t i = 0; i < m_size; i++)
+      {
+        element(i)->~T();
+      }
+      m_first = 0;
+      m_size = 0;
+    }
+};
+
+} // namespace data
+
+} // namespace mcrl2
+
+#endif // MCRL2_DATA_ENUMERATOR_QUEUE_H
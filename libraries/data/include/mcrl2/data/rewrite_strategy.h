@@ -14,6 +14,7 @@ namespace data
 enum rewrite_strategy
 {
   jitty,                      /** \brief JITty */
+  jitty_bytecode,             /** \brief JITty using bytecode */
 #ifdef MCRL2_JITTYC_AVAILABLE
   jitty_compiling,            /** \brief Compiling JITty */
   jitty_prover,               /** \brief JITty + Prover */
@@ -29,6 +30,8 @@ rewrite_strategy parse_rewrite_strategy(const std::string& s)
 {
   if(s == "jitty")
     return jitty;
+  else if (s == "jittyb")
+    return jitty_bytecode;
   else if (s == "jittyp")
     return jitty_prover;
 
@@ -66,6 +69,7 @@ inline std::string pp(const rewrite_strategy s)
   switch (s)
   {
     case jitty: return "jitty";
+    case jitty_bytecode: return "jittyb";
 #ifdef MCRL2_JITTYC_AVAILABLE
     case jitty_compiling: return "jittyc";
 #endif
@@ -90,6 +94,7 @@ inline std::string description(const rewrite_strategy s)
   switch (s)
   {
     case jitty: return "jitty rewriting";
+    case jitty_bytecode: return "jitty rewriting using bytecode";
 #ifdef MCRL2_JITTYC_AVAILABLE
     case jitty_compiling: return "compiled jitty rewriting";
 #endif
@@ -87,6 +87,13 @@ class basic_rewriter
 
 class rewriter: public basic_rewriter<data_expression>
 {
+  protected:
+    /// \brief Constructor.
+    /// \param[in] r A rewriter
+    rewriter(const std::shared_ptr<detail::Rewriter>& r) :
+      basic_rewriter<data_expression>(r)
+    { }
+
   public:
     typedef basic_rewriter<data_expression>::substitution_type substitution_type;
 
@@ -113,6 +120,16 @@ class rewriter: public basic_rewriter<data_expression>
     {
     }
 
+    /// \brief Returns a rewriter with the same rewrite rules that does not share any internal
+    /// state with this rewriter, in contrast to a copy of it.
+    /// \details The rewrite rules are shared, so this is much cheaper than creating a new rewriter.
+    /// It can be used to give each thread of a parallel algorithm its own rewriter, together with
+    /// its own substitutions. Only the jitty and bytecode rewriters can be cloned.
+    rewriter clone() const
+    {
+      return rewriter(m_rewriter->clone());
+    }
+
     /// \brief Default specification used if no specification is specified at construction
     static data_specification& default_specification()
     {
@@ -13,9 +13,11 @@
 #define MCRL2_DATA_REWRITER_TOOL_H
 
 #include "mcrl2/data/detail/enumerator_variable_limit.h"
+#include "mcrl2/data/detail/rewrite_profile.h"
 #include "mcrl2/data/rewrite_strategy.h"
 #include "mcrl2/data/rewriter.h"
 #include "mcrl2/utilities/command_line_interface.h"
+#include "mcrl2/utilities/logger.h"
 
 namespace mcrl2
 {
@@ -34,6 +36,9 @@ class rewriter_tool: public Tool
     /// The data rewriter strategy
     data::rewrite_strategy m_rewrite_strategy;
 
+    /// The file to which a profile of the rewrite rules is written, if non-empty
+    std::string m_rewriter_profile_file;
+
     /// \brief Add options to an interface description. Also includes
     /// rewriter options.
     /// \param desc An interface description
@@ -44,6 +49,7 @@ class rewriter_tool: public Tool
       desc.add_option(
         "rewriter", utilities::make_enum_argument<data::rewrite_strategy>("NAME")
             .add_value(data::jitty, true)
+            .add_value(data::jitty_bytecode)
 #ifdef MCRL2_JITTYC_AVAILABLE
             .add_value(data::jitty_compiling)
 #endif
@@ -58,6 +64,15 @@ class rewriter_tool: public Tool
         'Q'
       );
 
+      desc.add_hidden_option(
+        "rewriter-profile", utilities::make_mandatory_argument("FILE"),
+        "write the number of attempts, the number of successes and the time of each rewrite rule to FILE"
+      );
+
+      desc.add_hidden_option(
+        "rewriter-rule-order", utilities::make_mandatory_argument("FILE"),
+        "try the rewrite rules in order of decreasing success rate in the profile FILE, that was written using --rewriter-profile"
+      );
     }
 
     /// \brief Parse non-standard options
@@ -72,6 +87,17 @@ class rewriter_tool: public Tool
         //Set enumerator limit for quantifier enumeration
         data::detail::set_enumerator_variable_limit(parser.option_argument_as< std::size_t >("qlimit"));
       }
+
+      if (parser.options.count("rewriter-profile"))
+      {
+        m_rewriter_profile_file = parser.option_argument("rewriter-profile");
+        data::detail::global_rewrite_profile().set_enabled(true);
+      }
+
+      if (parser.options.count("rewriter-rule-order"))
+      {
+        data::detail::global_rewrite_profile().read_report(parser.option_argument("rewriter-rule-order"));
+      }
     }
 
   public:
@@ -87,6 +113,22 @@ class rewriter_tool: public Tool
         m_rewrite_strategy(mcrl2::data::jitty)
     {}
 
+    /// \brief Destructor. Writes the profile of the rewrite rules, if it was requested.
+    ~rewriter_tool()
+    {
+      if (!m_rewriter_profile_file.empty())
+      {
+        try
+        {
+          data::detail::global_rewrite_profile().write_report(m_rewriter_profile_file);
+        }
+        catch (const mcrl2::runtime_error& e)
+        {
+          mCRL2log(log::warning) << e.what() << std::endl;
+        }
+      }
+    }
+
     /// \brief Returns the rewrite strategy
     /// \return The rewrite strategy
     data::rewrite_strategy rewrite_strategy() const
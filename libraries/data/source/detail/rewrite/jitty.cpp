@@ -27,9 +27,8 @@
 #include "mcrl2/data/substitutions/mutable_map_substitution.h"
 #include "mcrl2/data/replace.h"
 
-#ifdef MCRL2_DISPLAY_REWRITE_STATISTICS
+#include "mcrl2/data/detail/rewrite_profile.h"
 #include "mcrl2/data/detail/rewrite_statistics.h"
-#endif
 
 using namespace mcrl2::log;
 using namespace mcrl2::core;
@@ -43,41 +42,6 @@ namespace detail
 {
 
 
-typedef atermpp::detail::_aterm* unprotected_variable;           // Variable that is not protected (so a copy should exist at some other place)
-typedef atermpp::detail::_aterm* unprotected_data_expression;    // Idem, but now a data expression.
-
-struct jitty_variable_assignment_for_a_rewrite_rule
-{
-  unprotected_variable var;
-  unprotected_data_expression term;
-  bool variable_is_a_normal_form;
-};
-
-struct jitty_assignments_for_a_rewrite_rule
-{
-  std::size_t size;
-  jitty_variable_assignment_for_a_rewrite_rule* assignment;
-
-  jitty_assignments_for_a_rewrite_rule(jitty_variable_assignment_for_a_rewrite_rule* a)
-   : size(0),
-     assignment(a)
-  {}
-
-};
-
-
-// The function symbol below is used to administrate that a term is in normal form. It is put around a term.
-// Terms with this auxiliary function symbol cannot be printed using the pretty printer for data expressions.
-
-
-static const function_symbol& this_term_is_in_normal_form()
-{
-  static const function_symbol this_term_is_in_normal_form(
-                         std::string("Rewritten@@term"),
-                         function_sort({ untyped_sort() },untyped_sort()));
-  return this_term_is_in_normal_form;
-}
-
 // The function below is intended to remove the auxiliary function this_term_is_in_normal_form from a term
 // such that it can for instance be pretty printed.
 
@@ -280,6 +244,17 @@ strategy RewriterJitty::create_strategy(const data_equation_list& rules1)
       }
     }
 
+    // If a profile of a previous run is available, the rules that become applicable at the same
+    // point in the strategy are tried in the order of decreasing success rate.
+    const rewrite_profile& profile = global_rewrite_profile();
+    if (profile.has_rule_order())
+    {
+      std::stable_sort(m.begin(), m.end(), [&](const dependencies_rewrite_rule_pair& x, const dependencies_rewrite_rule_pair& y)
+      {
+        return profile.rule_order(x.equation()) < profile.rule_order(y.equation());
+      });
+    }
+
     while (!m.empty())
     {
       std::vector<dependencies_rewrite_rule_pair> m2;
@@ -350,24 +325,19 @@ strategy RewriterJitty::create_strategy(const data_equation_list& rules1)
   return strategy(max_number_of_variables,atermpp::term_list<data::detail::strategy_rule>(strat.begin(),strat.end()));   
 }
 
-void RewriterJitty::make_jitty_strat_sufficiently_larger(const std::size_t i)
-{
-  if (i>=jitty_strat.size())
-  {
-    jitty_strat.resize(i+1);
-  }
-}
-
-void RewriterJitty::rebuild_strategy()
+void RewriterJitty::rebuild_strategy(const std::map< function_symbol, data_equation_list >& jitty_eqns)
 {
-  jitty_strat.clear();
+  std::vector<strategy> strategies;
   for(std::map< function_symbol, data_equation_list >::const_iterator l=jitty_eqns.begin(); l!=jitty_eqns.end(); ++l)
   {
     const std::size_t i=core::index_traits<data::function_symbol, function_symbol_key_type, 2>::index(l->first);
-    make_jitty_strat_sufficiently_larger(i);
-    jitty_strat[i] = create_strategy(reverse(l->second));
+    if (i>=strategies.size())
+    {
+      strategies.resize(i+1);
+    }
+    strategies[i] = create_strategy(reverse(l->second));
   }
-
+  jitty_strat = std::make_shared<const std::vector<strategy> >(std::move(strategies));
 }
 
 RewriterJitty::RewriterJitty(
@@ -376,7 +346,9 @@ RewriterJitty::RewriterJitty(
         Rewriter(data_spec,equation_selector)
 {
   MAX_LEN=0;
+  m_profiling=global_rewrite_profile().enabled();
 
+  std::map< function_symbol, data_equation_list > jitty_eqns;
   for (const data_equation& eq: data_spec.equations())
   {
     if (equation_selector(eq))
@@ -404,14 +376,22 @@ RewriterJitty::RewriterJitty(
     }
   }
 
-  rebuild_strategy();
+  rebuild_strategy(jitty_eqns);
+}
+
+RewriterJitty::RewriterJitty(const RewriterJitty& other)
+  : Rewriter(other.m_data_specification_for_enumeration, other.data_equation_selector),
+    jitty_strat(other.jitty_strat),
+    MAX_LEN(other.MAX_LEN),
+    m_profiling(other.m_profiling)
+{
 }
 
 RewriterJitty::~RewriterJitty()
 {
 }
 
-static data_expression subst_values(
+data_expression subst_values(
             const jitty_assignments_for_a_rewrite_rule& assignments,
             const data_expression& t,
             data::enumerator_identifier_generator& generator) // This generator is used for the generation of fresh variable names.
@@ -690,8 +670,7 @@ data_expression RewriterJitty::rewrite_aux_function_symbol(
   }
 
   const std::size_t op_value=core::index_traits<data::function_symbol,function_symbol_key_type, 2>::index(op);
-  make_jitty_strat_sufficiently_larger(op_value);
-  const strategy& strat=jitty_strat[op_value];
+  const strategy& strat=get_strategy(op_value);
 
   if (!strat.rules.empty())
   {
@@ -730,6 +709,12 @@ data_expression RewriterJitty::rewrite_aux_function_symbol(
 
         assert(assignments.size==0);
 
+        std::chrono::steady_clock::time_point start;
+        if (m_profiling)
+        {
+          start=std::chrono::steady_clock::now();
+        }
+
         bool matches = true;
         for (std::size_t i=0; i<rule_arity; i++)
         {
@@ -747,6 +732,10 @@ data_expression RewriterJitty::rewrite_aux_function_symbol(
           if (rule1.condition()==sort_bool::true_() || rewrite_aux(
                    subst_values(assignments,rule1.condition(),m_generator),sigma)==sort_bool::true_())
           {
+            if (m_profiling)
+            {
+              global_rewrite_profile().add(rule1,true,std::chrono::steady_clock::now()-start);
+            }
             const data_expression& rhs=rule1.rhs();
 
             if (arity == rule_arity)
@@ -805,6 +794,10 @@ data_expression RewriterJitty::rewrite_aux_function_symbol(
             }
           }
         }
+        if (m_profiling)
+        {
+          global_rewrite_profile().add(rule1,false,std::chrono::steady_clock::now()-start);
+        }
         assignments.size=0;
       }
     }
@@ -850,8 +843,7 @@ data_expression RewriterJitty::rewrite_aux_const_function_symbol(
   // e.g., it can be a function symbol f for which a rewrite rule f(n)=... exists. 
 
   const std::size_t op_value=core::index_traits<data::function_symbol,function_symbol_key_type, 2>::index(op);
-  make_jitty_strat_sufficiently_larger(op_value);
-  const strategy& strat=jitty_strat[op_value];
+  const strategy& strat=get_strategy(op_value);
 
   for (const strategy_rule& rule: strat.rules)
   {
@@ -870,7 +862,17 @@ data_expression RewriterJitty::rewrite_aux_const_function_symbol(
         break;
       }
 
-      if (rule1.condition()==sort_bool::true_() || rewrite_aux(rule1.condition(),sigma)==sort_bool::true_())
+      std::chrono::steady_clock::time_point start;
+      if (m_profiling)
+      {
+        start=std::chrono::steady_clock::now();
+      }
+      const bool success=rule1.condition()==sort_bool::true_() || rewrite_aux(rule1.condition(),sigma)==sort_bool::true_();
+      if (m_profiling)
+      {
+        global_rewrite_profile().add(rule1,success,std::chrono::steady_clock::now()-start);
+      }
+      if (success)
       {
         return rewrite_aux(rule1.rhs(),sigma);
       }
@@ -885,9 +887,7 @@ data_expression RewriterJitty::rewrite(
      const data_expression& term,
      substitution_type& sigma)
 {
-#ifdef MCRL2_DISPLAY_REWRITE_STATISTICS
   data::detail::increment_rewrite_count();
-#endif
   const data_expression& t=rewrite_aux(term, sigma);
   assert(remove_normal_form_function(t)==t);
   return t;
@@ -897,6 +897,11 @@ rewrite_strategy RewriterJitty::getStrategy()
 {
   return jitty;
 }
+
+std::shared_ptr<Rewriter> RewriterJitty::clone()
+{
+  return std::shared_ptr<Rewriter>(new RewriterJitty(*this));
+}
 }
 }
 }
@@ -0,0 +1,664 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file jitty_bytecode.cpp
+
+#include "mcrl2/data/detail/rewrite/jitty_bytecode.h"
+#include "mcrl2/data/detail/rewrite/jitty_jittyc.h"
+
+#include <map>
+#include "mcrl2/utilities/detail/memory_utility.h"
+#include "mcrl2/data/detail/rewrite_profile.h"
+#include "mcrl2/data/detail/rewrite_statistics.h"
+
+namespace mcrl2
+{
+namespace data
+{
+namespace detail
+{
+
+// The instructions of the bytecode. The operands of an instruction follow its opcode.
+enum bytecode_opcode: std::size_t
+{
+  // Match code.
+  REWRITE_ARGUMENT,   // i: rewrite argument i to normal form, or stop if there is no argument i
+  RULE,               // rule arity, fail address, e: start matching the rewrite rule equations[e], or stop if the arity is too large
+  LOAD_ARGUMENT,      // i: make argument i the current term
+  MATCH_FUNCTION,     // c: check that the current term equals the function symbol constants[c]
+  BIND_VARIABLE,      // slot, c: bind the variable constants[c] to the current term
+  CHECK_VARIABLE,     // slot: check that the current term equals the term bound to slot
+  MATCH_APPLICATION,  // n: check that the current term is an application with n arguments, and push it
+  LOAD_CHILD,         // k: make the head (k = 0) or argument k-1 of the topmost application the current term
+  POP,                // pop the topmost application
+  CONDITION,          // build address: check that the instance of the condition rewrites to true
+  RIGHT_HAND_SIDE,    // build address: rewrite the instance of the right hand side
+  END,                // stop; no rewrite rule is applicable
+
+  // Build code.
+  PUSH_CONSTANT,      // c: push constants[c]
+  PUSH_VARIABLE,      // slot: push the term bound to slot
+  PUSH_SUBSTITUTED,   // c, n: push constants[c] with the first n slots substituted
+  BUILD_APPLICATION,  // n: replace the n+1 topmost terms by an application
+  RETURN              // the topmost term is the result
+};
+
+class bytecode_compiler
+{
+  protected:
+    bytecode_program& m_program;
+    std::map<data_expression, std::size_t> m_constant_index;
+    std::map<variable, std::size_t> m_slots;
+
+    std::size_t constant(const data_expression& t)
+    {
+      auto i = m_constant_index.find(t);
+      if (i != m_constant_index.end())
+      {
+        return i->second;
+      }
+      m_program.constants.push_back(t);
+      m_constant_index[t] = m_program.constants.size() - 1;
+      return m_program.constants.size() - 1;
+    }
+
+    void emit(std::size_t opcode)
+    {
+      m_program.match_code.push_back(opcode);
+    }
+
+    void emit(std::size_t opcode, std::size_t operand)
+    {
+      m_program.match_code.push_back(opcode);
+      m_program.match_code.push_back(operand);
+    }
+
+    void compile_pattern(const data_expression& p, std::size_t depth)
+    {
+      if (is_function_symbol(p))
+      {
+        emit(MATCH_FUNCTION, constant(p));
+      }
+      else if (is_variable(p))
+      {
+        const variable& v = atermpp::down_cast<variable>(p);
+        auto i = m_slots.find(v);
+        if (i != m_slots.end())
+        {
+          emit(CHECK_VARIABLE, i->second);
+        }
+        else
+        {
+          std::size_t slot = m_slots.size();
+          m_slots[v] = slot;
+          emit(BIND_VARIABLE, slot);
+          m_program.match_code.push_back(constant(v));
+        }
+      }
+      else
+      {
+        const application& pa = atermpp::down_cast<application>(p);
+        m_program.max_depth = std::max(m_program.max_depth, depth + 1);
+        emit(MATCH_APPLICATION, pa.size());
+        emit(LOAD_CHILD, 0);
+        compile_pattern(pa.head(), depth + 1);
+        for (std::size_t k = 0; k < pa.size(); k++)
+        {
+          emit(LOAD_CHILD, k + 1);
+          compile_pattern(pa[k], depth + 1);
+        }
+        emit(POP);
+      }
+    }
+
+    // Returns true if t contains neither variables of the left hand side, nor binders.
+    bool is_closed(const data_expression& t) const
+    {
+      if (is_function_symbol(t))
+      {
+        return true;
+      }
+      if (is_variable(t))
+      {
+        return m_slots.count(atermpp::down_cast<variable>(t)) == 0;
+      }
+      if (is_application(t))
+      {
+        const application& ta = atermpp::down_cast<application>(t);
+        if (!is_closed(ta.head()))
+        {
+          return false;
+        }
+        for (const data_expression& x: ta)
+        {
+          if (!is_closed(x))
+          {
+            return false;
+          }
+        }
+        return true;
+      }
+      return false;
+    }
+
+    void compile_build(const data_expression& t)
+    {
+      std::vector<std::size_t>& code = m_program.build_code;
+      if (is_closed(t))
+      {
+        code.push_back(PUSH_CONSTANT);
+        code.push_back(constant(t));
+      }
+      else if (is_variable(t))
+      {
+        code.push_back(PUSH_VARIABLE);
+        code.push_back(m_slots[atermpp::down_cast<variable>(t)]);
+      }
+      else if (is_application(t))
+      {
+        const application& ta = atermpp::down_cast<application>(t);
+        compile_build(ta.head());
+        for (const data_expression& x: ta)
+        {
+          compile_build(x);
+        }
+        code.push_back(BUILD_APPLICATION);
+        code.push_back(ta.size());
+      }
+      else
+      {
+        // Abstractions and where clauses are substituted in the same way as in the jitty rewriter.
+        code.push_back(PUSH_SUBSTITUTED);
+        code.push_back(constant(t));
+        code.push_back(m_slots.size());
+      }
+    }
+
+    std::size_t compile_term(const data_expression& t)
+    {
+      std::size_t address = m_program.build_code.size();
+      compile_build(t);
+      m_program.build_code.push_back(RETURN);
+      return address;
+    }
+
+    void compile_rule(const data_equation& eq)
+    {
+      m_slots.clear();
+      const data_expression& lhs = eq.lhs();
+      std::size_t rule_arity = is_function_symbol(lhs) ? 0 : recursive_number_of_args(lhs);
+      emit(RULE, rule_arity);
+      std::size_t fail_address = m_program.match_code.size();
+      m_program.match_code.push_back(0);
+      m_program.match_code.push_back(m_program.equations.size());
+      m_program.equations.push_back(eq);
+      for (std::size_t i = 0; i < rule_arity; i++)
+      {
+        emit(LOAD_ARGUMENT, i);
+        compile_pattern(get_argument_of_higher_order_term(atermpp::down_cast<application>(lhs), i), 0);
+      }
+      if (eq.condition() != sort_bool::true_())
+      {
+        emit(CONDITION, compile_term(eq.condition()));
+      }
+      emit(RIGHT_HAND_SIDE, compile_term(eq.rhs()));
+      m_program.number_of_variables = std::max(m_program.number_of_variables, m_slots.size());
+      m_program.match_code[fail_address] = m_program.match_code.size();
+    }
+
+  public:
+    bytecode_compiler(bytecode_program& program)
+      : m_program(program)
+    {}
+
+    void compile(const strategy& strat)
+    {
+      for (const strategy_rule& rule: strat.rules)
+      {
+        if (rule.is_rewrite_index())
+        {
+          emit(REWRITE_ARGUMENT, rule.rewrite_index());
+        }
+        else
+        {
+          compile_rule(rule.equation());
+        }
+      }
+      emit(END);
+    }
+};
+
+RewriterJittyBytecode::RewriterJittyBytecode(
+           const data_specification& data_spec,
+           const used_data_equation_selector& equation_selector)
+  : RewriterJitty(data_spec, equation_selector)
+{
+  compile_strategies();
+}
+
+RewriterJittyBytecode::RewriterJittyBytecode(const RewriterJittyBytecode& other)
+  : RewriterJitty(other),
+    m_programs(other.m_programs)
+{
+}
+
+void RewriterJittyBytecode::compile_strategies()
+{
+  const std::vector<strategy>& strategies = *jitty_strat;
+  std::vector<bytecode_program> programs(strategies.size());
+  for (std::size_t i = 0; i < strategies.size(); i++)
+  {
+    if (!strategies[i].rules.empty())
+    {
+      bytecode_compiler(programs[i]).compile(strategies[i]);
+    }
+  }
+  m_programs = std::make_shared<const std::vector<bytecode_program> >(std::move(programs));
+}
+
+// Executes the build code of program at the given address, with the variables bound as in bindings.
+static data_expression build_term(const bytecode_program& program,
+                                  std::size_t address,
+                                  const jitty_variable_assignment_for_a_rewrite_rule* bindings,
+                                  std::vector<data_expression>& stack,
+                                  data::enumerator_identifier_generator& generator)
+{
+  const std::size_t* code = program.build_code.data();
+  for (std::size_t pc = address; ; )
+  {
+    switch (code[pc])
+    {
+      case PUSH_CONSTANT:
+      {
+        stack.push_back(program.constants[code[pc + 1]]);
+        pc += 2;
+        break;
+      }
+      case PUSH_VARIABLE:
+      {
+        const jitty_variable_assignment_for_a_rewrite_rule& b = bindings[code[pc + 1]];
+        const data_expression t = atermpp::down_cast<data_expression>(atermpp::aterm(b.term));
+        if (b.variable_is_a_normal_form)
+        {
+          stack.push_back(application(this_term_is_in_normal_form(), t));
+        }
+        else
+        {
+          stack.push_back(t);
+        }
+        pc += 2;
+        break;
+      }
+      case PUSH_SUBSTITUTED:
+      {
+        jitty_assignments_for_a_rewrite_rule assignments(const_cast<jitty_variable_assignment_for_a_rewrite_rule*>(bindings));
+        assignments.size = code[pc + 2];
+        stack.push_back(subst_values(assignments, program.constants[code[pc + 1]], generator));
+        pc += 3;
+        break;
+      }
+      case BUILD_APPLICATION:
+      {
+        const std::size_t n = code[pc + 1];
+        const std::size_t head = stack.size() - n - 1;
+        const data_expression result = application(stack[head], stack.begin() + head + 1, stack.end());
+        stack.resize(head + 1);
+        stack.back() = result;
+        pc += 2;
+        break;
+      }
+      default:
+      {
+        assert(code[pc] == RETURN);
+        data_expression result = stack.back();
+        stack.pop_back();
+        return result;
+      }
+    }
+  }
+}
+
+data_expression RewriterJittyBytecode::rewrite_aux(
+                      const data_expression& term,
+                      substitution_type& sigma)
+{
+  // This function is the same as RewriterJitty::rewrite_aux, except that it calls the
+  // bytecode interpreter for terms with a function symbol as head.
+  if (is_application(term))
+  {
+    const application& terma = atermpp::down_cast<application>(term);
+    if (terma.head() == this_term_is_in_normal_form())
+    {
+      assert(terma.size() == 1);
+      return terma[0];
+    }
+
+    const data_expression& head = get_nested_head(term);
+    if (is_function_symbol(head) && head != this_term_is_in_normal_form())
+    {
+      return rewrite_aux_function_symbol(atermpp::down_cast<function_symbol>(head), term, sigma);
+    }
+
+    const data_expression t = rewrite_aux(terma.head(), sigma);
+    const data_expression& head1 = get_nested_head(t);
+    if (is_function_symbol(head1))
+    {
+      const data_expression result = application(t, terma.begin(), terma.end());
+      return rewrite_aux_function_symbol(atermpp::down_cast<function_symbol>(head1), result, sigma);
+    }
+    else if (is_variable(head1))
+    {
+      return application(t, terma.begin(), terma.end(), [&](const data_expression& x) { return rewrite_aux(x, sigma); });
+    }
+    assert(is_abstraction(t));
+    const abstraction& ta = atermpp::down_cast<abstraction>(t);
+    const binder_type& binder(ta.binding_operator());
+    if (is_lambda_binder(binder))
+    {
+      return rewrite_lambda_application(ta, terma, sigma);
+    }
+    if (is_exists_binder(binder))
+    {
+      return existential_quantifier_enumeration(ta, sigma);
+    }
+    assert(is_forall_binder(binder));
+    return universal_quantifier_enumeration(ta, sigma);
+  }
+  if (is_function_symbol(term))
+  {
+    return rewrite_aux_function_symbol(atermpp::down_cast<function_symbol>(term), term, sigma);
+  }
+  if (is_variable(term))
+  {
+    return sigma(atermpp::down_cast<variable>(term));
+  }
+  if (is_where_clause(term))
+  {
+    return rewrite_where(atermpp::down_cast<where_clause>(term), sigma);
+  }
+
+  assert(is_abstraction(term));
+  const abstraction& ta = atermpp::down_cast<abstraction>(term);
+  if (is_exists(ta))
+  {
+    return existential_quantifier_enumeration(ta, sigma);
+  }
+  if (is_forall(ta))
+  {
+    return universal_quantifier_enumeration(ta, sigma);
+  }
+  assert(is_lambda(ta));
+  return rewrite_single_lambda(ta.variables(), ta.body(), false, sigma);
+}
+
+data_expression RewriterJittyBytecode::rewrite_aux_function_symbol(
+                      const function_symbol& op,
+                      const data_expression& term,
+                      substitution_type& sigma)
+{
+  const std::size_t arity = is_function_symbol(term) ? 0 : recursive_number_of_args(term);
+
+  data_expression* rewritten = MCRL2_SPECIFIC_STACK_ALLOCATOR(data_expression, arity);
+  bool* rewritten_defined = MCRL2_SPECIFIC_STACK_ALLOCATOR(bool, arity);
+  for (std::size_t i = 0; i < arity; ++i)
+  {
+    rewritten_defined[i] = false;
+  }
+
+  auto argument = [&](std::size_t i) -> const data_expression&
+  {
+    return get_argument_of_higher_order_term(atermpp::down_cast<application>(term), i);
+  };
+
+  auto destroy_rewritten = [&]()
+  {
+    for (std::size_t i = 0; i < arity; ++i)
+    {
+      if (rewritten_defined[i])
+      {
+        rewritten[i].~data_expression();
+      }
+    }
+  };
+
+  const std::size_t op_value = core::index_traits<data::function_symbol, function_symbol_key_type, 2>::index(op);
+  const std::vector<bytecode_program>& programs = *m_programs;
+  if (op_value < programs.size() && !programs[op_value].match_code.empty())
+  {
+    const bytecode_program& program = programs[op_value];
+    const std::size_t* code = program.match_code.data();
+    jitty_variable_assignment_for_a_rewrite_rule* bindings =
+      MCRL2_SPECIFIC_STACK_ALLOCATOR(jitty_variable_assignment_for_a_rewrite_rule, program.number_of_variables);
+    const application** stack = MCRL2_SPECIFIC_STACK_ALLOCATOR(const application*, program.max_depth);
+    std::size_t top = 0;
+    const data_expression* current = nullptr;
+    bool current_is_normal_form = false;
+    std::size_t rule_arity = 0;
+    std::size_t fail_address = 0;
+
+    // The rule that is being matched, which is only maintained when profiling.
+    std::size_t current_rule = atermpp::npos;
+    std::chrono::steady_clock::time_point start;
+    auto finish_rule = [&](bool success)
+    {
+      if (current_rule != atermpp::npos)
+      {
+        global_rewrite_profile().add(program.equations[current_rule], success, std::chrono::steady_clock::now() - start);
+        current_rule = atermpp::npos;
+      }
+    };
+
+    for (std::size_t pc = 0; code[pc] != END; )
+    {
+      switch (code[pc])
+      {
+        case REWRITE_ARGUMENT:
+        {
+          if (m_profiling)
+          {
+            finish_rule(false);
+          }
+          const std::size_t i = code[pc + 1];
+          if (i >= arity)
+          {
+            pc = program.match_code.size() - 1;
+            break;
+          }
+          if (!rewritten_defined[i])
+          {
+            new (&rewritten[i]) data_expression(rewrite_aux(argument(i), sigma));
+            rewritten_defined[i] = true;
+          }
+          pc += 2;
+          break;
+        }
+        case RULE:
+        {
+          if (m_profiling)
+          {
+            finish_rule(false);
+          }
+          rule_arity = code[pc + 1];
+          if (rule_arity > arity)
+          {
+            pc = program.match_code.size() - 1;
+            break;
+          }
+          fail_address = code[pc + 2];
+          top = 0;
+          if (m_profiling)
+          {
+            current_rule = code[pc + 3];
+            start = std::chrono::steady_clock::now();
+          }
+          pc += 4;
+          break;
+        }
+        case LOAD_ARGUMENT:
+        {
+          const std::size_t i = code[pc + 1];
+          current = rewritten_defined[i] ? &rewritten[i] : &argument(i);
+          current_is_normal_form = rewritten_defined[i];
+          pc += 2;
+          break;
+        }
+        case MATCH_FUNCTION:
+        {
+          pc = (*current == program.constants[code[pc + 1]]) ? pc + 2 : fail_address;
+          break;
+        }
+        case BIND_VARIABLE:
+        {
+          jitty_variable_assignment_for_a_rewrite_rule& b = bindings[code[pc + 1]];
+          b.var = atermpp::detail::address(program.constants[code[pc + 2]]);
+          b.term = atermpp::detail::address(*current);
+          b.variable_is_a_normal_form = current_is_normal_form;
+          pc += 3;
+          break;
+        }
+        case CHECK_VARIABLE:
+        {
+          pc = (atermpp::detail::address(*current) == bindings[code[pc + 1]].term) ? pc + 2 : fail_address;
+          break;
+        }
+        case MATCH_APPLICATION:
+        {
+          if (is_application(*current) && atermpp::down_cast<application>(*current).size() == code[pc + 1])
+          {
+            stack[top++] = &atermpp::down_cast<application>(*current);
+            pc += 2;
+          }
+          else
+          {
+            pc = fail_address;
+          }
+          break;
+        }
+        case LOAD_CHILD:
+        {
+          const application& a = *stack[top - 1];
+          const std::size_t k = code[pc + 1];
+          current = (k == 0) ? &a.head() : &a[k - 1];
+          current_is_normal_form = true;
+          pc += 2;
+          break;
+        }
+        case POP:
+        {
+          top--;
+          pc += 1;
+          break;
+        }
+        case CONDITION:
+        {
+          const data_expression condition = build_term(program, code[pc + 1], bindings, m_build_stack, m_generator);
+          pc = (rewrite_aux(condition, sigma) == sort_bool::true_()) ? pc + 2 : fail_address;
+          break;
+        }
+        default:
+        {
+          assert(code[pc] == RIGHT_HAND_SIDE);
+          if (m_profiling)
+          {
+            finish_rule(true);
+          }
+          data_expression result = build_term(program, code[pc + 1], bindings, m_build_stack, m_generator);
+          if (arity == rule_arity)
+          {
+            destroy_rewritten();
+            return rewrite_aux(result, sigma);
+          }
+
+          // There are more arguments than those that have been matched. Apply the
+          // result to the remaining arguments.
+          for (std::size_t i = rule_arity; i < arity; ++i)
+          {
+            if (rewritten_defined[i])
+            {
+              rewritten[i] = argument(i);
+            }
+            else
+            {
+              new (&rewritten[i]) data_expression(argument(i));
+              rewritten_defined[i] = true;
+            }
+          }
+          std::size_t i = rule_arity;
+          sort_expression sort = detail::residual_sort(op.sort(), i);
+          while (is_function_sort(sort) && (i < arity))
+          {
+            const function_sort& fsort = atermpp::down_cast<function_sort>(sort);
+            const std::size_t end = i + fsort.domain().size();
+            assert(end - 1 < arity);
+            result = application(result, &rewritten[0] + i, &rewritten[0] + end);
+            i = end;
+            sort = fsort.codomain();
+          }
+          destroy_rewritten();
+          return rewrite_aux(result, sigma);
+        }
+      }
+    }
+    if (m_profiling)
+    {
+      finish_rule(false);
+    }
+  }
+
+  // No rewrite rule is applicable. Rewrite the arguments that are not yet rewritten.
+  for (std::size_t i = 0; i < arity; i++)
+  {
+    if (!rewritten_defined[i])
+    {
+      new (&rewritten[i]) data_expression(rewrite_aux(argument(i), sigma));
+    }
+  }
+
+  data_expression result = op;
+  std::size_t i = 0;
+  sort_expression sort = op.sort();
+  while (is_function_sort(sort) && (i < arity))
+  {
+    const function_sort& fsort = atermpp::down_cast<function_sort>(sort);
+    const std::size_t end = i + fsort.domain().size();
+    assert(end - 1 < arity);
+    result = application(result, &rewritten[0] + i, &rewritten[0] + end);
+    i = end;
+    sort = fsort.codomain();
+  }
+
+  for (std::size_t i = 0; i < arity; i++)
+  {
+    rewritten[i].~data_expression();
+  }
+  return result;
+}
+
+data_expression RewriterJittyBytecode::rewrite(
+     const data_expression& term,
+     substitution_type& sigma)
+{
+  data::detail::increment_rewrite_count();
+  const data_expression t = rewrite_aux(term, sigma);
+  assert(remove_normal_form_function(t) == t);
+  return t;
+}
+
+rewrite_strategy RewriterJittyBytecode::getStrategy()
+{
+  return jitty_bytecode;
+}
+
+std::shared_ptr<Rewriter> RewriterJittyBytecode::clone()
+{
+  return std::shared_ptr<Rewriter>(new RewriterJittyBytecode(*this));
+}
+
+} // namespace detail
+} // namespace data
+} // namespace mcrl2
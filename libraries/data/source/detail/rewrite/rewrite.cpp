@@ -20,6 +20,7 @@
 #include "mcrl2/data/data_specification.h"
 #include "mcrl2/data/detail/rewrite.h"
 #include "mcrl2/data/detail/rewrite/jitty.h"
+#include "mcrl2/data/detail/rewrite/jitty_bytecode.h"
 #include "mcrl2/data/detail/rewrite/jitty_jittyc.h"
 #ifdef MCRL2_JITTYC_AVAILABLE
 #include "mcrl2/data/detail/rewrite/jittyc.h"
@@ -466,6 +467,11 @@ data_expression Rewriter::quantifier_enumeration(
 }
 
 
+std::shared_ptr<Rewriter> Rewriter::clone()
+{
+  throw mcrl2::runtime_error("The rewriter with strategy " + pp(getStrategy()) + " cannot be cloned.");
+}
+
 std::shared_ptr<Rewriter> createRewriter(
             const data_specification& data_spec,
             const used_data_equation_selector& equations_selector,
@@ -475,6 +481,8 @@ std::shared_ptr<Rewriter> createRewriter(
   {
     case jitty:
       return std::shared_ptr<Rewriter>(new RewriterJitty(data_spec,equations_selector));
+    case jitty_bytecode:
+      return std::shared_ptr<Rewriter>(new RewriterJittyBytecode(data_spec,equations_selector));
 #ifdef MCRL2_JITTYC_AVAILABLE
     case jitty_compiling:
       return std::shared_ptr<Rewriter>(new RewriterCompilingJitty(data_spec,equations_selector));
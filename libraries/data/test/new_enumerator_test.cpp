@@ -155,6 +155,40 @@ BOOST_AUTO_TEST_CASE(structured_sort_test)
   enumerate(dataspec_text, variable_text, expression_text, free_variable_text, number_of_solutions, more_solutions_possible);
 }
 
+// Enumerates the solutions of the same condition twice with one enumerator, such that the second
+// enumeration uses the cached elements of the finite sorts.
+BOOST_AUTO_TEST_CASE(finite_domain_test)
+{
+  typedef enumerator_list_element_with_substitution<> enumerator_element;
+  typedef enumerator_algorithm_with_iterator<> enumerator_type;
+
+  data_specification dataspec = parse_data_specification(
+    "sort D = struct d1(E, E) | d2; \n"
+    "     E = struct e1 | e2 | e3;  \n"
+    );
+  variable_list variables = parse_variable_list("d: D; b: Bool;", dataspec);
+  data_expression expression = parse_data_expression("d != d2 || b", variables, dataspec);
+
+  data::enumerator_identifier_generator id_generator;
+  rewriter rewr(dataspec);
+  enumerator_type enumerator(rewr, dataspec, rewr, id_generator);
+  for (int k = 0; k < 2; k++)
+  {
+    id_generator.clear();
+    mutable_indexed_substitution<> sigma;
+    std::deque<enumerator_element> P(1, enumerator_element(variables, expression));
+    std::set<data_expression> solutions;
+    for (auto i = enumerator.begin(sigma, P); i != enumerator.end(); ++i)
+    {
+      mutable_map_substitution<> rho;
+      i->add_assignments(variables, rho, rewr);
+      BOOST_CHECK(rewr(replace_variables(expression, rho)) == sort_bool::true_());
+      solutions.insert(replace_variables(expression, rho));
+    }
+    BOOST_CHECK_EQUAL(solutions.size(), 19u);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(equality_substitution_test)
 {
   std::string dataspec_text = "sort L = Nat;";
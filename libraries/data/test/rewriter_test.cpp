@@ -12,6 +12,7 @@
 #include "mcrl2/data/detail/data_functional.h"
 #include "mcrl2/data/detail/one_point_rule_preprocessor.h"
 #include "mcrl2/data/detail/parse_substitution.h"
+#include "mcrl2/data/detail/rewrite_profile.h"
 #include "mcrl2/data/detail/test_rewriters.h"
 #include "mcrl2/data/find.h"
 #include "mcrl2/data/function_sort.h"
@@ -250,6 +251,76 @@ void test_enumeration_of_functions()
   test_expressions(R, expr1, expr2, "", data_spec, sigma);
 }
 
+void test_rewrite_profile(rewrite_strategy strategy)
+{
+  std::string DATA_SPEC1 =
+    "sort D = struct d1 | d2;\n"
+    "map  f: D -> Bool;\n"
+    "eqn  f(d1) = true;\n"
+    "     f(d2) = false;\n"
+    ;
+  data_specification data_spec = parse_data_specification(DATA_SPEC1);
+
+  rewrite_profile& profile = global_rewrite_profile();
+  profile.set_enabled(true);
+  data::rewriter R(data_spec, strategy);
+  profile.set_enabled(false);
+
+  BOOST_CHECK(R(parse_data_expression("f(d1)", data_spec)) == sort_bool::true_());
+  BOOST_CHECK(R(parse_data_expression("f(d2)", data_spec)) == sort_bool::false_());
+
+  data_equation eq1;
+  data_equation eq2;
+  for (const data_equation& eq: data_spec.equations())
+  {
+    if (eq.lhs() == parse_data_expression("f(d1)", data_spec))
+    {
+      eq1 = eq;
+    }
+    else if (eq.lhs() == parse_data_expression("f(d2)", data_spec))
+    {
+      eq2 = eq;
+    }
+  }
+  BOOST_CHECK(profile.profiles().at(eq1).successes >= 1);
+  BOOST_CHECK(profile.profiles().at(eq2).successes >= 1);
+
+  // Read back the report, and check that the rules are ordered by their success rate
+  std::ostringstream out;
+  profile.write_report(out);
+  std::istringstream in(out.str());
+  rewrite_profile order;
+  order.read_report(in);
+  BOOST_CHECK(order.has_rule_order());
+  BOOST_CHECK(order.rule_order(eq1) < 0.0);
+  BOOST_CHECK(order.rule_order(data_equation()) == 1.0);
+}
+
+void test_clone(rewrite_strategy strategy)
+{
+  std::string DATA_SPEC1 =
+    "map  fib: Nat -> Nat;\n"
+    "var  n: Nat;\n"
+    "eqn  fib(0) = 0;\n"
+    "     fib(1) = 1;\n"
+    "     n > 1 -> fib(n) = fib(Int2Nat(n - 1)) + fib(Int2Nat(n - 2));\n"
+    ;
+  data_specification data_spec = parse_data_specification(DATA_SPEC1);
+  std::shared_ptr<data::rewriter> R(new data::rewriter(data_spec, strategy));
+  data::rewriter R1 = R->clone();
+  data::rewriter R2 = R1.clone();
+
+  // The clones can still be used when the original rewriter has been destroyed.
+  R.reset();
+  data_expression x = parse_data_expression("fib(15)", data_spec);
+  BOOST_CHECK(R1(x) == sort_nat::nat(610));
+  BOOST_CHECK(R2(x) == sort_nat::nat(610));
+
+  // A function symbol that did not exist when the rewriter was created has no rewrite rules.
+  data_expression y = application(function_symbol("g", function_sort({ sort_nat::nat() }, sort_nat::nat())), x);
+  BOOST_CHECK(R1(y) == application(atermpp::down_cast<application>(y).head(), sort_nat::nat(610)));
+}
+
 int test_main(int argc, char** argv)
 {
   test1();
@@ -261,6 +332,10 @@ int test_main(int argc, char** argv)
   test_lambda_expression();
   test_equality_on_functions();
   test_enumeration_of_functions();
+  test_rewrite_profile(jitty);
+  test_rewrite_profile(jitty_bytecode);
+  test_clone(jitty);
+  test_clone(jitty_bytecode);
 
   return 0;
 }
@@ -0,0 +1,72 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file next_state_generator.cpp
+/// \brief Benchmark for the cost per state of the next state generator. The rewrite strategy is
+///        passed as the first argument. If the second argument is "caching", enumeration caching is used.
+
+#include <chrono>
+#include <iostream>
+#include "mcrl2/atermpp/indexed_set.h"
+#include "mcrl2/lps/next_state_generator.h"
+#include "mcrl2/lps/parse.h"
+#include "mcrl2/utilities/benchmark.h"
+
+using namespace mcrl2;
+
+// A process with 2 * 21^3 reachable states, which contains both plain updates and a summand with a sum operator.
+const std::string SPECIFICATION =
+  "act a, b, c;                                                  \n"
+  "    d: Nat;                                                   \n"
+  "proc P(x, y, z: Nat, e: Bool) =                               \n"
+  "       (x < 20) -> a . P(x = x + 1)                           \n"
+  "     + (y < 20) -> b . P(y = y + 1)                           \n"
+  "     + (z < 20) -> c . P(z = z + 1)                           \n"
+  "     + sum n: Nat . (n < 3 && n <= x) -> d(n) . P(x = Int2Nat(x - n), e = !e) \n"
+  "     + delta;                                                 \n"
+  "init P(0, 0, 0, true);                                        \n"
+  ;
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " STRATEGY [caching]" << std::endl;
+    return 1;
+  }
+  bool use_enumeration_caching = argc > 2 && std::string(argv[2]) == "caching";
+
+  lps::stochastic_specification spec;
+  lps::parse_lps(SPECIFICATION, spec);
+  data::rewriter R(spec.data(), data::parse_rewrite_strategy(argv[1]));
+  lps::next_state_generator generator(spec, R, data::mutable_indexed_substitution<>(), use_enumeration_caching);
+
+  utilities::metrics_histogram& state_time = utilities::metrics().histogram("benchmark.next_state_generator.state_time_ns");
+  atermpp::indexed_set<lps::state> states;
+  std::size_t transitions = 0;
+  states.put(generator.initial_states().front().state());
+
+  utilities::run_benchmark("next_state_generator.exploration", 2 * 21 * 21 * 21, [&]()
+  {
+    lps::next_state_generator::enumerator_queue_t enumeration_queue;
+    for (std::size_t i = 0; i < states.size(); ++i)
+    {
+      const lps::state s = states.get(i);
+      auto start = std::chrono::steady_clock::now();
+      for (auto it = generator.begin(s, &enumeration_queue); it != generator.end(); ++it)
+      {
+        states.put(it->target_state());
+        transitions++;
+      }
+      state_time.observe(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+  });
+
+  utilities::report_benchmarks("lps_next_state_generator");
+  return states.size() == 2 * 21 * 21 * 21 && transitions > 0 ? 0 : 1;
+}
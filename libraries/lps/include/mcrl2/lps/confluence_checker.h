@@ -15,9 +15,11 @@
 #ifndef MCRL2_LPS_CONFLUENCE_CHECKER_H
 #define MCRL2_LPS_CONFLUENCE_CHECKER_H
 
+#include "mcrl2/atermpp/aterm_io.h"
 #include "mcrl2/core/detail/function_symbols.h"
 #include "mcrl2/data/detail/prover/bdd_prover.h"
 #include "mcrl2/data/detail/prover/bdd2dot.h"
+#include "mcrl2/data/detail/io.h"
 #include "mcrl2/data/detail/prover/solver_type.h"
 #include "mcrl2/data/rewriter.h"
 #include "mcrl2/data/set_identifier_generator.h"
@@ -27,10 +29,13 @@
 #include "mcrl2/lps/linear_process.h"
 #include "mcrl2/lps/specification.h"
 #include "mcrl2/utilities/exception.h"
+#include "mcrl2/utilities/detail/worker_processes.h"
 #include "mcrl2/utilities/logger.h"
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <sstream>
 #include <string>
 
 
@@ -134,6 +139,12 @@
     was set to true, the confluent tau-summands will not be marked, only the results of the confluence checking will be
     displayed.
 
+    If the parameter a_number_of_threads is larger than 1, the confluence conditions of a tau-summand with the other
+    summands are proven by that many worker processes. Since the term library is not thread safe, each worker is a
+    child process with its own copy of the prover and the rewriter, that keeps its caches during the whole check.
+    The results and the messages of the workers are merged in the order of the summands, such that the output does
+    not depend on the number of workers, except that the conjuncts of a counter example may be ordered differently.
+
     If there already is an action named ctau present in the LPS passed as parameter a_lps, an error will be reported. */
 
 
@@ -223,21 +234,45 @@ class Confluence_Checker
     /// \brief Identifier generator to allow variables to be uniquely renamed.
     data::set_identifier_generator f_set_identifier_generator;
 
+    /// \brief The number of worker processes that prove confluence conditions.
+    std::size_t f_number_of_threads;
+
+    /// \brief The worker processes, that exist during Confluence_Checker::check_confluence_and_mark.
+    std::unique_ptr<utilities::detail::worker_processes> f_workers;
+
     /// \brief Writes a dot file of the BDD created when checking the confluence of summands a_summand_number_1 and a_summand_number_2.
     void save_dot_file(std::size_t a_summand_number_1, std::size_t a_summand_number_2);
 
     /// \brief Outputs a path in the BDD corresponding to the condition at hand that leads to a node labelled false.
     void print_counter_example();
 
-    /// \brief Checks the confluence of summand a_summand_1 and a_summand_2
-    bool check_summands(
+    /// \brief Returns the confluence condition of summand a_summand_1 and a_summand_2, in which the summation
+    /// \brief variables of a_summand_2 are uniquely renamed.
+    data::data_expression make_confluence_condition(
       const data::data_expression& a_invariant,
-      const action_summand_type a_summand_1,
-      const std::size_t a_summand_number_1,
-      const action_summand_type a_summand_2,
-      const std::size_t a_summand_number_2,
+      const action_summand_type& a_summand_1,
+      const action_summand_type& a_summand_2,
       const char a_condition_type);
 
+    /// \brief Proves the confluence condition a_condition of summand a_summand_number_1 and a_summand_number_2,
+    /// \brief and prints the outcome.
+    bool prove_confluence_condition(
+      const data::data_expression& a_condition,
+      const std::size_t a_summand_number_1,
+      const std::size_t a_summand_number_2);
+
+    /// \brief Handles a request of a worker process to prove a confluence condition. The reply contains the
+    /// \brief outcome ('+' or '-'), followed by the log messages of the proof.
+    std::string prove_confluence_request(const std::string& a_request);
+
+    /// \brief Proves the confluence conditions a_conditions of summand a_summand_number and the summands
+    /// \brief a_summand_numbers using the worker processes. Returns the replies of the workers, or an empty vector
+    /// \brief if there are no workers.
+    std::vector<std::string> prove_confluence_conditions(
+      const std::vector<data::data_expression>& a_conditions,
+      const std::size_t a_summand_number,
+      const std::vector<std::size_t>& a_summand_numbers);
+
     /// \brief Checks and updates the confluence of summand a_summand concerning all other tau-summands.
     void check_confluence_and_mark_summand(
       action_summand_type& a_summand,
@@ -269,7 +304,8 @@ class Confluence_Checker
       std::string a_conditions = "c",
       bool a_counter_example = false,
       bool a_generate_invariants = false,
-      std::string const& a_dot_file_name = std::string()
+      std::string const& a_dot_file_name = std::string(),
+      std::size_t a_number_of_threads = 1
     );
 
     /// \brief Check the confluence of the LPS Confluence_Checker::f_lps.
@@ -677,67 +713,54 @@ void Confluence_Checker<Specification>::uniquely_rename_summutation_variables(
 // --------------------------------------------------------------------------------------------
 
 template <typename Specification>
-bool Confluence_Checker<Specification>::check_summands(
+data::data_expression Confluence_Checker<Specification>::make_confluence_condition(
   const data::data_expression& a_invariant,
-  const action_summand_type a_summand_1,
-  const std::size_t a_summand_number_1,
-  const action_summand_type a_summand_2,
-  const std::size_t a_summand_number_2,
+  const action_summand_type& a_summand_1,
+  const action_summand_type& a_summand_2,
   const char a_condition_type)
 {
   assert(a_summand_1.is_tau());
 
   const data::variable_list v_variables = f_lps.process().process_parameters();
+  action_summand_type tagged = a_summand_2;
+
+  if (!f_no_sums)
+  {
+    uniquely_rename_summutation_variables(tagged);
+  }
+
+  return get_confluence_condition(a_invariant, a_summand_1, tagged, v_variables, a_condition_type);
+}
+
+// --------------------------------------------------------------------------------------------
+
+template <typename Specification>
+bool Confluence_Checker<Specification>::prove_confluence_condition(
+  const data::data_expression& a_condition,
+  const std::size_t a_summand_number_1,
+  const std::size_t a_summand_number_2)
+{
   bool v_is_confluent = true;
 
-  if ((a_condition_type == 'c' || a_condition_type == 'd') && f_disjointness_checker.disjoint(a_summand_number_1, a_summand_number_2))
+  f_bdd_prover.set_formula(a_condition);
+  if (f_bdd_prover.is_tautology() == data::detail::answer_yes)
   {
-    mCRL2log(log::info) << ":";
+    mCRL2log(log::info) << "+";
   }
   else
   {
-    action_summand_type tagged = a_summand_2;
-
-    if (!f_no_sums)
-    {
-      uniquely_rename_summutation_variables(tagged);
-    }
-
-    const data::data_expression v_condition = get_confluence_condition(a_invariant, a_summand_1, tagged, v_variables, a_condition_type);
-    f_bdd_prover.set_formula(v_condition);
-    if (f_bdd_prover.is_tautology() == data::detail::answer_yes)
+    if (f_generate_invariants)
     {
-      mCRL2log(log::info) << "+";
-    }
-    else
-    {
-      if (f_generate_invariants)
+      const data::data_expression v_new_invariant(f_bdd_prover.get_bdd());
+      mCRL2log(log::verbose) << "\nChecking invariant: " << data::pp(v_new_invariant) << "\n";
+      if (f_invariant_checker.check_invariant(v_new_invariant))
       {
-        const data::data_expression v_new_invariant(f_bdd_prover.get_bdd());
-        mCRL2log(log::verbose) << "\nChecking invariant: " << data::pp(v_new_invariant) << "\n";
-        if (f_invariant_checker.check_invariant(v_new_invariant))
-        {
-          mCRL2log(log::verbose) << "Invariant holds" << std::endl;
-          mCRL2log(log::info) << "i";
-        }
-        else
-        {
-          mCRL2log(log::verbose) << "Invariant doesn't hold" << std::endl;
-          v_is_confluent = false;
-          if (f_check_all)
-          {
-            mCRL2log(log::info) << "-";
-          }
-          else
-          {
-            mCRL2log(log::info) << "Not confluent with summand " << a_summand_number_2 << ".";
-          }
-          print_counter_example();
-          save_dot_file(a_summand_number_1, a_summand_number_2);
-        }
+        mCRL2log(log::verbose) << "Invariant holds" << std::endl;
+        mCRL2log(log::info) << "i";
       }
       else
       {
+        mCRL2log(log::verbose) << "Invariant doesn't hold" << std::endl;
         v_is_confluent = false;
         if (f_check_all)
         {
@@ -751,12 +774,74 @@ bool Confluence_Checker<Specification>::check_summands(
         save_dot_file(a_summand_number_1, a_summand_number_2);
       }
     }
+    else
+    {
+      v_is_confluent = false;
+      if (f_check_all)
+      {
+        mCRL2log(log::info) << "-";
+      }
+      else
+      {
+        mCRL2log(log::info) << "Not confluent with summand " << a_summand_number_2 << ".";
+      }
+      print_counter_example();
+      save_dot_file(a_summand_number_1, a_summand_number_2);
+    }
   }
   return v_is_confluent;
 }
 
 // --------------------------------------------------------------------------------------------
 
+template <typename Specification>
+std::string Confluence_Checker<Specification>::prove_confluence_request(const std::string& a_request)
+{
+  std::istringstream v_request(a_request);
+  std::size_t v_summand_number_1;
+  std::size_t v_summand_number_2;
+  v_request >> v_summand_number_1 >> v_summand_number_2;
+  v_request.get();
+  const data::data_expression v_condition(data::detail::add_index(atermpp::read_term_from_binary_stream(v_request)));
+
+  utilities::detail::log_message_collector v_collector;
+  const bool v_is_confluent = prove_confluence_condition(v_condition, v_summand_number_1, v_summand_number_2);
+  return (v_is_confluent ? "+" : "-") + v_collector.messages();
+}
+
+// --------------------------------------------------------------------------------------------
+
+template <typename Specification>
+std::vector<std::string> Confluence_Checker<Specification>::prove_confluence_conditions(
+  const std::vector<data::data_expression>& a_conditions,
+  const std::size_t a_summand_number,
+  const std::vector<std::size_t>& a_summand_numbers)
+{
+  if (!f_workers || f_workers->size() == 0)
+  {
+    return std::vector<std::string>();
+  }
+
+  // The variables in the conditions may have been created after the workers, so the conditions are
+  // sent without the indices that are local to this process.
+  std::vector<std::string> v_requests;
+  for (std::size_t i = 0; i < a_conditions.size(); i++)
+  {
+    std::ostringstream v_request;
+    v_request << a_summand_number << " " << a_summand_numbers[i] << " ";
+    atermpp::write_term_to_binary_stream(data::detail::remove_index(a_conditions[i]), v_request);
+    v_requests.push_back(v_request.str());
+  }
+
+  return f_workers->map(v_requests, [&](const std::string& v_reply)
+    {
+      return !f_check_all && v_reply[0] == '-';
+    }
+  );
+}
+
+// --------------------------------------------------------------------------------------------
+
 template <typename Specification>
 void Confluence_Checker<Specification>::check_confluence_and_mark_summand(
   action_summand_type& a_summand,
@@ -765,12 +850,9 @@ void Confluence_Checker<Specification>::check_confluence_and_mark_summand(
   const char a_condition_type,
   bool& a_is_marked)
 {
-  typedef typename Specification::process_type::action_summand_type action_summand_type;
   assert(a_summand.is_tau());
-  std::vector<action_summand_type>& v_summands = f_lps.process().action_summands();
-  std::size_t v_summand_number = 1;
+  const std::vector<action_summand_type>& v_summands = f_lps.process().action_summands();
   bool v_is_confluent = true;
-  bool v_current_summands_are_confluent;
 
   // Add here that the sum variables of a_summand must be empty otherwise
   // the confluence of the summand must be checked with respect to itself,
@@ -787,62 +869,103 @@ void Confluence_Checker<Specification>::check_confluence_and_mark_summand(
     }
   }
 
-  for (typename std::vector<action_summand_type>::const_iterator i=v_summands.begin(); i!=v_summands.end() && (v_is_confluent || f_check_all); ++i)
+  // First determine for each summand how its confluence with a_summand is established: by symmetry ('.'),
+  // by the result for an earlier summand ('-'), by disjointness (':') or by proving the confluence condition ('p').
+  // The confluence conditions are collected, such that they can be proven by the worker processes.
+  std::vector<std::pair<std::size_t, char> > v_steps;
+  std::vector<data::data_expression> v_conditions;
+  std::vector<std::size_t> v_condition_summand_numbers;
+
+  for (std::size_t v_summand_number = 1; v_summand_number <= v_summands.size() && (v_is_confluent || f_check_all); v_summand_number++)
+  {
+    if (v_summand_number < a_summand_number && f_intermediate[v_summand_number] > a_summand_number)
+    {
+      v_steps.emplace_back(v_summand_number, '.');
+    }
+    else if (v_summand_number < a_summand_number && f_intermediate[v_summand_number] == a_summand_number)
+    {
+      v_steps.emplace_back(v_summand_number, '-');
+      if (!f_check_all)
+      {
+        break;
+      }
+    }
+    else if ((a_condition_type == 'c' || a_condition_type == 'd') && f_disjointness_checker.disjoint(a_summand_number, v_summand_number))
+    {
+      v_steps.emplace_back(v_summand_number, ':');
+    }
+    else
+    {
+      v_steps.emplace_back(v_summand_number, 'p');
+      v_conditions.push_back(make_confluence_condition(a_invariant, a_summand, v_summands[v_summand_number - 1], a_condition_type));
+      v_condition_summand_numbers.push_back(v_summand_number);
+    }
+  }
+
+  const std::vector<std::string> v_results = prove_confluence_conditions(v_conditions, a_summand_number, v_condition_summand_numbers);
+
+  // Then report the outcomes in the order of the summands. Without worker processes the confluence conditions
+  // are proven here.
+  std::size_t v_first_non_confluent_summand = v_is_confluent ? v_summands.size() + 1 : 1;
+  std::size_t v_condition_index = 0;
+  for (const std::pair<std::size_t, char>& v_step: v_steps)
   {
-    const action_summand_type v_summand = *i;
+    if (!v_is_confluent && !f_check_all)
+    {
+      break;
+    }
 
-    if (v_summand_number < a_summand_number)
+    bool v_current_summands_are_confluent = true;
+    switch (v_step.second)
     {
-      if (f_intermediate[v_summand_number] > a_summand_number)
+      case '.':
+      case ':':
       {
-        mCRL2log(log::info) << ".";
-        v_summand_number++;
+        mCRL2log(log::info) << v_step.second;
+        break;
       }
-      else
+      case '-':
       {
-        if (f_intermediate[v_summand_number] == a_summand_number)
+        if (f_check_all)
         {
-          if (f_check_all)
-          {
-            mCRL2log(log::info) << "-";
-          }
-          else
-          {
-            mCRL2log(log::info) << "Not confluent with summand " << v_summand_number << ".";
-          }
-          v_is_confluent = false;
+          mCRL2log(log::info) << "-";
         }
         else
         {
-          v_current_summands_are_confluent = check_summands(a_invariant, a_summand, a_summand_number, v_summand, v_summand_number, a_condition_type);
-          if (v_current_summands_are_confluent)
-          {
-            v_summand_number++;
-          }
-          else
-          {
-            v_is_confluent = false;
-          }
+          mCRL2log(log::info) << "Not confluent with summand " << v_step.first << ".";
         }
+        v_current_summands_are_confluent = false;
+        break;
       }
-    }
-    else
-    {
-      v_current_summands_are_confluent = check_summands(a_invariant, a_summand, a_summand_number, v_summand, v_summand_number, a_condition_type);
-      if (v_current_summands_are_confluent)
+      default:
       {
-        v_summand_number++;
+        if (v_results.empty())
+        {
+          v_current_summands_are_confluent = prove_confluence_condition(v_conditions[v_condition_index], a_summand_number, v_step.first);
+        }
+        else
+        {
+          const std::string& v_result = v_results[v_condition_index];
+          utilities::detail::log_message_collector::replay(v_result, 1);
+          v_current_summands_are_confluent = v_result[0] == '+';
+        }
+        v_condition_index++;
       }
-      else
+    }
+
+    if (!v_current_summands_are_confluent)
+    {
+      if (v_is_confluent)
       {
-        v_is_confluent = false;
+        v_first_non_confluent_summand = v_step.first;
       }
+      v_is_confluent = false;
     }
   }
 
   if (!f_check_all)
   {
-    f_intermediate[a_summand_number] = v_summand_number;
+    f_intermediate[a_summand_number] = v_first_non_confluent_summand;
   }
 
   if (v_is_confluent)
@@ -868,7 +991,8 @@ Confluence_Checker<Specification>::Confluence_Checker(
   std::string a_conditions,
   bool a_counter_example,
   bool a_generate_invariants,
-  std::string const& a_dot_file_name):
+  std::string const& a_dot_file_name,
+  std::size_t a_number_of_threads):
   f_disjointness_checker(lps::linear_process_to_aterm(a_lps.process())),
   f_invariant_checker(a_lps, a_rewrite_strategy, a_time_limit, a_path_eliminator, a_solver_type, false, false, 0),
   f_bdd_prover(a_lps.data(), data::used_data_equation_selector(a_lps.data()), a_rewrite_strategy,
@@ -879,7 +1003,8 @@ Confluence_Checker<Specification>::Confluence_Checker(
   f_conditions(a_conditions),
   f_counter_example(a_counter_example),
   f_dot_file_name(a_dot_file_name),
-  f_generate_invariants(a_generate_invariants)
+  f_generate_invariants(a_generate_invariants),
+  f_number_of_threads(a_number_of_threads)
 {
   if (has_ctau_action(a_lps))
   {
@@ -937,6 +1062,15 @@ void Confluence_Checker<Specification>::check_confluence_and_mark(const data::da
   f_number_of_summands = v_summands.size();
   std::string v_conditions = std::string(f_conditions);
 
+  if (f_number_of_threads > 1)
+  {
+    f_workers.reset(new utilities::detail::worker_processes(f_number_of_threads, [this](const std::string& a_request)
+      {
+        return prove_confluence_request(a_request);
+      }
+    ));
+  }
+
   while (v_conditions.length() > 0)
   {
     f_intermediate = std::vector<std::size_t>(f_number_of_summands + 2, 0);
@@ -976,6 +1110,7 @@ void Confluence_Checker<Specification>::check_confluence_and_mark(const data::da
                          " tau summands were found to be confluent" << std::endl;
 
   f_intermediate = std::vector<std::size_t>();
+  f_workers.reset();
 }
 
 } // namespace detail
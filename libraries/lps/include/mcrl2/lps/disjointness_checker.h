@@ -15,8 +15,9 @@
 #ifndef MCRL2_LPS_DISJOINTNESS_CHECKER_H
 #define MCRL2_LPS_DISJOINTNESS_CHECKER_H
 
+#include <map>
+#include <boost/dynamic_bitset.hpp>
 #include "mcrl2/lps/linear_process.h"
-#include "mcrl2/utilities/detail/container_utility.h"
 
 /// \brief Class that can determine if two summands are syntactically disjoint.
 /// Two summands are syntactically disjoint if the following conditions hold:
@@ -28,6 +29,9 @@
 /// Disjointness_Checker::Disjointness_Checker. The parameter a_process_equations is used to pass the summands to be
 /// checked for disjointness. The function Disjointness_Checker::disjoint indicates whether the two summands with numbers
 /// n_1 and n_2 are syntactically disjoint.
+///
+/// Since only process parameters can be changed by a summand, the sets of used and changed variables are restricted to
+/// the process parameters, and they are stored as bitsets that are indexed by the position of the parameters.
 
 namespace mcrl2
 {
@@ -42,11 +46,17 @@ class Disjointness_Checker
     /// \brief The number of summands of the LPS passed as argument of the constructor.
     std::size_t f_number_of_summands;
 
+    /// \brief Maps the process parameters to their positions.
+    std::map<data::variable, std::size_t> f_parameter_index;
+
     /// \brief A two dimensional array, indicating which parameters a summand uses, for each of the summands.
-    std::vector<std::set<data::variable> > f_used_parameters_per_summand;
+    std::vector<boost::dynamic_bitset<> > f_used_parameters_per_summand;
 
     /// \brief A two dimensional array, indicating which parameters a summand changes, for each of the summands.
-    std::vector<std::set<data::variable> > f_changed_parameters_per_summand;
+    std::vector<boost::dynamic_bitset<> > f_changed_parameters_per_summand;
+
+    /// \brief Marks the variable v in the bitset parameters, if v is a process parameter.
+    void insert_parameter(boost::dynamic_bitset<>& parameters, const data::variable& v);
 
     /// \brief Updates the array Disjointness_Checker::f_used_parameters_per_summand, given the expression a_expression.
     void process_data_expression(std::size_t n, const data::data_expression& x);
@@ -60,8 +70,8 @@ class Disjointness_Checker
 
   public:
     /// \brief Constructor that initializes the sets Disjointness_Checker::f_used_parameters_per_summand and
-    /// \brief Disjointness_Checker::f_changed_parameters_per_summand, and the indexed set
-    /// \brief Disjointness_Checker::f_parameter_set.
+    /// \brief Disjointness_Checker::f_changed_parameters_per_summand, and the index
+    /// \brief Disjointness_Checker::f_parameter_index.
     /// precondition: the argument passed as parameter a_process_equations is a specification of process equations in mCRL2
     /// format
     /// precondition: the arguments passed as parameters n_1 and n_2 correspond to summands in
@@ -73,13 +83,23 @@ class Disjointness_Checker
     bool disjoint(std::size_t n1, std::size_t n2);
 };
 
+inline
+void Disjointness_Checker::insert_parameter(boost::dynamic_bitset<>& parameters, const data::variable& v)
+{
+  auto i = f_parameter_index.find(v);
+  if (i != f_parameter_index.end())
+  {
+    parameters.set(i->second);
+  }
+}
+
 inline
 void Disjointness_Checker::process_data_expression(std::size_t n, const data::data_expression& x)
 {
   // This should probably once be replaced by a visitor.
   if (data::is_variable(x))
   {
-    f_used_parameters_per_summand[n].insert(data::variable(x));
+    insert_parameter(f_used_parameters_per_summand[n], atermpp::down_cast<data::variable>(x));
   }
   else if (data::is_where_clause(x))
   {
@@ -149,7 +169,7 @@ void Disjointness_Checker::process_summand(std::size_t n, const action_summand&
   for (const auto & v_assignment : v_assignments)
   {
     // variables changed in the assignment
-    f_changed_parameters_per_summand[n].insert(v_assignment.lhs());
+    insert_parameter(f_changed_parameters_per_summand[n], v_assignment.lhs());
 
     // variables used in assignment
     process_data_expression(n, v_assignment.rhs());
@@ -163,10 +183,13 @@ Disjointness_Checker::Disjointness_Checker(const linear_process& a_process_equat
   std::size_t v_summand_number = 1;
 
   f_number_of_summands = v_summands.size();
-  f_used_parameters_per_summand =
-    std::vector<std::set<data::variable> >(f_number_of_summands + 1, std::set<data::variable>());
-  f_changed_parameters_per_summand =
-    std::vector<std::set<data::variable> >(f_number_of_summands + 1, std::set<data::variable>());
+  for (const data::variable& v: a_process_equation.process_parameters())
+  {
+    f_parameter_index.insert(std::make_pair(v, f_parameter_index.size()));
+  }
+  const boost::dynamic_bitset<> v_empty(f_parameter_index.size());
+  f_used_parameters_per_summand = std::vector<boost::dynamic_bitset<> >(f_number_of_summands + 1, v_empty);
+  f_changed_parameters_per_summand = std::vector<boost::dynamic_bitset<> >(f_number_of_summands + 1, v_empty);
 
   for (const auto & v_summand : v_summands)
   {
@@ -178,11 +201,10 @@ Disjointness_Checker::Disjointness_Checker(const linear_process& a_process_equat
 inline
 bool Disjointness_Checker::disjoint(std::size_t n1, std::size_t n2)
 {
-  using utilities::detail::has_empty_intersection;
   assert(n1 <= f_number_of_summands && n2 <= f_number_of_summands);
-  bool v_used_1_changed_2 = has_empty_intersection(f_used_parameters_per_summand[n1], f_changed_parameters_per_summand[n2]);
-  bool v_used_2_changed_1 = has_empty_intersection(f_used_parameters_per_summand[n2], f_changed_parameters_per_summand[n1]);
-  bool v_changed_1_changed_2 = has_empty_intersection(f_changed_parameters_per_summand[n1], f_changed_parameters_per_summand[n2]);
+  bool v_used_1_changed_2 = !f_used_parameters_per_summand[n1].intersects(f_changed_parameters_per_summand[n2]);
+  bool v_used_2_changed_1 = !f_used_parameters_per_summand[n2].intersects(f_changed_parameters_per_summand[n1]);
+  bool v_changed_1_changed_2 = !f_changed_parameters_per_summand[n1].intersects(f_changed_parameters_per_summand[n2]);
   return v_used_1_changed_2 && v_used_2_changed_1 && v_changed_1_changed_2;
 }
 
@@ -37,11 +37,10 @@ class next_state_generator
     typedef atermpp::term_appl<data::data_expression> condition_arguments_t;
 
     typedef data::rewriter rewriter_t;
-    typedef data::enumerator_algorithm_with_iterator<> enumerator_t;
-    typedef enumerator_t::iterator enumerator_iterator_t;
-    typedef std::deque<data::enumerator_list_element_with_substitution<> > enumerator_queue_t;
-
     typedef data::rewriter::substitution_type substitution_t;
+    typedef data::enumerator_queue<data::enumerator_list_element_with_substitution<> > enumerator_queue_t;
+    typedef data::enumerator_algorithm_with_iterator<rewriter_t, data::enumerator_list_element_with_substitution<>, data::is_not_false, rewriter_t, substitution_t, enumerator_queue_t> enumerator_t;
+    typedef enumerator_t::iterator enumerator_iterator_t;
 
   protected:
     struct action_internal_t
@@ -57,6 +56,11 @@ class next_state_generator
       data::data_expression condition;
       stochastic_distribution distribution;
       data::data_expression_vector result_state;
+      // For every parameter whether its next state expression must be rewritten. If not, it is
+      // either the parameter itself, or a closed expression that is stored in result_state in normal form.
+      std::vector<bool> rewrite_result_state;
+      // changed_parameters[i] is the number of parameters j < i whose next state expression is not the parameter itself.
+      std::vector<std::size_t> changed_parameters;
       std::vector<action_internal_t> action_label;
       data::data_expression time_tag;
 
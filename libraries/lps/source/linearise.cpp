@@ -33,6 +33,8 @@
 #include <sstream>
 #include <memory>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 // ATermpp libraries
 #include "mcrl2/atermpp/indexed_set.h"
@@ -78,6 +80,33 @@ using namespace mcrl2::process;
 
 /*  Preamble */
 
+/* Applies f to 0,...,n-1 using the available hardware threads. As the term library
+   is not thread safe, f is not allowed to create or destroy terms. */
+template <typename Function>
+static void parallel_for_each_index(std::size_t n, Function f)
+{
+  std::size_t nr_threads = std::min<std::size_t>(n, std::max(1u, std::thread::hardware_concurrency()));
+  std::atomic<std::size_t> next(0);
+  auto worker = [&]()
+  {
+    for (std::size_t i = next++; i < n; i = next++)
+    {
+      f(i);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 1; t < nr_threads; ++t)
+  {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread: threads)
+  {
+    thread.join();
+  }
+}
+
 typedef enum { unknown,
                mCRL,
                mCRLdone,
@@ -8842,6 +8871,138 @@ class specification_basic_type
 
 
 
+    /* Determines for each summand i in action_summands1 the indices of the summands in
+       action_summands2 that must be combined with it in the communication merge, i.e.,
+       the summands that agree with it on termination, and of which the combined multi action
+       is allowed by allowlist, or not blocked by it. The multi actions are represented by
+       sequences of integers, such that the check can be done on multiple threads for all pairs
+       without constructing the multi actions. The resulting indices are increasing, such that
+       the summands are generated in the same order as the sequential algorithm does. */
+    std::vector<std::vector<std::size_t> > communication_merge_candidates(
+          const stochastic_action_summand_vector& action_summands1,
+          const stochastic_action_summand_vector& action_summands2,
+          const action_name_multiset_list& allowlist,
+          const bool is_allow,
+          const bool is_block)
+    {
+      // Number the action names in the order of their strings, which is the order
+      // in which linMergeMultiActionList puts the actions.
+      std::vector<identifier_string> names;
+      for (const stochastic_action_summand_vector* summands: { &action_summands1, &action_summands2 })
+      {
+        for (const stochastic_action_summand& summand: *summands)
+        {
+          for (const action& a: summand.multi_action().actions())
+          {
+            names.push_back(a.label().name());
+          }
+        }
+      }
+      for (const action_name_multiset& m: allowlist)
+      {
+        names.insert(names.end(), m.names().begin(), m.names().end());
+      }
+      std::sort(names.begin(), names.end(), [](const identifier_string& x, const identifier_string& y)
+                                            { return std::string(x) < std::string(y); });
+      names.erase(std::unique(names.begin(), names.end()), names.end());
+      std::map<identifier_string, std::size_t> number;
+      for (std::size_t i = 0; i < names.size(); ++i)
+      {
+        number[names[i]] = i;
+      }
+
+      auto to_numbers = [&](const stochastic_action_summand_vector& summands)
+      {
+        std::vector<std::vector<std::size_t> > result;
+        for (const stochastic_action_summand& summand: summands)
+        {
+          std::vector<std::size_t> v;
+          for (const action& a: summand.multi_action().actions())
+          {
+            v.push_back(number[a.label().name()]);
+          }
+          result.push_back(v);
+        }
+        return result;
+      };
+      const std::vector<std::vector<std::size_t> > multiactions1 = to_numbers(action_summands1);
+      const std::vector<std::vector<std::size_t> > multiactions2 = to_numbers(action_summands2);
+      std::vector<char> terminates2;
+      for (const stochastic_action_summand& summand: action_summands2)
+      {
+        terminates2.push_back(summand.multi_action().actions() == action_list({ terminationAction }));
+      }
+      std::vector<char> terminates1;
+      for (const stochastic_action_summand& summand: action_summands1)
+      {
+        terminates1.push_back(summand.multi_action().actions() == action_list({ terminationAction }));
+      }
+
+      // The allowed multi actions as sorted sequences of numbers, and the blocked action names.
+      std::vector<std::vector<std::size_t> > allowed;
+      std::vector<char> blocked(names.size(), 0);
+      for (const action_name_multiset& m: allowlist)
+      {
+        std::vector<std::size_t> v;
+        for (const identifier_string& name: m.names())
+        {
+          v.push_back(number[name]);
+          blocked[number[name]] = 1;
+        }
+        std::sort(v.begin(), v.end());
+        allowed.push_back(v);
+      }
+      std::sort(allowed.begin(), allowed.end());
+
+      std::vector<std::vector<std::size_t> > result(action_summands1.size());
+      auto compute_candidates = [&](std::size_t i)
+      {
+        std::vector<std::size_t> multiaction3;
+        for (std::size_t j = 0; j < action_summands2.size(); ++j)
+        {
+          if (terminates1[i] != terminates2[j])
+          {
+            continue;
+          }
+          multiaction3.clear();
+          if (!terminates1[i])
+          {
+            std::merge(multiactions1[i].begin(), multiactions1[i].end(),
+                       multiactions2[j].begin(), multiactions2[j].end(),
+                       std::back_inserter(multiaction3));
+          }
+          else
+          {
+            multiaction3 = multiactions1[i];
+          }
+          // Tau and termination are never blocked by allow.
+          if (is_allow && !multiaction3.empty() && !terminates1[i] && !std::binary_search(allowed.begin(), allowed.end(), multiaction3))
+          {
+            continue;
+          }
+          if (is_block && std::any_of(multiaction3.begin(), multiaction3.end(), [&](std::size_t a) { return blocked[a] != 0; }))
+          {
+            continue;
+          }
+          result[i].push_back(j);
+        }
+      };
+
+      // Only for large products it pays off to use multiple threads.
+      if (action_summands1.size() * action_summands2.size() >= 10000)
+      {
+        parallel_for_each_index(action_summands1.size(), compute_candidates);
+      }
+      else
+      {
+        for (std::size_t i = 0; i < action_summands1.size(); ++i)
+        {
+          compute_candidates(i);
+        }
+      }
+      return result;
+    }
+
     void calculate_communication_merge_action_summands(
           const stochastic_action_summand_vector& action_summands1,
           const stochastic_action_summand_vector& action_summands2,
@@ -8850,9 +9011,14 @@ class specification_basic_type
           const bool is_block,
           stochastic_action_summand_vector& action_summands)
     {
+      // Determine which pairs of summands are combined, before any of them is constructed.
+      const std::vector<std::vector<std::size_t> > candidates =
+               communication_merge_candidates(action_summands1, action_summands2, allowlist, is_allow, is_block);
+
       // First combine the action summands.
-      for (const stochastic_action_summand& summand1: action_summands1)
+      for (std::size_t i = 0; i < action_summands1.size(); ++i)
       {
+        const stochastic_action_summand& summand1=action_summands1[i];
         const variable_list& sumvars1=summand1.summation_variables();
         const action_list multiaction1=summand1.multi_action().actions();
         const data_expression actiontime1=summand1.multi_action().time();
@@ -8860,8 +9026,9 @@ class specification_basic_type
         const assignment_list& nextstate1=summand1.assignments();
         const stochastic_distribution& distribution1=summand1.distribution();
 
-        for (const stochastic_action_summand& summand2: action_summands2)
+        for (std::size_t j: candidates[i])
         {
+          const stochastic_action_summand& summand2=action_summands2[j];
           const variable_list& sumvars2=summand2.summation_variables();
           const action_list multiaction2=summand2.multi_action().actions();
           const data_expression actiontime2=summand2.multi_action().time();
@@ -8869,72 +9036,60 @@ class specification_basic_type
           const assignment_list& nextstate2=summand2.assignments();
           const stochastic_distribution& distribution2=summand2.distribution();
 
-          if ((multiaction1 == action_list({ terminationAction })) == (multiaction2 == action_list({ terminationAction })))
+          action_list multiaction3;
+          if ((multiaction1 == action_list({ terminationAction })) && (multiaction2 == action_list({ terminationAction })))
           {
-            action_list multiaction3;
-            if ((multiaction1 == action_list({ terminationAction })) && (multiaction2 == action_list({ terminationAction })))
-            {
-              multiaction3.push_front(terminationAction);
-            }
-            else
-            {
-              multiaction3=linMergeMultiActionList(multiaction1,multiaction2);
-            }
+            multiaction3.push_front(terminationAction);
+          }
+          else
+          {
+            multiaction3=linMergeMultiActionList(multiaction1,multiaction2);
+          }
 
-            if (is_allow && !allow_(allowlist,multiaction3))
-            {
-              continue;
-            }
-            if (is_block && encap(allowlist,multiaction3))
+          const variable_list allsums=sumvars1+sumvars2;
+          data_expression condition3= lazy::and_(condition1,condition2);
+          data_expression action_time3;
+          bool has_time3=summand1.has_time()||summand2.has_time();
+
+          if (!summand1.has_time())
+          {
+            if (summand2.has_time())
             {
-              continue;
+              /* summand 2 has time*/
+              action_time3=actiontime2;
             }
-
-            const variable_list allsums=sumvars1+sumvars2;
-            data_expression condition3= lazy::and_(condition1,condition2);
-            data_expression action_time3;
-            bool has_time3=summand1.has_time()||summand2.has_time();
-
-            if (!summand1.has_time())
+          }
+          else
+          {
+            /* summand 1 has time */
+            if (!summand2.has_time())
             {
-              if (summand2.has_time())
-              {
-                /* summand 2 has time*/
-                action_time3=actiontime2;
-              }
+              action_time3=actiontime1;
             }
             else
             {
-              /* summand 1 has time */
-              if (!summand2.has_time())
-              {
-                action_time3=actiontime1;
-              }
-              else
-              {
-                /* both summand 1 and 2 have time */
-                action_time3=actiontime1;
-                condition3=lazy::and_(
-                             condition3,
-                             equal_to(actiontime1,actiontime2));
-              }
+              /* both summand 1 and 2 have time */
+              action_time3=actiontime1;
+              condition3=lazy::and_(
+                           condition3,
+                           equal_to(actiontime1,actiontime2));
             }
+          }
 
-            const assignment_list nextstate3=nextstate1+nextstate2;
-            const stochastic_distribution distribution3(
-                                              distribution1.variables()+distribution2.variables(),
-                                              real_times_optimized(distribution1.distribution(),distribution2.distribution()));
+          const assignment_list nextstate3=nextstate1+nextstate2;
+          const stochastic_distribution distribution3(
+                                            distribution1.variables()+distribution2.variables(),
+                                            real_times_optimized(distribution1.distribution(),distribution2.distribution()));
 
-            condition3=RewriteTerm(condition3);
-            if (condition3!=sort_bool::false_())
-            {
-              action_summands.push_back(stochastic_action_summand(
-                                           allsums,
-                                           condition3,
-                                           has_time3?multi_action(multiaction3,action_time3):multi_action(multiaction3),
-                                           nextstate3,
-                                           distribution3));
-            }
+          condition3=RewriteTerm(condition3);
+          if (condition3!=sort_bool::false_())
+          {
+            action_summands.push_back(stochastic_action_summand(
+                                         allsums,
+                                         condition3,
+                                         has_time3?multi_action(multiaction3,action_time3):multi_action(multiaction3),
+                                         nextstate3,
+                                         distribution3));
           }
         }
       }
@@ -55,6 +55,30 @@ class state_applier
     }
 };
 
+// Returns the part of a next state that consists of the parameters [first, first + size). As the shape of
+// a balanced tree only depends on its size, a subtree of the source state in which no parameter changes is
+// reused as a whole, and only the next state expressions that are marked in rewrite are rewritten.
+static state make_next_state(const state& source,
+                             const std::size_t first,
+                             const std::size_t size,
+                             const data_expression_vector& result_state,
+                             const std::vector<bool>& rewrite,
+                             const std::vector<std::size_t>& changed_parameters,
+                             const rewriter_class& r)
+{
+  if (changed_parameters[first + size] == changed_parameters[first])
+  {
+    return source;
+  }
+  if (size == 1)
+  {
+    return state(rewrite[first] ? r(result_state[first]) : result_state[first]);
+  }
+  std::size_t left_size = (size + 1) >> 1; // size/2 rounded up, as in the constructor of term_balanced_tree.
+  return state(make_next_state(source.left_branch(), first, left_size, result_state, rewrite, changed_parameters, r),
+               make_next_state(source.right_branch(), first + left_size, size - left_size, result_state, rewrite, changed_parameters, r));
+}
+
 next_state_generator::next_state_generator(
   const stochastic_specification& spec,
   const data::rewriter& rewriter,
@@ -84,6 +108,23 @@ next_state_generator::next_state_generator(
     const data_expression_list& l=i->next_state(m_specification.process().process_parameters());
     summand.distribution = i->distribution();
     summand.result_state = data_expression_vector(l.begin(),l.end());
+
+    // Determine which next state expressions need to be rewritten for every transition. A parameter that
+    // is not changed is copied from the source state, and a closed expression is rewritten only once.
+    summand.changed_parameters.push_back(0);
+    for (std::size_t j = 0; j < m_process_parameters.size(); j++)
+    {
+      data_expression& e = summand.result_state[j];
+      const bool unchanged = e == m_process_parameters[j] &&
+                             std::find(i->summation_variables().begin(), i->summation_variables().end(), e) == i->summation_variables().end();
+      const bool closed = !unchanged && data::find_free_variables(e).empty();
+      if (closed)
+      {
+        e = m_rewriter(e);
+      }
+      summand.rewrite_result_state.push_back(!unchanged && !closed);
+      summand.changed_parameters.push_back(summand.changed_parameters.back() + (unchanged ? 0 : 1));
+    }
     if (i->multi_action().has_time())
     {
       summand.time_tag=i->multi_action().time();
@@ -577,9 +618,9 @@ void next_state_generator::iterator::increment()
   if (dist.variables().empty())
   {
     // There is no distribution, and therefore only one target state is generated
-    const data_expression_vector& state_args=m_summand->result_state;
     rewriter_class r(m_generator->m_rewriter,*m_substitution);
-    m_transition.set_target_state(lps::state(state_args.begin(),state_args.size(),r));
+    m_transition.set_target_state(make_next_state(m_state, 0, m_summand->result_state.size(), m_summand->result_state,
+                                                  m_summand->rewrite_result_state, m_summand->changed_parameters, r));
     m_transition.set_other_target_states(transition_t::state_probability_list());
   }
   else
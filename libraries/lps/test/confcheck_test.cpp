@@ -56,6 +56,12 @@ void run_confluence_test_case(const std::string& s, const std::size_t ctau_count
   checker1.check_confluence_and_mark(data::sort_bool::true_(),0);
 
   BOOST_CHECK_EQUAL(count_ctau(s0), ctau_count);
+
+  // Check that worker processes give the same result
+  specification s1 = parse_linear_process_specification(s);
+  Confluence_Checker<specification> checker2(s1, data::jitty, 0, false, data::detail::solver_type_cvc, false, false, false, "c", false, false, "", 3);
+  checker2.check_confluence_and_mark(data::sort_bool::true_(),0);
+  BOOST_CHECK(s0 == s1);
 }
 
 BOOST_AUTO_TEST_CASE(case_1)
@@ -0,0 +1,73 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file reduction.cpp
+/// \brief Benchmark for the reduction of an LTS modulo an equivalence, which is passed as the first argument.
+
+#include <iostream>
+#include <random>
+#include "mcrl2/lts/lts_algorithm.h"
+#include "mcrl2/lts/lts_aut.h"
+#include "mcrl2/utilities/benchmark.h"
+
+using namespace mcrl2;
+
+// Generates a pseudo random LTS. A fixed seed is used, such that the results of different runs can be compared.
+lts::lts_aut_t generate_lts(std::size_t number_of_states, std::size_t number_of_transitions, std::size_t number_of_actions)
+{
+  lts::lts_aut_t result;
+  std::mt19937 generator(1234);
+  std::uniform_int_distribution<std::size_t> state_distribution(0, number_of_states - 1);
+  std::uniform_int_distribution<std::size_t> label_distribution(0, number_of_actions);
+
+  for (std::size_t i = 0; i < number_of_states; ++i)
+  {
+    result.add_state();
+  }
+  for (std::size_t i = 0; i < number_of_actions; ++i)
+  {
+    result.add_action(lts::action_label_string("a" + std::to_string(i)));
+  }
+  result.set_initial_state(0);
+
+  // Every state gets a successor, to avoid that most of the states are deadlocks.
+  for (std::size_t i = 0; i < number_of_states; ++i)
+  {
+    result.add_transition(lts::transition(i, label_distribution(generator), state_distribution(generator)));
+  }
+  for (std::size_t i = number_of_states; i < number_of_transitions; ++i)
+  {
+    // Label 0 is tau.
+    result.add_transition(lts::transition(state_distribution(generator), label_distribution(generator), state_distribution(generator)));
+  }
+  return result;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " EQUIVALENCE" << std::endl;
+    return 1;
+  }
+  lts::lts_equivalence equivalence = lts::parse_equivalence(argv[1]);
+
+  const std::size_t number_of_states = 100000;
+  const std::size_t number_of_transitions = 300000;
+  lts::lts_aut_t l = generate_lts(number_of_states, number_of_transitions, 4);
+
+  utilities::run_benchmark("lts.reduction." + std::string(argv[1]), number_of_transitions, [&]()
+  {
+    lts::reduce(l, equivalence);
+  });
+  utilities::metrics().gauge("benchmark.lts.reduction." + std::string(argv[1]) + ".reduced_states").set(l.num_states());
+  utilities::metrics().gauge("benchmark.lts.reduction." + std::string(argv[1]) + ".reduced_transitions").set(l.num_transitions());
+
+  utilities::report_benchmarks("lts_reduction");
+  return l.num_states() <= number_of_states ? 0 : 1;
+}
@@ -9,6 +9,7 @@
 #ifndef MCRL2_LTS_DETAIL_EXPLORATION_NEW_H
 #define MCRL2_LTS_DETAIL_EXPLORATION_NEW_H
 
+#include <chrono>
 #include <string>
 #include <limits>
 #include <memory>
@@ -19,6 +20,7 @@
 #include "mcrl2/lps/next_state_generator.h"
 #include "mcrl2/lts/lts_lts.h"
 #include "mcrl2/lts/detail/bithashtable.h"
+#include "mcrl2/lts/detail/packed_state_set.h"
 #include "mcrl2/lts/detail/queue.h"
 #include "mcrl2/lts/detail/lts_generation_options.h"
 #include "mcrl2/lts/detail/exploration_strategy.h"
@@ -54,6 +56,52 @@ namespace detail
           return m_index;
         }
     };
+    /// \brief The set of visited states, that are stored either as terms or as packed bit vectors.
+    class state_set
+    {
+      protected:
+        atermpp::indexed_set<lps::state> m_terms;
+        std::unique_ptr<packed_state_set> m_packed;
+
+      public:
+        state_set()
+        {}
+
+        /// \brief Constructs a set that stores the states as terms.
+        state_set(std::size_t initial_size)
+         : m_terms(initial_size, 50)
+        {}
+
+        /// \brief Constructs a set that stores the states as packed bit vectors with the given widths per parameter.
+        state_set(const std::vector<std::size_t>& widths, std::size_t initial_size)
+         : m_packed(new packed_state_set(widths, initial_size))
+        {}
+
+        std::pair<std::size_t, bool> put(const lps::state& s)
+        {
+          return m_packed ? m_packed->put(s) : m_terms.put(s);
+        }
+
+        std::size_t index(const lps::state& s)
+        {
+          return m_packed ? m_packed->index(s) : static_cast<std::size_t>(m_terms.index(s));
+        }
+
+        std::size_t operator[](const lps::state& s)
+        {
+          return m_packed ? (*m_packed)[s] : m_terms[s];
+        }
+
+        lps::state get(std::size_t i) const
+        {
+          return m_packed ? m_packed->get(i) : m_terms.get(i);
+        }
+
+        std::size_t size() const
+        {
+          return m_packed ? m_packed->size() : m_terms.size();
+        }
+    };
 } // end namespace detail
 
 class lps2lts_algorithm
@@ -70,11 +118,16 @@ class lps2lts_algorithm
     next_state_generator::summand_subset_t m_nonprioritized_subset;
     next_state_generator::summand_subset_t m_prioritized_subset;
 
-    atermpp::indexed_set<lps::state> m_state_numbers;
+    detail::state_set m_state_numbers;
     bit_hash_table m_bit_hash_table;
 
     probabilistic_lts_lts_t m_output_lts;
     atermpp::indexed_set<process::action_list> m_action_label_numbers;
+    std::vector<std::string> m_action_label_strings; // The printed action labels, indexed by their numbers.
+
+    // For each summand the last action label that it generated, with its number. Most summands generate only
+    // a few distinct labels, so this avoids most lookups in m_action_label_numbers.
+    std::vector<std::pair<process::action_list, std::size_t> > m_summand_action_labels;
     std::ofstream m_aut_file;
 
     bool m_maintain_traces;
@@ -91,6 +144,7 @@ class lps2lts_algorithm
     std::size_t m_num_transitions;
     next_state_generator::transition_t::state_probability_list m_initial_states;
     std::size_t m_level;
+    std::chrono::steady_clock::time_point m_exploration_start;
 
     std::unordered_set<lps::state> non_divergent_states;  // This set is filled with states proven not to be divergent,
                                                           // when lps2lts_algorithm is requested to search for divergencies.
@@ -103,6 +157,7 @@ class lps2lts_algorithm
       m_must_abort(false)
     {
       m_action_label_numbers.put(action_label_lts::tau_action().actions());  // The action tau has index 0 by default.
+      m_action_label_strings.push_back(lps::pp(lps::multi_action(action_label_lts::tau_action().actions())));
     }
 
     ~lps2lts_algorithm()
@@ -126,6 +181,7 @@ class lps2lts_algorithm
   private:
     void initialise_lts_generation(const lts_generation_options& options);
     void finalise_lts_generation();
+    void update_exploration_metrics() const;
     data::data_expression_vector generator_state(const lps::state& storage_state);
     lps::state storage_state(const data::data_expression_vector& generator_state);
     void set_prioritised_representatives(next_state_generator::transition_t::state_probability_list& states);
@@ -148,6 +204,7 @@ class lps2lts_algorithm
     void save_deadlock(const lps::state& state);
     void save_nondeterministic_state(const lps::state& state, const next_state_generator::transition_t& nondeterminist_transition);
     void save_error(const lps::state& state);
+    std::size_t add_action_label(const next_state_generator::transition_t& transition);
     std::pair<std::size_t, bool> add_target_state(const lps::state& source_state, const lps::state& target_state);
     bool add_transition(const lps::state& source_state, const next_state_generator::transition_t& transition);
     void get_transitions(const lps::state& state,
@@ -0,0 +1,450 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/liblts_bisim_sigref_parallel.h
+/// \brief Multi-threaded signature refinement for strong and (divergence-preserving)
+///        branching bisimulation.
+
+#ifndef MCRL2_LTS_DETAIL_LIBLTS_BISIM_SIGREF_PARALLEL_H
+#define MCRL2_LTS_DETAIL_LIBLTS_BISIM_SIGREF_PARALLEL_H
+
+#include <algorithm>
+#include <cassert>
+#include <atomic>
+#include <map>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "mcrl2/lts/transition.h"
+#include "mcrl2/utilities/logger.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+
+/// \brief Signature refinement [Blom/Orzan 2003] in which the signatures of the states are computed
+///        by a number of threads.
+/// \details For branching bisimulation the strongly connected components of tau transitions are
+/// contracted first. The remaining tau transitions are acyclic, and the signature of a state only
+/// depends on the signatures of its inert tau successors. The states are therefore grouped into
+/// levels, where a state at level k only has tau successors at lower levels, and the signatures of
+/// the states at one level are computed concurrently. For strong bisimulation all signatures are
+/// computed concurrently. The numbering of the new blocks is done sequentially in the order of the
+/// states, so the result does not depend on the number of threads.
+template <class LTS_TYPE>
+class sigref_parallel
+{
+  protected:
+    typedef std::pair<std::size_t, std::size_t> signature_element; // (label, block)
+    typedef std::vector<signature_element> signature;
+
+    LTS_TYPE& m_lts;
+    bool m_branching;
+    bool m_preserve_divergence;
+    std::size_t m_thread_count;
+
+    // The states of the LTS are mapped to the states of the contracted LTS.
+    std::vector<std::size_t> m_state;
+    std::size_t m_num_states;
+
+    // The outgoing transitions of contracted state s are m_transitions[m_offset[s], m_offset[s + 1]).
+    // The labels are the labels after applying the hidden label map.
+    std::vector<std::size_t> m_offset;
+    std::vector<std::pair<std::size_t, std::size_t> > m_transitions; // (label, target)
+
+    // States that are on a tau cycle in the original LTS.
+    std::vector<char> m_divergent;
+
+    // The contracted states grouped per level. The states of level k are m_level_states[m_level_offset[k], m_level_offset[k + 1]).
+    std::vector<std::size_t> m_level_offset;
+    std::vector<std::size_t> m_level_states;
+
+    std::vector<std::size_t> m_block;
+    std::size_t m_block_count;
+    std::vector<signature> m_signature;
+
+    bool is_tau(std::size_t label) const
+    {
+      return m_lts.is_tau(label);
+    }
+
+    // Applies f to 0, ..., n - 1 using m_thread_count threads.
+    template <typename Function>
+    void parallel_for(std::size_t n, Function f) const
+    {
+      std::size_t thread_count = std::min(m_thread_count, n / 64 + 1);
+      if (thread_count <= 1)
+      {
+        for (std::size_t i = 0; i < n; i++)
+        {
+          f(i);
+        }
+        return;
+      }
+      std::atomic<std::size_t> next(0);
+      auto worker = [&]()
+      {
+        const std::size_t chunk = 64;
+        for (std::size_t first = next.fetch_add(chunk); first < n; first = next.fetch_add(chunk))
+        {
+          std::size_t last = std::min(n, first + chunk);
+          for (std::size_t i = first; i < last; i++)
+          {
+            f(i);
+          }
+        }
+      };
+      std::vector<std::thread> threads;
+      for (std::size_t t = 1; t < thread_count; t++)
+      {
+        threads.emplace_back(worker);
+      }
+      worker();
+      for (std::thread& t: threads)
+      {
+        t.join();
+      }
+    }
+
+    // Computes the strongly connected components of the tau transitions with an iterative version
+    // of Tarjan's algorithm. Components are numbered such that tau successors of a component have
+    // a lower number. For strong bisimulation every state is a component by itself.
+    void contract_tau_cycles(const std::vector<std::size_t>& offset, const std::vector<std::pair<std::size_t, std::size_t> >& transitions)
+    {
+      const std::size_t n = m_lts.num_states();
+      m_divergent.assign(n, 0);
+      if (!m_branching)
+      {
+        m_state.resize(n);
+        for (std::size_t s = 0; s < n; s++)
+        {
+          m_state[s] = s;
+        }
+        m_num_states = n;
+        return;
+      }
+
+      const std::size_t undefined = static_cast<std::size_t>(-1);
+      std::vector<std::size_t> number(n, undefined);
+      std::vector<std::size_t> low(n, 0);
+      std::vector<char> on_stack(n, 0);
+      std::vector<std::size_t> stack;
+      std::vector<std::pair<std::size_t, std::size_t> > call_stack; // (state, next transition)
+      std::size_t counter = 0;
+      m_state.assign(n, 0);
+      m_num_states = 0;
+
+      for (std::size_t root = 0; root < n; root++)
+      {
+        if (number[root] != undefined)
+        {
+          continue;
+        }
+        number[root] = low[root] = counter++;
+        stack.push_back(root);
+        on_stack[root] = 1;
+        call_stack.emplace_back(root, offset[root]);
+        while (!call_stack.empty())
+        {
+          std::size_t s = call_stack.back().first;
+          std::size_t& k = call_stack.back().second;
+          if (k < offset[s + 1])
+          {
+            const std::pair<std::size_t, std::size_t>& t = transitions[k++];
+            if (!is_tau(t.first))
+            {
+              continue;
+            }
+            if (t.second == s)
+            {
+              m_divergent[s] = 1;
+            }
+            else if (number[t.second] == undefined)
+            {
+              number[t.second] = low[t.second] = counter++;
+              stack.push_back(t.second);
+              on_stack[t.second] = 1;
+              call_stack.emplace_back(t.second, offset[t.second]);
+            }
+            else if (on_stack[t.second])
+            {
+              low[s] = std::min(low[s], number[t.second]);
+            }
+            continue;
+          }
+
+          call_stack.pop_back();
+          if (!call_stack.empty())
+          {
+            std::size_t parent = call_stack.back().first;
+            low[parent] = std::min(low[parent], low[s]);
+          }
+          if (low[s] == number[s])
+          {
+            std::size_t first = stack.size();
+            do
+            {
+              first--;
+            }
+            while (stack[first] != s);
+            bool divergent = stack.size() - first > 1;
+            for (std::size_t i = first; i < stack.size(); i++)
+            {
+              divergent = divergent || m_divergent[stack[i]];
+            }
+            for (std::size_t i = first; i < stack.size(); i++)
+            {
+              on_stack[stack[i]] = 0;
+              m_state[stack[i]] = m_num_states;
+              m_divergent[stack[i]] = divergent ? 1 : 0;
+            }
+            stack.resize(first);
+            m_num_states++;
+          }
+        }
+      }
+    }
+
+    void initialise()
+    {
+      const std::size_t n = m_lts.num_states();
+
+      // The transitions of the original LTS per source state.
+      std::vector<std::size_t> offset(n + 1, 0);
+      std::vector<std::pair<std::size_t, std::size_t> > transitions(m_lts.get_transitions().size());
+      for (const transition& t: m_lts.get_transitions())
+      {
+        offset[t.from() + 1]++;
+      }
+      for (std::size_t s = 0; s < n; s++)
+      {
+        offset[s + 1] += offset[s];
+      }
+      {
+        std::vector<std::size_t> next(offset.begin(), offset.end() - 1);
+        for (const transition& t: m_lts.get_transitions())
+        {
+          transitions[next[t.from()]++] = std::make_pair(m_lts.apply_hidden_label_map(t.label()), t.to());
+        }
+      }
+
+      contract_tau_cycles(offset, transitions);
+
+      // The transitions of the contracted LTS, without tau transitions inside a component and without duplicates.
+      std::vector<std::vector<std::pair<std::size_t, std::size_t> > > contracted(m_num_states);
+      std::vector<char> divergent(m_num_states, 0);
+      for (std::size_t s = 0; s < n; s++)
+      {
+        divergent[m_state[s]] = m_divergent[s];
+        for (std::size_t k = offset[s]; k < offset[s + 1]; k++)
+        {
+          std::size_t target = m_state[transitions[k].second];
+          if (m_branching && is_tau(transitions[k].first) && target == m_state[s])
+          {
+            continue;
+          }
+          contracted[m_state[s]].emplace_back(transitions[k].first, target);
+        }
+      }
+      m_divergent.swap(divergent);
+      m_offset.assign(1, 0);
+      m_transitions.clear();
+      for (std::vector<std::pair<std::size_t, std::size_t> >& v: contracted)
+      {
+        std::sort(v.begin(), v.end());
+        v.erase(std::unique(v.begin(), v.end()), v.end());
+        m_transitions.insert(m_transitions.end(), v.begin(), v.end());
+        m_offset.push_back(m_transitions.size());
+        std::vector<std::pair<std::size_t, std::size_t> >().swap(v);
+      }
+
+      // Group the contracted states by level. Since tau successors have a lower number, the levels
+      // can be computed in the order of the state numbers.
+      std::vector<std::size_t> level(m_num_states, 0);
+      std::size_t level_count = 1;
+      if (m_branching)
+      {
+        for (std::size_t s = 0; s < m_num_states; s++)
+        {
+          for (std::size_t k = m_offset[s]; k < m_offset[s + 1]; k++)
+          {
+            if (is_tau(m_transitions[k].first))
+            {
+              assert(m_transitions[k].second < s);
+              level[s] = std::max(level[s], level[m_transitions[k].second] + 1);
+            }
+          }
+          level_count = std::max(level_count, level[s] + 1);
+        }
+      }
+      m_level_offset.assign(level_count + 1, 0);
+      for (std::size_t s = 0; s < m_num_states; s++)
+      {
+        m_level_offset[level[s] + 1]++;
+      }
+      for (std::size_t k = 0; k < level_count; k++)
+      {
+        m_level_offset[k + 1] += m_level_offset[k];
+      }
+      m_level_states.resize(m_num_states);
+      {
+        std::vector<std::size_t> next(m_level_offset.begin(), m_level_offset.end() - 1);
+        for (std::size_t s = 0; s < m_num_states; s++)
+        {
+          m_level_states[next[level[s]]++] = s;
+        }
+      }
+
+      m_block.assign(m_num_states, 0);
+      m_block_count = 1;
+      m_signature.resize(m_num_states);
+    }
+
+    // Computes the signature of contracted state s with respect to m_block. For branching bisimulation
+    // the signatures of the tau successors of s must have been computed.
+    void compute_signature(std::size_t s)
+    {
+      signature& sig = m_signature[s];
+      sig.clear();
+      for (std::size_t k = m_offset[s]; k < m_offset[s + 1]; k++)
+      {
+        std::size_t label = m_transitions[k].first;
+        std::size_t target = m_transitions[k].second;
+        if (m_branching && is_tau(label) && m_block[target] == m_block[s])
+        {
+          // An inert transition: s inherits the signature of target.
+          const signature& inherited = m_signature[target];
+          sig.insert(sig.end(), inherited.begin(), inherited.end());
+        }
+        else
+        {
+          sig.emplace_back(label, m_block[target]);
+        }
+      }
+      if (m_preserve_divergence && m_divergent[s])
+      {
+        sig.emplace_back(m_lts.tau_label_index(), m_block[s]);
+      }
+      std::sort(sig.begin(), sig.end());
+      sig.erase(std::unique(sig.begin(), sig.end()), sig.end());
+    }
+
+    // Refines the partition until it is stable.
+    void compute_partition()
+    {
+      std::size_t iterations = 0;
+      for (;;)
+      {
+        for (std::size_t k = 0; k + 1 < m_level_offset.size(); k++)
+        {
+          const std::size_t* states = m_level_states.data() + m_level_offset[k];
+          parallel_for(m_level_offset[k + 1] - m_level_offset[k], [&](std::size_t i) { compute_signature(states[i]); });
+        }
+
+        // A new block is determined by the old block and the signature.
+        std::map<std::pair<std::size_t, const signature*>, std::size_t, signature_compare> blocks;
+        std::vector<std::size_t> block(m_num_states);
+        for (std::size_t s = 0; s < m_num_states; s++)
+        {
+          block[s] = blocks.insert(std::make_pair(std::make_pair(m_block[s], &m_signature[s]), blocks.size())).first->second;
+        }
+        iterations++;
+        mCRL2log(log::verbose) << "Iteration " << iterations << " resulted in " << blocks.size() << " blocks." << std::endl;
+        bool stable = blocks.size() == m_block_count;
+        m_block.swap(block);
+        m_block_count = blocks.size();
+        if (stable)
+        {
+          break;
+        }
+      }
+    }
+
+    struct signature_compare
+    {
+      bool operator()(const std::pair<std::size_t, const signature*>& x, const std::pair<std::size_t, const signature*>& y) const
+      {
+        return x.first < y.first || (x.first == y.first && *x.second < *y.second);
+      }
+    };
+
+    // Replaces the LTS by its quotient.
+    void quotient()
+    {
+      std::set<transition> transitions;
+      for (std::size_t s = 0; s < m_num_states; s++)
+      {
+        std::size_t from = m_block[s];
+        for (std::size_t k = m_offset[s]; k < m_offset[s + 1]; k++)
+        {
+          std::size_t label = m_transitions[k].first;
+          std::size_t to = m_block[m_transitions[k].second];
+          if (!m_branching || !is_tau(label) || from != to)
+          {
+            transitions.insert(transition(from, label, to));
+          }
+        }
+        if (m_preserve_divergence && m_divergent[s])
+        {
+          transitions.insert(transition(from, m_lts.tau_label_index(), from));
+        }
+      }
+
+      m_lts.set_num_states(m_block_count);
+      m_lts.set_initial_state(m_block[m_state[m_lts.initial_state()]]);
+      m_lts.clear_transitions();
+      for (const transition& t: transitions)
+      {
+        m_lts.add_transition(t);
+      }
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param branching If true, branching bisimulation is used, otherwise strong bisimulation.
+    /// \param preserve_divergence If true and branching is true, tau cycles are preserved.
+    /// \param thread_count The number of threads. If it is 0, the number of hardware threads is used.
+    sigref_parallel(LTS_TYPE& l, bool branching, bool preserve_divergence, std::size_t thread_count = 0)
+      : m_lts(l),
+        m_branching(branching),
+        m_preserve_divergence(branching && preserve_divergence),
+        m_thread_count(thread_count == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : thread_count),
+        m_num_states(0),
+        m_block_count(0)
+    {}
+
+    /// \brief Replaces the LTS by its quotient modulo the equivalence.
+    void run()
+    {
+      mCRL2log(log::verbose) << "Computing the partition using " << m_thread_count << " thread(s)." << std::endl;
+      m_lts.clear_state_labels();
+      initialise();
+      compute_partition();
+      quotient();
+    }
+};
+
+/// \brief Reduces an LTS modulo strong or (divergence-preserving) branching bisimulation using
+///        multi-threaded signature refinement.
+/// \param thread_count The number of threads. If it is 0, the number of hardware threads is used.
+template <class LTS_TYPE>
+void bisimulation_reduce_sigref_parallel(LTS_TYPE& l, bool branching = false, bool preserve_divergence = false, std::size_t thread_count = 0)
+{
+  sigref_parallel<LTS_TYPE> algorithm(l, branching, preserve_divergence, thread_count);
+  algorithm.run();
+}
+
+} // namespace detail
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_LIBLTS_BISIM_SIGREF_PARALLEL_H
@@ -0,0 +1,538 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/liblts_onthefly_refinement.h
+/// \brief Anti-chain based refinement checking in which the state spaces are
+///        generated on the fly, for instance from linear process specifications.
+
+#ifndef MCRL2_LTS_DETAIL_LIBLTS_ONTHEFLY_REFINEMENT_H
+#define MCRL2_LTS_DETAIL_LIBLTS_ONTHEFLY_REFINEMENT_H
+
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mcrl2/atermpp/indexed_set.h"
+#include "mcrl2/data/real.h"
+#include "mcrl2/data/rewriter.h"
+#include "mcrl2/data/selection.h"
+#include "mcrl2/lps/detail/instantiate_global_variables.h"
+#include "mcrl2/lps/find.h"
+#include "mcrl2/lps/next_state_generator.h"
+#include "mcrl2/lps/resolve_name_clashes.h"
+#include "mcrl2/lts/detail/liblts_failures_refinement.h"
+#include "mcrl2/lts/lts_lts.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+
+/// \brief Numbers the action labels of two state spaces by their textual representation, such that
+///        equal labels of different state spaces get the same number. The number 0 is used for tau.
+/// \details White space is removed from the labels before they are compared, since the .aut reader
+/// removes it as well.
+class onthefly_action_labels
+{
+  protected:
+    std::unordered_map<std::string, std::size_t> m_numbers;
+    std::vector<std::string> m_names;
+
+  public:
+    onthefly_action_labels()
+    {
+      m_numbers["tau"] = 0;
+      m_names.push_back("tau");
+    }
+
+    /// \brief Returns the number of the label with the given textual representation.
+    std::size_t operator[](std::string name)
+    {
+      name.erase(std::remove_if(name.begin(), name.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); }), name.end());
+      auto i = m_numbers.insert(std::make_pair(name, m_names.size()));
+      if (i.second)
+      {
+        m_names.push_back(name);
+      }
+      return i.first->second;
+    }
+
+    /// \brief Returns the textual representation of a label.
+    const std::string& name(std::size_t label) const
+    {
+      return m_names[label];
+    }
+
+    /// \brief Returns the number of the tau label.
+    static std::size_t tau()
+    {
+      return 0;
+    }
+};
+
+/// \brief A labelled transition system of which the outgoing transitions of a state are only
+///        computed when they are needed for the first time.
+/// \details States are numbered consecutively, starting at 0. The labels are numbers in an
+/// onthefly_action_labels table, in which hidden actions are mapped to tau.
+class onthefly_state_space
+{
+  public:
+    typedef std::pair<std::size_t, std::size_t> transition_type; // (label, target)
+
+  protected:
+    onthefly_action_labels& m_labels;
+
+    // A deque is used, such that references to the transitions of a state remain valid.
+    std::deque<std::vector<transition_type> > m_transitions;
+    std::vector<char> m_explored;
+
+    // 0 means unknown, 1 means not divergent and 2 means divergent.
+    std::vector<char> m_divergent;
+
+    /// \brief Computes the outgoing transitions of state s.
+    virtual void compute_transitions(std::size_t s, std::vector<transition_type>& result) = 0;
+
+  public:
+    onthefly_state_space(onthefly_action_labels& labels)
+      : m_labels(labels)
+    {}
+
+    virtual ~onthefly_state_space()
+    {}
+
+    /// \brief Returns the initial state.
+    virtual std::size_t initial_state() const = 0;
+
+    /// \brief Returns the action labels.
+    const onthefly_action_labels& labels() const
+    {
+      return m_labels;
+    }
+
+    /// \brief Returns the number of states of which the outgoing transitions have been computed.
+    std::size_t explored_states() const
+    {
+      return std::count(m_explored.begin(), m_explored.end(), 1);
+    }
+
+    /// \brief Returns the outgoing transitions of s, sorted on label.
+    const std::vector<transition_type>& transitions(std::size_t s)
+    {
+      if (s >= m_explored.size())
+      {
+        m_explored.resize(s + 1, 0);
+        m_transitions.resize(s + 1);
+      }
+      std::vector<transition_type>& result = m_transitions[s];
+      if (!m_explored[s])
+      {
+        compute_transitions(s, result);
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        m_explored[s] = 1;
+      }
+      return result;
+    }
+
+    /// \brief Returns true if s has no outgoing tau transitions.
+    bool stable(std::size_t s)
+    {
+      const std::vector<transition_type>& v = transitions(s);
+      return v.empty() || v.front().first != onthefly_action_labels::tau();
+    }
+
+    /// \brief Returns the labels of the outgoing transitions of s.
+    action_label_set action_labels(std::size_t s)
+    {
+      action_label_set result;
+      for (const transition_type& t: transitions(s))
+      {
+        result.insert(t.first);
+      }
+      return result;
+    }
+
+    /// \brief Returns true if s lies on a cycle of tau transitions.
+    bool diverges(std::size_t s)
+    {
+      if (s >= m_divergent.size())
+      {
+        m_divergent.resize(s + 1, 0);
+      }
+      if (m_divergent[s] == 0)
+      {
+        set_of_states visited;
+        std::vector<std::size_t> todo(1, s);
+        bool found = false;
+        while (!todo.empty() && !found)
+        {
+          std::size_t u = todo.back();
+          todo.pop_back();
+          for (const transition_type& t: transitions(u))
+          {
+            if (t.first != onthefly_action_labels::tau())
+            {
+              break;
+            }
+            if (t.second == s)
+            {
+              found = true;
+              break;
+            }
+            if (visited.insert(t.second).second)
+            {
+              todo.push_back(t.second);
+            }
+          }
+        }
+        m_divergent[s] = found ? 2 : 1;
+      }
+      return m_divergent[s] == 2;
+    }
+
+    /// \brief Returns the states that are reachable from a state in s by zero or more tau transitions
+    ///        if weak_reduction is true, and s otherwise.
+    set_of_states tau_closure(const set_of_states& s, bool weak_reduction)
+    {
+      if (!weak_reduction)
+      {
+        return s;
+      }
+      set_of_states result(s);
+      std::vector<std::size_t> todo(s.begin(), s.end());
+      while (!todo.empty())
+      {
+        std::size_t u = todo.back();
+        todo.pop_back();
+        for (const transition_type& t: transitions(u))
+        {
+          if (t.first != onthefly_action_labels::tau())
+          {
+            break;
+          }
+          if (result.insert(t.second).second)
+          {
+            todo.push_back(t.second);
+          }
+        }
+      }
+      return result;
+    }
+
+    /// \brief Returns the tau closure of the states that can be reached from a state in s by a transition with label a.
+    set_of_states successors(const set_of_states& s, std::size_t a, bool weak_reduction)
+    {
+      set_of_states result;
+      for (std::size_t u: s)
+      {
+        const std::vector<transition_type>& v = transitions(u);
+        for (auto i = std::lower_bound(v.begin(), v.end(), transition_type(a, 0)); i != v.end() && i->first == a; ++i)
+        {
+          result.insert(i->second);
+        }
+      }
+      return tau_closure(result, weak_reduction);
+    }
+
+    /// \brief Returns the stable states that can be reached from a state in s by zero or more tau transitions.
+    set_of_states stable_states(const set_of_states& s)
+    {
+      set_of_states result;
+      for (std::size_t u: tau_closure(s, true))
+      {
+        if (stable(u))
+        {
+          result.insert(u);
+        }
+      }
+      return result;
+    }
+};
+
+/// \brief The state space of a linear process specification, generated with a next state generator.
+class lps_onthefly_state_space: public onthefly_state_space
+{
+  protected:
+    lps::stochastic_specification m_specification;
+    std::vector<std::string> m_hidden_actions;
+    data::rewriter m_rewriter;
+    std::unique_ptr<lps::next_state_generator> m_generator;
+    lps::next_state_generator::enumerator_queue_t m_enumeration_queue;
+    atermpp::indexed_set<lps::state> m_states;
+    std::map<lps::multi_action, std::size_t> m_label_numbers;
+    std::size_t m_initial_state;
+
+    std::size_t label_number(const lps::multi_action& a)
+    {
+      auto i = m_label_numbers.find(a);
+      if (i != m_label_numbers.end())
+      {
+        return i->second;
+      }
+      action_label_lts l(a);
+      l.hide_actions(m_hidden_actions);
+      std::size_t result = l.actions().empty() ? onthefly_action_labels::tau() : m_labels[pp(l)];
+      m_label_numbers[a] = result;
+      return result;
+    }
+
+    void compute_transitions(std::size_t s, std::vector<transition_type>& result) override
+    {
+      const lps::state state = m_states.get(s);
+      for (lps::next_state_generator::iterator i = m_generator->begin(state, &m_enumeration_queue); i != m_generator->end(); i++)
+      {
+        if (!i->other_target_states().empty())
+        {
+          throw mcrl2::runtime_error("On the fly refinement checking does not support probabilistic transitions.");
+        }
+        result.emplace_back(label_number(i->action()), m_states.put(i->target_state()).first);
+      }
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param hidden_actions Actions with these names are hidden.
+    lps_onthefly_state_space(const lps::stochastic_specification& specification,
+                             onthefly_action_labels& labels,
+                             const std::vector<std::string>& hidden_actions,
+                             data::rewrite_strategy strategy = data::jitty)
+      : onthefly_state_space(labels),
+        m_specification(specification),
+        m_hidden_actions(hidden_actions)
+    {
+      resolve_summand_variable_name_clashes(m_specification);
+      lps::detail::instantiate_global_variables(m_specification);
+      std::set<data::function_symbol> extra_function_symbols = lps::find_function_symbols(m_specification);
+      extra_function_symbols.insert(data::sort_real::minus(data::sort_real::real_(), data::sort_real::real_()));
+      m_rewriter = data::rewriter(m_specification.data(), data::used_data_equation_selector(m_specification.data(), extra_function_symbols, m_specification.global_variables()), strategy);
+      m_generator.reset(new lps::next_state_generator(m_specification, m_rewriter));
+
+      const lps::next_state_generator::transition_t::state_probability_list& initial_states = m_generator->initial_states();
+      if (std::next(initial_states.begin()) != initial_states.end())
+      {
+        throw mcrl2::runtime_error("On the fly refinement checking does not support a probabilistic initial state.");
+      }
+      m_initial_state = m_states.put(initial_states.front().state()).first;
+    }
+
+    std::size_t initial_state() const override
+    {
+      return m_initial_state;
+    }
+};
+
+/// \brief The state space of a labelled transition system. The transitions are stored per state
+///        when the state space is constructed; this makes it possible to compare an LTS with an LPS.
+template <class LTS_TYPE>
+class lts_onthefly_state_space: public onthefly_state_space
+{
+  protected:
+    std::vector<std::size_t> m_offset;
+    std::vector<transition_type> m_lts_transitions;
+    std::size_t m_initial_state;
+
+    void compute_transitions(std::size_t s, std::vector<transition_type>& result) override
+    {
+      result.assign(m_lts_transitions.begin() + m_offset[s], m_lts_transitions.begin() + m_offset[s + 1]);
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param hidden_actions Actions with these names are hidden.
+    lts_onthefly_state_space(LTS_TYPE l, onthefly_action_labels& labels, const std::vector<std::string>& hidden_actions)
+      : onthefly_state_space(labels),
+        m_offset(l.num_states() + 1, 0),
+        m_initial_state(l.initial_state())
+    {
+      l.hide_actions(hidden_actions);
+      std::vector<std::size_t> label_numbers(l.num_action_labels());
+      for (std::size_t a = 0; a < l.num_action_labels(); a++)
+      {
+        std::size_t b = l.apply_hidden_label_map(a);
+        label_numbers[a] = l.is_tau(b) ? onthefly_action_labels::tau() : m_labels[pp(l.action_label(b))];
+      }
+      for (const transition& t: l.get_transitions())
+      {
+        m_offset[t.from() + 1]++;
+      }
+      for (std::size_t s = 0; s < l.num_states(); s++)
+      {
+        m_offset[s + 1] += m_offset[s];
+      }
+      m_lts_transitions.resize(l.get_transitions().size());
+      std::vector<std::size_t> next(m_offset.begin(), m_offset.end() - 1);
+      for (const transition& t: l.get_transitions())
+      {
+        m_lts_transitions[next[t.from()]++] = transition_type(label_numbers[t.label()], t.to());
+      }
+    }
+
+    std::size_t initial_state() const override
+    {
+      return m_initial_state;
+    }
+};
+
+/// \brief Records the traces of the pairs that are investigated by onthefly_refinement_checker,
+///        in the form of a tree of labels.
+class onthefly_trace_tree
+{
+  protected:
+    std::vector<std::pair<std::size_t, std::size_t> > m_nodes; // (label, parent)
+
+  public:
+    typedef std::size_t index_type;
+
+    index_type root_index() const
+    {
+      return atermpp::npos;
+    }
+
+    index_type add_transition(std::size_t label, index_type parent)
+    {
+      m_nodes.emplace_back(label, parent);
+      return m_nodes.size() - 1;
+    }
+
+    /// \brief Returns the labels on the path from the root to node i.
+    std::vector<std::size_t> trace(index_type i) const
+    {
+      std::vector<std::size_t> result;
+      for (; i != root_index(); i = m_nodes[i].second)
+      {
+        result.push_back(m_nodes[i].first);
+      }
+      std::reverse(result.begin(), result.end());
+      return result;
+    }
+};
+
+} // namespace detail
+
+/// \brief Checks whether the state space impl is included in the state space spec, in the sense of
+///        trace inclusion, failures inclusion or failures-divergence inclusion.
+/// \details This is the algorithm of destructive_refinement_checker, in which the states of impl and
+/// spec are only explored when they are needed. Hence if a counter example exists, it is typically
+/// found without generating the complete state spaces.
+/// \param weak_reduction If true, tau transitions are treated as internal steps.
+/// \param counter_example If the result is false and counter_example is not null, the labels of a
+///        trace that demonstrates that impl is not included in spec are stored in it.
+inline
+bool onthefly_refinement_checker(detail::onthefly_state_space& impl,
+                                 detail::onthefly_state_space& spec,
+                                 const refinement_type refinement,
+                                 const bool weak_reduction,
+                                 std::vector<std::string>* counter_example = nullptr)
+{
+  typedef detail::state_states_counter_example_index_triple<detail::onthefly_trace_tree> impl_spec_type;
+
+  detail::onthefly_trace_tree traces;
+  auto fail = [&](detail::onthefly_trace_tree::index_type i)
+  {
+    if (counter_example != nullptr)
+    {
+      counter_example->clear();
+      for (std::size_t a: traces.trace(i))
+      {
+        counter_example->push_back(impl.labels().name(a));
+      }
+    }
+    mCRL2log(log::verbose) << "Explored " << impl.explored_states() << " states of the first and "
+                           << spec.explored_states() << " states of the second state space." << std::endl;
+    return false;
+  };
+
+  std::deque<impl_spec_type> working(1, impl_spec_type(impl.initial_state(),
+                                                       spec.tau_closure(detail::set_of_states({ spec.initial_state() }), weak_reduction),
+                                                       traces.root_index()));
+  detail::anti_chain_type anti_chain;
+  detail::antichain_insert(anti_chain, working.front());
+  while (!working.empty())
+  {
+    impl_spec_type impl_spec;
+    impl_spec.swap(working.front());
+    working.pop_front();
+
+    if (refinement == failures_divergence && impl.diverges(impl_spec.state()))
+    {
+      bool spec_diverges = false;
+      for (std::size_t s: impl_spec.states())
+      {
+        if (spec.diverges(s))
+        {
+          spec_diverges = true;
+          break;
+        }
+      }
+      if (!spec_diverges)
+      {
+        return fail(impl_spec.counter_example_index());
+      }
+      continue;
+    }
+
+    // The refusals of a stable impl state must be refusals of a stable spec state. Without weak
+    // reduction tau is treated as an ordinary action, and all states are stable.
+    if ((refinement == failures || refinement == failures_divergence) && (!weak_reduction || impl.stable(impl_spec.state())))
+    {
+      const detail::action_label_set impl_labels = impl.action_labels(impl_spec.state());
+      bool success = false;
+      for (std::size_t s: weak_reduction ? spec.stable_states(impl_spec.states()) : impl_spec.states())
+      {
+        const detail::action_label_set spec_labels = spec.action_labels(s);
+        if (std::includes(impl_labels.begin(), impl_labels.end(), spec_labels.begin(), spec_labels.end()))
+        {
+          success = true;
+          break;
+        }
+      }
+      if (!success)
+      {
+        return fail(impl_spec.counter_example_index());
+      }
+    }
+
+    for (const detail::onthefly_state_space::transition_type& t: impl.transitions(impl_spec.state()))
+    {
+      const detail::onthefly_trace_tree::index_type index = traces.add_transition(t.first, impl_spec.counter_example_index());
+      detail::set_of_states spec_prime;
+      if (t.first == detail::onthefly_action_labels::tau() && weak_reduction)
+      {
+        spec_prime = impl_spec.states();
+      }
+      else
+      {
+        spec_prime = spec.successors(impl_spec.states(), t.first, weak_reduction);
+      }
+      if (spec_prime.empty())
+      {
+        return fail(index);
+      }
+      const impl_spec_type impl_spec_prime(t.second, spec_prime, index);
+      if (detail::antichain_insert(anti_chain, impl_spec_prime))
+      {
+        working.push_back(impl_spec_prime);
+      }
+    }
+  }
+  mCRL2log(log::verbose) << "Explored " << impl.explored_states() << " states of the first and "
+                         << spec.explored_states() << " states of the second state space." << std::endl;
+  return true;
+}
+
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_LIBLTS_ONTHEFLY_REFINEMENT_H
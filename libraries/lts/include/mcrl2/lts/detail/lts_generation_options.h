@@ -47,6 +47,7 @@ class lts_generation_options
 
     bool bithashing;
     std::size_t bithashsize;
+    bool packed_states;
 
     mcrl2::lts::lts_type outformat;
     bool outinfo;
@@ -80,6 +81,7 @@ class lts_generation_options
       suppress_progress_messages(false),
       bithashing(false),
       bithashsize(default_bithashsize),
+      packed_states(false),
       outformat(mcrl2::lts::lts_none),
       outinfo(true),
       trace(false),
@@ -0,0 +1,278 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/packed_state_set.h
+/// \brief A set of states that stores each state as a fixed width bit vector.
+
+#ifndef MCRL2_LTS_DETAIL_PACKED_STATE_SET_H
+#define MCRL2_LTS_DETAIL_PACKED_STATE_SET_H
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "mcrl2/atermpp/indexed_set.h"
+#include "mcrl2/data/bool.h"
+#include "mcrl2/data/data_specification.h"
+#include "mcrl2/lps/state.h"
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2
+{
+
+namespace lts
+{
+
+namespace detail
+{
+
+/// \brief Returns the number of bits that is used to store a parameter of sort s in a packed_state_set.
+/// \details For Bool and for sorts of which all constructors are constants the number of constructors
+/// bounds the number of values, and as few bits as possible are used. Otherwise 32 bits are used.
+inline
+std::size_t packed_parameter_width(const data::sort_expression& s, const data::data_specification& dataspec)
+{
+  if (s == data::sort_bool::bool_())
+  {
+    return 1;
+  }
+  const data::function_symbol_vector& constructors = dataspec.constructors(s);
+  if (constructors.empty())
+  {
+    return 32;
+  }
+  for (const data::function_symbol& f: constructors)
+  {
+    if (data::is_function_sort(f.sort()))
+    {
+      return 32;
+    }
+  }
+  std::size_t width = 1;
+  while ((std::size_t(1) << width) < constructors.size())
+  {
+    width++;
+  }
+  return width;
+}
+
+/// \brief A set of states with the same interface as atermpp::indexed_set<lps::state>, that uses
+///        much less memory per state.
+/// \details The value of every parameter is mapped to a code, which is its index in a table of values
+/// of that parameter. A state is stored as the sequence of codes of its parameters, packed into a
+/// fixed number of 64 bit words. The states are stored contiguously in a vector, and they are found
+/// using an open addressing hash table that only contains state numbers. Terms are only created
+/// when a state is retrieved with get.
+class packed_state_set
+{
+  protected:
+    typedef std::uint64_t word_type;
+
+    // The position of the code of parameter i is bits [m_offset[i], m_offset[i] + m_width[i]) of
+    // word m_word[i]. A code never spans two words.
+    std::vector<std::size_t> m_word;
+    std::vector<std::size_t> m_offset;
+    std::vector<std::size_t> m_width;
+    std::size_t m_words_per_state;
+
+    std::deque<atermpp::indexed_set<data::data_expression> > m_values;
+
+    // The state with number i is stored in m_states[i * m_words_per_state, (i + 1) * m_words_per_state).
+    std::vector<word_type> m_states;
+    std::size_t m_size;
+
+    // Contains state numbers plus one; the value 0 denotes an empty bucket.
+    std::vector<std::size_t> m_buckets;
+
+    // Storage for the state that is looked up.
+    std::vector<word_type> m_key;
+
+    std::size_t hash(const word_type* key) const
+    {
+      word_type h = 14695981039346656037ULL;
+      for (std::size_t k = 0; k < m_words_per_state; k++)
+      {
+        h = (h ^ key[k]) * 1099511628211ULL;
+        h ^= h >> 29;
+      }
+      return static_cast<std::size_t>(h);
+    }
+
+    bool equals(std::size_t i, const word_type* key) const
+    {
+      const word_type* s = &m_states[i * m_words_per_state];
+      return std::equal(key, key + m_words_per_state, s);
+    }
+
+    // Stores the codes of the parameters of s in m_key. If insert is false and a value does
+    // not occur in the value tables, false is returned.
+    bool encode(const lps::state& s, bool insert)
+    {
+      assert(s.size() == m_width.size());
+      std::fill(m_key.begin(), m_key.end(), 0);
+      std::size_t i = 0;
+      for (const data::data_expression& x: s)
+      {
+        std::size_t code;
+        if (insert)
+        {
+          code = m_values[i].put(x).first;
+          if (m_width[i] < 64 && code >> m_width[i] != 0)
+          {
+            throw mcrl2::runtime_error("The parameter with index " + std::to_string(i) + " has more values than fit in a packed state.");
+          }
+        }
+        else
+        {
+          code = m_values[i].index(x);
+          if (code == atermpp::npos)
+          {
+            return false;
+          }
+        }
+        m_key[m_word[i]] |= static_cast<word_type>(code) << m_offset[i];
+        i++;
+      }
+      return true;
+    }
+
+    // Returns the bucket that contains the state in m_key, or an empty bucket where it can be inserted.
+    std::size_t find_bucket() const
+    {
+      std::size_t mask = m_buckets.size() - 1;
+      for (std::size_t b = hash(m_key.data()) & mask; ; b = (b + 1) & mask)
+      {
+        if (m_buckets[b] == 0 || equals(m_buckets[b] - 1, m_key.data()))
+        {
+          return b;
+        }
+      }
+    }
+
+    void resize_buckets()
+    {
+      std::vector<std::size_t> buckets(2 * m_buckets.size(), 0);
+      std::size_t mask = buckets.size() - 1;
+      for (std::size_t i = 0; i < m_size; i++)
+      {
+        std::size_t b = hash(&m_states[i * m_words_per_state]) & mask;
+        while (buckets[b] != 0)
+        {
+          b = (b + 1) & mask;
+        }
+        buckets[b] = i + 1;
+      }
+      m_buckets.swap(buckets);
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param widths The number of bits that is used for each parameter. Each width is at most 64.
+    /// \param initial_size The initial number of buckets of the hash table.
+    packed_state_set(const std::vector<std::size_t>& widths, std::size_t initial_size = 1024)
+      : m_width(widths), m_words_per_state(0), m_size(0)
+    {
+      std::size_t used = 64;
+      for (std::size_t w: widths)
+      {
+        assert(0 < w && w <= 64);
+        if (used + w > 64)
+        {
+          m_words_per_state++;
+          used = 0;
+        }
+        m_word.push_back(m_words_per_state - 1);
+        m_offset.push_back(used);
+        used += w;
+        m_values.emplace_back();
+      }
+      m_words_per_state = std::max<std::size_t>(m_words_per_state, 1);
+      m_key.resize(m_words_per_state);
+      std::size_t n = 16;
+      while (n < initial_size)
+      {
+        n *= 2;
+      }
+      m_buckets.resize(n, 0);
+    }
+
+    /// \brief Returns the number of bytes that is used to store one state.
+    std::size_t state_size() const
+    {
+      return m_words_per_state * sizeof(word_type);
+    }
+
+    /// \brief Returns the number of states in the set.
+    std::size_t size() const
+    {
+      return m_size;
+    }
+
+    /// \brief Inserts the state s.
+    /// \return The number of s, and a boolean that is true if s was not yet in the set.
+    std::pair<std::size_t, bool> put(const lps::state& s)
+    {
+      encode(s, true);
+      std::size_t b = find_bucket();
+      if (m_buckets[b] != 0)
+      {
+        return std::make_pair(m_buckets[b] - 1, false);
+      }
+      m_states.insert(m_states.end(), m_key.begin(), m_key.end());
+      m_buckets[b] = ++m_size;
+      if (2 * m_size > m_buckets.size())
+      {
+        resize_buckets();
+      }
+      return std::make_pair(m_size - 1, true);
+    }
+
+    /// \brief Returns the number of the state s, or atermpp::npos if it is not in the set.
+    std::size_t index(const lps::state& s)
+    {
+      if (!encode(s, false))
+      {
+        return atermpp::npos;
+      }
+      std::size_t b = find_bucket();
+      if (m_buckets[b] == 0)
+      {
+        return atermpp::npos;
+      }
+      return m_buckets[b] - 1;
+    }
+
+    /// \brief Returns the number of the state s. If it is not in the set, it is inserted first.
+    std::size_t operator[](const lps::state& s)
+    {
+      return put(s).first;
+    }
+
+    /// \brief Returns the state with number i.
+    lps::state get(std::size_t i) const
+    {
+      assert(i < m_size);
+      const word_type* s = &m_states[i * m_words_per_state];
+      data::data_expression_vector values;
+      values.reserve(m_width.size());
+      for (std::size_t k = 0; k < m_width.size(); k++)
+      {
+        word_type mask = m_width[k] == 64 ? ~word_type(0) : (word_type(1) << m_width[k]) - 1;
+        std::size_t code = static_cast<std::size_t>((s[m_word[k]] >> m_offset[k]) & mask);
+        values.push_back(m_values[k].get(code));
+      }
+      return lps::state(values.begin(), values.size());
+    }
+};
+
+} // namespace detail
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_PACKED_STATE_SET_H
@@ -47,6 +47,7 @@
 #include "mcrl2/lts/lts_equivalence.h"
 #include "mcrl2/lts/lts_preorder.h"
 #include "mcrl2/lts/sigref.h"
+#include "mcrl2/lts/detail/liblts_bisim_sigref_parallel.h"
 
 namespace mcrl2
 {
@@ -573,6 +574,11 @@ void reduce(LTS_TYPE& l,lts_equivalence eq)
       s.run();
       return;
     }
+    case lts_eq_bisim_sigref_parallel:
+    {
+      detail::bisimulation_reduce_sigref_parallel(l,false,false);
+      return;
+    }
     case lts_eq_branching_bisim:
     {
       detail::bisimulation_reduce_gjkw(l,true,false);
@@ -594,6 +600,11 @@ void reduce(LTS_TYPE& l,lts_equivalence eq)
       s.run();
       return;
     }
+    case lts_eq_branching_bisim_sigref_parallel:
+    {
+      detail::bisimulation_reduce_sigref_parallel(l,true,false);
+      return;
+    }
     case lts_eq_divergence_preserving_branching_bisim:
     {
       detail::bisimulation_reduce_gjkw(l,true,true);
@@ -615,6 +626,11 @@ void reduce(LTS_TYPE& l,lts_equivalence eq)
       s.run();
       return;
     }
+    case lts_eq_divergence_preserving_branching_bisim_sigref_parallel:
+    {
+      detail::bisimulation_reduce_sigref_parallel(l,true,true);
+      return;
+    }
     case lts_eq_weak_bisim:
     {
       detail::weak_bisimulation_reduce(l,false);
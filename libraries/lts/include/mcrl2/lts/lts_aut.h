@@ -19,7 +19,10 @@
 #ifndef MCRL2_LTS_LTS_AUT_H
 #define MCRL2_LTS_LTS_AUT_H
 
+#include <functional>
 #include <istream>
+#include <ostream>
+#include <string>
 #include "mcrl2/lps/state_probability_pair.h"
 #include "mcrl2/lts/probabilistic_arbitrary_precision_fraction.h"
 #include "mcrl2/lts/state_label_empty.h"
@@ -122,6 +125,55 @@ class probabilistic_lts_aut_t :
     void save(const std::string& filename) const;
 };
 
+/** \brief Reads a labelled transition system in .aut format from an input stream, without storing it.
+ *  \details The function header is called with the initial state, the number of transitions and the
+ *           number of states in the header of the input, after which the function transition is called
+ *           with the source, the label and the target of each transition, in the order in which they
+ *           occur. Labels are passed as they occur in the input, so tau is passed as the string "tau".
+ *           The input is checked in the same way as by lts_aut_t::load. It must not contain
+ *           probabilistic states.
+ *  \param[in] is The input stream.
+ *  \param[in] header The function that is applied to the header.
+ *  \param[in] transition The function that is applied to each transition.
+ */
+void read_aut(std::istream& is,
+              const std::function<void(std::size_t initial_state, std::size_t number_of_transitions, std::size_t number_of_states)>& header,
+              const std::function<void(std::size_t from, const std::string& label, std::size_t to)>& transition);
+
+/** \brief Writes a labelled transition system in .aut format to an output stream, one transition at a time.
+ *  \details The output is collected in a buffer, which is written to the stream when it is full,
+ *           when flush is called, and when the writer is destroyed. The caller is responsible for
+ *           writing the number of transitions that is given in the header.
+ */
+class aut_writer
+{
+  protected:
+    std::ostream& m_os;
+    std::string m_buffer;
+
+    void write_number(std::size_t n);
+
+  public:
+    /** \brief Constructor. Writes the header of the .aut format.
+     *  \param[in] os The output stream.
+     *  \param[in] initial_state The initial state.
+     *  \param[in] number_of_transitions The number of transitions that will be written.
+     *  \param[in] number_of_states The number of states.
+     */
+    aut_writer(std::ostream& os, std::size_t initial_state, std::size_t number_of_transitions, std::size_t number_of_states);
+
+    aut_writer(const aut_writer&) = delete;
+    aut_writer& operator=(const aut_writer&) = delete;
+
+    ~aut_writer();
+
+    /** \brief Writes the transition (from,"label",to). */
+    void write_transition(std::size_t from, const std::string& label, std::size_t to);
+
+    /** \brief Writes the contents of the buffer to the output stream. */
+    void flush();
+};
+
 } // namespace lts
 } // namespace mcrl2
 
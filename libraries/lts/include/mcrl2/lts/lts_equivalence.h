@@ -36,14 +36,17 @@ enum lts_equivalence
   lts_eq_bisim_gv,         /**< Strong bisimulation equivalence using the O(mn) algorithm [Groote/Vaandrager 1990] */
   lts_eq_bisim_dnj,        /**< Strong bisimulation equivalence using the O(m log n) algorithm directly on an LTS; experimental. */
   lts_eq_bisim_sigref,     /**< Strong bisimulation equivalence using the signature refinement algorithm [Blom/Orzan 2003] */
+  lts_eq_bisim_sigref_parallel, /**< Strong bisimulation equivalence using a multi-threaded signature refinement algorithm */
   lts_eq_branching_bisim,  /**< Branching bisimulation equivalence using the O(m log n) algorithm [Groote/Jansen/Keiren/Wijs 2017] */
   lts_eq_branching_bisim_gv,     /**< Branching bisimulation equivalence using the O(mn) algorithm [Groote/Vaandrager 1990] */
   lts_eq_branching_bisim_dnj,    /**< Branching bisimulation equivalence using the O(m log n) algorithm directly on an LTS; experimental */
   lts_eq_branching_bisim_sigref, /**< Branching bisimulation equivalence using the signature refinement algorithm [Blom/Orzan 2003] */
+  lts_eq_branching_bisim_sigref_parallel, /**< Branching bisimulation equivalence using a multi-threaded signature refinement algorithm */
   lts_eq_divergence_preserving_branching_bisim, /**< Divergence-preserving branching bisimulation equivalence using the O(m log n) algorithm [Groote/Jansen/Keiren/Wijs 2017] */
   lts_eq_divergence_preserving_branching_bisim_gv,    /**< Divergence-preserving branching bisimulation equivalence using the O(mn) algorithm [Groote/Vaandrager 1990] */
   lts_eq_divergence_preserving_branching_bisim_dnj,   /**< Divergence-preserving branching bisimulation equivalence using the O(m log n) algorithm directly on an LTS; experimental */
   lts_eq_divergence_preserving_branching_bisim_sigref, /** Divergence-preserving branching bisimulation equivalence using the signature refinement algorithm [Blom/Orzan 2003] */
+  lts_eq_divergence_preserving_branching_bisim_sigref_parallel, /**< Divergence-preserving branching bisimulation equivalence using a multi-threaded signature refinement algorithm */
   lts_eq_weak_bisim,  /**< Weak bisimulation equivalence */
   lts_eq_divergence_preserving_weak_bisim, /**< Divergence-preserving weak bisimulation equivalence */
   lts_eq_sim,              /**< Strong simulation equivalence */
@@ -63,18 +66,24 @@ enum lts_equivalence
  *          [Groote/Vaandrager 1990];
  * \li "bisim-sig" for strong bisimilarity using the signature refinement
  *          algorithm [Blom/Orzan 2003];
+ * \li "bisim-sig-par" for strong bisimilarity using a multi-threaded signature
+ *          refinement algorithm;
  * \li "branching-bisim" for branching bisimilarity using the O(m log n)
  *          algorithm [Groote/Jansen/Keiren/Wijs 2017];
  * \li "branching-bisim-gv" for branching bisimilarity using the O(mn)
  *          algorithm [Groote/Vaandrager 1990];
  * \li "branching-bisim-sig" for branching bisimilarity using the signature
  *          refinement algorithm [Blom/Orzan 2003];
+ * \li "branching-bisim-sig-par" for branching bisimilarity using a
+ *          multi-threaded signature refinement algorithm;
  * \li "dpbranching-bisim" for divergence-preserving branching bisimilarity
  *          using the O(m log n) algorithm [Groote/Jansen/Keiren/Wijs 2017];
  * \li "dpbranching-bisim-gv" for divergence-preserving branching bisimilarity
  *          using the O(mn) algorithm [Groote/Vaandrager 1990];
  * \li "dpbranching-bisim-sig" for divergence-preserving branching bisimilarity
  *          using the signature refinement algorithm [Blom/Orzan 2003];
+ * \li "dpbranching-bisim-sig-par" for divergence-preserving branching
+ *          bisimilarity using a multi-threaded signature refinement algorithm;
  * \li "weak-bisim" for weak bisimilarity;
  * \li "dpweak-bisim" for divergence-preserving weak bisimilarity;
  * \li "sim" for strong simulation equivalence;
@@ -108,6 +117,10 @@ lts_equivalence parse_equivalence(std::string const& s)
   {
     return lts_eq_bisim_sigref;
   }
+  else if (s == "bisim-sig-par")
+  {
+    return lts_eq_bisim_sigref_parallel;
+  }
   else if (s == "branching-bisim")
   {
     return lts_eq_branching_bisim;
@@ -124,6 +137,10 @@ lts_equivalence parse_equivalence(std::string const& s)
   {
     return lts_eq_branching_bisim_sigref;
   }
+  else if (s == "branching-bisim-sig-par")
+  {
+    return lts_eq_branching_bisim_sigref_parallel;
+  }
   else if (s == "dpbranching-bisim")
   {
     return lts_eq_divergence_preserving_branching_bisim;
@@ -140,6 +157,10 @@ lts_equivalence parse_equivalence(std::string const& s)
   {
     return lts_eq_divergence_preserving_branching_bisim_sigref;
   }
+  else if (s == "dpbranching-bisim-sig-par")
+  {
+    return lts_eq_divergence_preserving_branching_bisim_sigref_parallel;
+  }
   else if (s == "weak-bisim")
   {
     return lts_eq_weak_bisim;
@@ -214,6 +235,8 @@ inline std::string print_equivalence(const lts_equivalence eq)
       return "bisim-dnj";
     case lts_eq_bisim_sigref:
       return "bisim-sig";
+    case lts_eq_bisim_sigref_parallel:
+      return "bisim-sig-par";
     case lts_eq_branching_bisim:
       return "branching-bisim";
     case lts_eq_branching_bisim_gv:
@@ -222,6 +245,8 @@ inline std::string print_equivalence(const lts_equivalence eq)
       return "branching-bisim-dnj";
     case lts_eq_branching_bisim_sigref:
       return "branching-bisim-sig";
+    case lts_eq_branching_bisim_sigref_parallel:
+      return "branching-bisim-sig-par";
     case lts_eq_divergence_preserving_branching_bisim:
       return "dpbranching-bisim";
     case lts_eq_divergence_preserving_branching_bisim_gv:
@@ -230,6 +255,8 @@ inline std::string print_equivalence(const lts_equivalence eq)
       return "dpbranching-bisim-dnj";
     case lts_eq_divergence_preserving_branching_bisim_sigref:
       return "dpbranching-bisim-sig";
+    case lts_eq_divergence_preserving_branching_bisim_sigref_parallel:
+      return "dpbranching-bisim-sig-par";
     case lts_eq_weak_bisim:
       return "weak-bisim";
     case lts_eq_divergence_preserving_weak_bisim:
@@ -277,6 +304,8 @@ inline std::string description(const lts_equivalence eq)
       return "strong bisimilarity using the O(m log n) algorithm directly on an LTS. This option is experimental.";
     case lts_eq_bisim_sigref:
       return "strong bisimilarity using the signature refinement algorithm [Blom/Orzan 2003]";
+    case lts_eq_bisim_sigref_parallel:
+      return "strong bisimilarity using the signature refinement algorithm, in which the signatures are computed by multiple threads";
     case lts_eq_branching_bisim:
       return "branching bisimilarity using the O(m log n) algorithm [Groote/Jansen/Keiren/Wijs 2017]";
     case lts_eq_branching_bisim_gv:
@@ -285,6 +314,8 @@ inline std::string description(const lts_equivalence eq)
       return "branching bisimilarity using the O(m log n) algorithm directly on an LTS. This option is experimental.";
     case lts_eq_branching_bisim_sigref:
       return "branching bisimilarity using the signature refinement algorithm [Blom/Orzan 2003]";
+    case lts_eq_branching_bisim_sigref_parallel:
+      return "branching bisimilarity using the signature refinement algorithm, in which the signatures are computed by multiple threads";
     case lts_eq_divergence_preserving_branching_bisim:
       return "divergence-preserving branching bisimilarity using the O(m log n) algorithm [Groote/Jansen/Keiren/Wijs 2017]";
     case lts_eq_divergence_preserving_branching_bisim_gv:
@@ -293,6 +324,8 @@ inline std::string description(const lts_equivalence eq)
       return "divergence-preserving branching bisimilarity using the O(m log n) algorithm directly on an LTS. This option is experimental.";
     case lts_eq_divergence_preserving_branching_bisim_sigref:
       return "divergence-preserving branching bisimilarity using the signature refinement algorithm [Blom/Orzan 2003]";
+    case lts_eq_divergence_preserving_branching_bisim_sigref_parallel:
+      return "divergence-preserving branching bisimilarity using the signature refinement algorithm, in which the signatures are computed by multiple threads";
     case lts_eq_weak_bisim:
       return "weak bisimilarity";
     case lts_eq_divergence_preserving_weak_bisim:
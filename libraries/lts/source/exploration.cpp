@@ -10,6 +10,7 @@
 #include <ctime>
 
 #include "mcrl2/utilities/logger.h"
+#include "mcrl2/utilities/metrics.h"
 #include "mcrl2/lps/resolve_name_clashes.h"
 #include "mcrl2/lps/detail/instantiate_global_variables.h"
 #include "mcrl2/lps/probabilistic_data_expression.h"
@@ -95,15 +96,6 @@ void lps2lts_algorithm::initialise_lts_generation(const lts_generation_options&
 
   assert(!(m_options.bithashing && m_options.outformat != lts_aut && m_options.outformat != lts_none));
 
-  if (m_options.bithashing)
-  {
-    m_bit_hash_table = bit_hash_table(m_options.bithashsize);
-  }
-  else
-  {
-    m_state_numbers = atermpp::indexed_set<lps::state>(m_options.initial_table_size, 50);
-  }
-
   m_num_states = 0;
   m_num_transitions = 0;
   m_level = 1;
@@ -115,6 +107,25 @@ void lps2lts_algorithm::initialise_lts_generation(const lts_generation_options&
   lps::stochastic_specification specification(m_options.specification);
   resolve_summand_variable_name_clashes(specification);
 
+  if (m_options.bithashing)
+  {
+    m_bit_hash_table = bit_hash_table(m_options.bithashsize);
+  }
+  else if (m_options.packed_states)
+  {
+    std::vector<std::size_t> widths;
+    for (const data::variable& v: specification.process().process_parameters())
+    {
+      widths.push_back(detail::packed_parameter_width(v.sort(), specification.data()));
+    }
+    m_state_numbers = detail::state_set(widths, m_options.initial_table_size);
+    mCRL2log(verbose) << "storing states as packed bit vectors." << std::endl;
+  }
+  else
+  {
+    m_state_numbers = detail::state_set(m_options.initial_table_size);
+  }
+
   if (m_options.outformat == lts_aut)
   {
     mCRL2log(verbose) << "writing state space in AUT format to '" << m_options.lts << "'." << std::endl;
@@ -351,6 +362,7 @@ bool lps2lts_algorithm::generate_lts(const lts_generation_options& options)
   }
 
   mCRL2log(verbose) << "generating state space with '" << m_options.expl_strat << "' strategy...\n";
+  m_exploration_start = std::chrono::steady_clock::now();
 
   if (m_options.max_states == 0)
   {
@@ -406,10 +418,22 @@ bool lps2lts_algorithm::generate_lts(const lts_generation_options& options)
     return false;
   }
 
+  update_exploration_metrics();
   finalise_lts_generation();
   return true;
 }
 
+void lps2lts_algorithm::update_exploration_metrics() const
+{
+  utilities::metrics_registry& registry = utilities::metrics();
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_exploration_start).count();
+  registry.gauge("lps2lts.states").set(m_num_states);
+  registry.gauge("lps2lts.transitions").set(m_num_transitions);
+  registry.gauge("lps2lts.exploration_seconds").set(seconds);
+  registry.gauge("lps2lts.states_per_second").set(seconds > 0 ? m_num_states / seconds : 0.0);
+  registry.gauge("lps2lts.transitions_per_second").set(seconds > 0 ? m_num_transitions / seconds : 0.0);
+}
+
 void lps2lts_algorithm::finalise_lts_generation()
 {
   if (m_options.outformat == lts_aut)
@@ -696,18 +720,11 @@ bool lps2lts_algorithm::search_divergence(
   {
     assert(is_hidden_summand(j->action().actions(),m_options.actions_internal_for_divergencies));
 
-    std::pair<std::size_t, bool> action_label_number = m_action_label_numbers.put(j->action().actions());
-    if (action_label_number.second)
-    {
-      assert(j->action().actions().size() != 0);
-      std::size_t action_number = m_output_lts.add_action(action_label_lts(j->action()));
-      assert(action_number == action_label_number.first);
-      static_cast <void>(action_number); // Avoid a warning when compiling in non debug mode.
-    }
+    const std::size_t action_label_number = add_action_label(*j);
 
     if (non_divergent_states.count(j->target_state())==0) // This state is not shown to be non convergent. So, an investigation is in order.
     {
-      typename COUNTER_EXAMPLE_GENERATOR::index_type i=divergence_loop.add_transition(action_label_number.first,state_pair.index());
+      typename COUNTER_EXAMPLE_GENERATOR::index_type i=divergence_loop.add_transition(action_label_number,state_pair.index());
       if (visited.insert(j->target_state()).second)
       {
         new_states.push_back(detail::state_index_pair<COUNTER_EXAMPLE_GENERATOR>(j->target_state(),i));
@@ -937,6 +954,34 @@ void lps2lts_algorithm::print_target_distribution_in_aut_format(
 }
 
 
+// Returns the number of the action label of the transition. A new action label is added to the output lts.
+std::size_t lps2lts_algorithm::add_action_label(const next_state_generator::transition_t& transition)
+{
+  const process::action_list& actions = transition.action().actions();
+  const std::size_t summand_index = transition.summand_index();
+  if (summand_index < m_summand_action_labels.size() && m_summand_action_labels[summand_index].first == actions)
+  {
+    return m_summand_action_labels[summand_index].second;
+  }
+
+  std::pair<std::size_t, bool> action_label_number = m_action_label_numbers.put(actions);
+  if (action_label_number.second)
+  {
+    assert(actions.size() != 0);
+    std::size_t action_number = m_output_lts.add_action(action_label_lts(transition.action()));
+    assert(action_number == action_label_number.first);
+    static_cast <void>(action_number); // Avoid a warning when compiling in non debug mode.
+    m_action_label_strings.push_back(lps::pp(lps::multi_action(actions)));
+  }
+
+  if (summand_index >= m_summand_action_labels.size())
+  {
+    m_summand_action_labels.resize(summand_index + 1, std::make_pair(action_label_lts::tau_action().actions(), 0));
+  }
+  m_summand_action_labels[summand_index] = std::make_pair(actions, action_label_number.first);
+  return action_label_number.first;
+}
+
 bool lps2lts_algorithm::add_transition(const lps::state& source_state, const next_state_generator::transition_t& transition)
 {
 
@@ -963,7 +1008,16 @@ bool lps2lts_algorithm::add_transition(const lps::state& source_state, const nex
 
     if (m_options.outformat == lts_aut)
     {
-      m_aut_file << "(" << source_state_number << ",\"" << lps::pp(transition.action()) << "\",";
+      m_aut_file << "(" << source_state_number << ",\"";
+      if (transition.action().has_time())
+      {
+        m_aut_file << lps::pp(transition.action());
+      }
+      else
+      {
+        m_aut_file << m_action_label_strings[add_action_label(transition)];
+      }
+      m_aut_file << "\",";
     }
 
     print_target_distribution_in_aut_format(transition.other_target_states(),destination_state_number.first,source_state);
@@ -976,20 +1030,13 @@ bool lps2lts_algorithm::add_transition(const lps::state& source_state, const nex
   }
   else
   {
-    std::pair<std::size_t, bool> action_label_number = m_action_label_numbers.put(transition.action().actions());
-    if (action_label_number.second)
-    {
-      assert(transition.action().actions().size() != 0);
-      std::size_t action_number = m_output_lts.add_action(action_label_lts(transition.action()));
-      assert(action_number == action_label_number.first);
-      static_cast <void>(action_number); // Avoid a warning when compiling in non debug mode.
-    }
+    const std::size_t action_label_number = add_action_label(transition);
     std::size_t number_of_a_new_probabilistic_state=m_output_lts.add_probabilistic_state(
                                     create_a_probabilistic_state_from_target_distribution(
                                                destination_state_number.first,
                                                transition.other_target_states(),
                                                source_state)); // Add a new probabilistic state.
-    m_output_lts.add_transition(mcrl2::lts::transition(source_state_number, action_label_number.first, number_of_a_new_probabilistic_state));
+    m_output_lts.add_transition(mcrl2::lts::transition(source_state_number, action_label_number, number_of_a_new_probabilistic_state));
   }
 
   m_num_transitions++;
@@ -1146,6 +1193,7 @@ void lps2lts_algorithm::generate_lts_breadth_todo_max_is_npos()
       last_log_time = new_log_time;
       std::size_t lvl_states = m_num_states - start_level_seen;
       std::size_t lvl_transitions = m_num_transitions - start_level_transitions;
+      update_exploration_metrics();
       mCRL2log(status) << std::fixed << std::setprecision(2)
                        << m_num_states << "st, " << m_num_transitions << "tr"
                        << ", explored " << 100.0 * ((float)current_state / m_num_states)
@@ -1219,6 +1267,7 @@ void lps2lts_algorithm::generate_lts_breadth_todo_max_is_not_npos(const next_sta
       last_log_time = new_log_time;
       std::size_t lvl_states = m_num_states - start_level_seen;
       std::size_t lvl_transitions = m_num_transitions - start_level_transitions;
+      update_exploration_metrics();
       mCRL2log(status) << std::fixed << std::setprecision(2)
                        << m_num_states << "st, " << m_num_transitions << "tr"
                        << ", explored " << 100.0 * ((float)current_state / m_num_states)
@@ -8,6 +8,10 @@
 //
 /// \file liblts_aut.cpp
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
 #include <string>
 #include <sstream>
 #include <fstream>
@@ -20,24 +24,196 @@ using namespace mcrl2::lts;
 using namespace std;
 
 
-static void read_newline(istream& is, const std::size_t line_no)
+namespace
 {
-  char ch;
-  is.get(ch);
+
+/// \brief Reads the characters of a .aut file in large blocks, and provides hand-written scanning of
+///        the tokens of the format, which is much faster than reading them with the operators of istream.
+class aut_scanner
+{
+  protected:
+    std::istream& m_is;
+    std::vector<char> m_buffer;
+    const char* m_pos;
+    const char* m_end;
+    std::size_t m_line_no = 1;
+
+    // Reads the next block of characters. Returns false if the end of the input has been reached.
+    bool fill()
+    {
+      if (!m_is)
+      {
+        return false;
+      }
+      m_is.read(m_buffer.data(), m_buffer.size());
+      m_pos = m_buffer.data();
+      m_end = m_pos + m_is.gcount();
+      return m_pos != m_end;
+    }
+
+  public:
+    static bool is_space(int ch)
+    {
+      return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t' || ch == '\v' || ch == '\f';
+    }
+
+    static bool is_digit(int ch)
+    {
+      return '0' <= ch && ch <= '9';
+    }
+
+    explicit aut_scanner(std::istream& is, std::size_t buffer_size = 1 << 20)
+      : m_is(is), m_buffer(buffer_size)
+    {
+      m_pos = m_buffer.data();
+      m_end = m_pos;
+    }
+
+    /// \brief Returns the number of the line at the current position.
+    std::size_t line_no() const
+    {
+      return m_line_no;
+    }
+
+    /// \brief Returns the next character, or EOF if the end of the input has been reached.
+    int peek()
+    {
+      if (m_pos == m_end && !fill())
+      {
+        return EOF;
+      }
+      return static_cast<unsigned char>(*m_pos);
+    }
+
+    /// \brief Returns the next character and moves past it, or returns EOF if the end of the input has been reached.
+    int get()
+    {
+      int ch = peek();
+      if (ch != EOF)
+      {
+        if (ch == '\n')
+        {
+          m_line_no++;
+        }
+        m_pos++;
+      }
+      return ch;
+    }
+
+    void skip_whitespace()
+    {
+      while (is_space(peek()))
+      {
+        get();
+      }
+    }
+
+    /// \brief Skips whitespace and returns the next character, which is consumed.
+    int get_non_whitespace()
+    {
+      skip_whitespace();
+      return get();
+    }
+
+    /// \brief Skips whitespace and returns the next character, which is not consumed.
+    int peek_non_whitespace()
+    {
+      skip_whitespace();
+      return peek();
+    }
+
+    /// \brief Skips whitespace and reads the digits of a natural number, that are appended to s.
+    /// \details Returns false if there are no digits.
+    bool read_digits(std::string& s)
+    {
+      skip_whitespace();
+      const std::size_t size = s.size();
+      while (is_digit(peek()))
+      {
+        s.push_back(static_cast<char>(get()));
+      }
+      return s.size() != size;
+    }
+
+    /// \brief Skips whitespace and reads a natural number, that is stored in result.
+    /// \details Returns false if there is no number.
+    bool read_natural_number(std::size_t& result)
+    {
+      skip_whitespace();
+      if (!is_digit(peek()))
+      {
+        return false;
+      }
+      result = 0;
+      while (m_pos != m_end || fill())
+      {
+        const char ch = *m_pos;
+        if (!is_digit(ch))
+        {
+          break;
+        }
+        const std::size_t digit = static_cast<std::size_t>(ch - '0');
+        if (result > (std::numeric_limits<std::size_t>::max() - digit) / 10)
+        {
+          throw mcrl2::runtime_error("The number at line " + std::to_string(m_line_no) + " is too large.");
+        }
+        result = result * 10 + digit;
+        m_pos++;
+      }
+      return true;
+    }
+
+    /// \brief Reads the characters up to the first occurrence of the character delimiter, and stores them in s.
+    /// \details The delimiter is consumed, but not stored. Returns false if the end of the input is reached first.
+    bool read_until(char delimiter, std::string& s)
+    {
+      s.clear();
+      while (m_pos != m_end || fill())
+      {
+        const char* p = static_cast<const char*>(std::memchr(m_pos, delimiter, m_end - m_pos));
+        const char* last = p == nullptr ? m_end : p;
+        s.append(m_pos, last);
+        m_line_no += std::count(m_pos, last, '\n');
+        if (p != nullptr)
+        {
+          m_pos = p + 1;
+          return true;
+        }
+        m_pos = m_end;
+      }
+      return false;
+    }
+};
+
+} // end anonymous namespace
+
+// Whitespace in labels is not significant, and it is removed.
+static void remove_whitespace(std::string& s)
+{
+  auto is_space = [](char ch) { return aut_scanner::is_space(static_cast<unsigned char>(ch)); };
+  if (std::find_if(s.begin(), s.end(), is_space) != s.end())
+  {
+    s.erase(std::remove_if(s.begin(), s.end(), is_space), s.end());
+  }
+}
+
+static void read_newline(aut_scanner& in, const std::size_t line_no)
+{
+  int ch = in.get();
 
   // Skip over spaces
   while (ch == ' ')
   {
-    is.get(ch);
+    ch = in.get();
   }
 
   // Windows systems typically have a carriage return before a newline.
   if (ch == '\r')
   {
-    is.get(ch);
+    ch = in.get();
   }
 
-  if (ch != '\n' && !is.eof()) // Last line does not need to be terminated with an eoln.
+  if (ch != '\n' && ch != EOF) // Last line does not need to be terminated with an eoln.
   {
     if (line_no==1)
     {
@@ -50,40 +226,22 @@ static void read_newline(istream& is, const std::size_t line_no)
   }
 }
 
-// reads a number, puts it in s, and reads one extra character, which must be either a space or a closing bracket.
-static void read_natural_number_to_string(istream& is, string& s, const std::size_t line_no)
+static std::size_t read_state(aut_scanner& in, const std::size_t line_no)
 {
-  assert(s.empty());
-  char ch;
-  is >> skipws >> ch;
-  for( ; isdigit(ch) ; is.get(ch))
-  {
-    s.push_back(ch);
-  }
-  is.putback(ch);
-  if (s.empty())
+  std::size_t state;
+  if (!in.read_natural_number(state))
   {
-    throw mcrl2::runtime_error("Expect a number at line " + std::to_string(line_no) + ".");
+    throw mcrl2::runtime_error("Expect a state number at line " + std::to_string(line_no) + ".");
   }
+  return state;
 }
 
-template <class AUT_LTS_TYPE>
-static std::size_t find_label_index(const string& s, unordered_map < string, std::size_t >& labs, AUT_LTS_TYPE& l)
+static void read_digits(aut_scanner& in, std::string& s, const std::size_t line_no)
 {
-  std::size_t label;
-
-  assert(labs.at(action_label_string::tau_action())==0);
-  const unordered_map < string, std::size_t >::const_iterator i=labs.find(s);
-  if (i==labs.end())
-  {
-    label=l.add_action(action_label_string(s));
-    labs[s]=label;
-  }
-  else
+  if (!in.read_digits(s))
   {
-    label=i->second;
+    throw mcrl2::runtime_error("Expect a number at line " + std::to_string(line_no) + ".");
   }
-  return label;
 }
 
 static void check_state(std::size_t state, std::size_t number_of_states, std::size_t line_no)
@@ -96,7 +254,7 @@ static void check_state(std::size_t state, std::size_t number_of_states, std::si
 } 
 
 static void check_states(detail::lts_aut_base::probabilistic_state& probability_state,
-                         std::size_t number_of_states, std::size_t line_no)
+                  std::size_t number_of_states, std::size_t line_no)
 {
   for(detail::lts_aut_base::state_probability_pair& p: probability_state)
   {
@@ -109,135 +267,104 @@ static void check_states(detail::lts_aut_base::probabilistic_state& probability_
 // last state number is put in state. The remainder as pairs
 // in the vector. Typical expected input is 3 2/3 4 1/6 78 1/6 3.
 static void read_probabilistic_state(
-  istream& is,
+  aut_scanner& in,
   mcrl2::lts::probabilistic_lts_aut_t::probabilistic_state_t& result,
   const std::size_t line_no)
 {
   assert(result.size()==0);
 
-  std::size_t state;
-
-  is >> skipws >> state;
-
-  if (!is.good())
-  {
-    throw mcrl2::runtime_error("Expect a state number at line " + std::to_string(line_no) + ".");
-  }
+  std::size_t state = read_state(in, line_no);
 
   // Check whether the next character is a digit. If so a probability follows.
-  char ch;
-  is >> skipws >> ch;
-  is.putback(ch);
-
-  if (!isdigit(ch))
+  if (!aut_scanner::is_digit(in.peek_non_whitespace()))
   {
     // There is only a single state.
     result.set(state);
     return;
   }
-  bool ready=false;
 
   mcrl2::lts::probabilistic_arbitrary_precision_fraction remainder=mcrl2::lts::probabilistic_arbitrary_precision_fraction::one();
-  while (is.good() && !ready)
+  do
   {
     // Now read a probabilities followed by the next state.
     string enumerator;
-    read_natural_number_to_string(is,enumerator,line_no);
-    char ch;
-    is >> skipws >> ch;
-    if (ch != '/')
+    read_digits(in,enumerator,line_no);
+    if (in.get_non_whitespace() != '/')
     {
       throw mcrl2::runtime_error("Expect a / in a probability at line " + std::to_string(line_no) + ".");
     }
 
     string denominator;
-    read_natural_number_to_string(is,denominator,line_no);
+    read_digits(in,denominator,line_no);
     mcrl2::lts::probabilistic_arbitrary_precision_fraction frac(enumerator,denominator);
     remainder=remainder-frac;
     result.add(state, frac);
-    
-    is >> skipws >> state;
-
-    if (!is.good())
-    {
-      throw mcrl2::runtime_error("Expect a state number at line " + std::to_string(line_no) + ".");
-    }
-
-    // Check whether the next character is a digit.
-    
-    is >> skipws >> ch;
-    is.putback(ch);
 
-    if (!isdigit(ch))
-    {
-      ready=true;
-    }
+    state = read_state(in, line_no);
   }
+  while (aut_scanner::is_digit(in.peek_non_whitespace())); // Check whether the next character is a digit.
   
   result.add(state, remainder);
 }
 
-
 static void read_aut_header(
-  istream& is,
+  aut_scanner& in,
   detail::lts_aut_base::probabilistic_state& initial_state,
   std::size_t& num_transitions,
   std::size_t& num_states)
 {
-  string s;
-  is.width(3);
-  is >> skipws >> s;
-
-  if (s!="des")
+  in.skip_whitespace();
+  if (in.get() != 'd' || in.get() != 'e' || in.get() != 's')
   {
     throw mcrl2::runtime_error("Expect an .aut file to start with 'des'.");
   }
 
-  char ch;
-  is >> skipws >> ch;
-
-  if (ch != '(')
+  if (in.get_non_whitespace() != '(')
   {
     throw mcrl2::runtime_error("Expect an opening bracket '(' after 'des' in the first line of a .aut file.");
   }
 
-  read_probabilistic_state(is,initial_state,1);
+  read_probabilistic_state(in,initial_state,1);
 
-  is >> skipws >> ch;
-  if (ch != ',')
+  if (in.get_non_whitespace() != ',')
   {
     throw mcrl2::runtime_error("Expect a comma after the first number in the first line of a .aut file.");
   }
 
-  is >> skipws >> num_transitions;
+  if (!in.read_natural_number(num_transitions))
+  {
+    throw mcrl2::runtime_error("Expect the number of transitions in the first line of a .aut file.");
+  }
 
-  is >> skipws >> ch;
-  if (ch != ',')
+  if (in.get_non_whitespace() != ',')
   {
     throw mcrl2::runtime_error("Expect a comma after the second number in the first line of a .aut file.");
   }
 
-  is >> skipws >> num_states;
-
-  is >> ch;
+  if (!in.read_natural_number(num_states))
+  {
+    throw mcrl2::runtime_error("Expect the number of states in the first line of a .aut file.");
+  }
 
-  if (ch != ')')
+  if (in.get_non_whitespace() != ')')
   {
     throw mcrl2::runtime_error("Expect a closing bracket ')' after the third number in the first line of a .aut file.");
   }
 
-  read_newline(is,1);
+  read_newline(in,1);
 }
 
+// Reads the source and the label of a transition. Returns false if the end of the input has been reached.
+// The number of the line at which the transition starts is stored in line_no.
 static bool read_initial_part_of_an_aut_transition(
-  istream& is,
+  aut_scanner& in,
   std::size_t& from,
   string& label,
-  const std::size_t line_no)
+  std::size_t& line_no)
 {
-  char ch;
-  is >> skipws >> ch;
-  if (is.eof())
+  int ch = in.get_non_whitespace();
+  line_no = in.line_no();
+  if (ch == EOF)
   {
     return false;
   }
@@ -246,41 +373,27 @@ static bool read_initial_part_of_an_aut_transition(
     throw mcrl2::runtime_error("Expect opening bracket at line " + std::to_string(line_no) + ".");
   }
 
-  is >> skipws >> from;
+  from = read_state(in, line_no);
 
-  is >> skipws >> ch;
-  if (ch != ',')
+  if (in.get_non_whitespace() != ',')
   {
     throw mcrl2::runtime_error("Expect that the first number is followed by a comma at line " + std::to_string(line_no) + ".");
   }
 
-  is >> skipws >> ch;
-  if (ch == '"')
+  if (in.peek_non_whitespace() == '"')
   {
-    label="";
-    is >> ch;
-    while ((ch != '"') && !is.eof())
-    {
-      label.push_back(ch);
-      is >> ch;
-    }
-
-    if (ch != '"')
+    in.get();
+    if (!in.read_until('"', label))
     {
       throw mcrl2::runtime_error("Expect that the second item is a quoted label (using \") at line " + std::to_string(line_no) + ".");
     }
-    is >> skipws >> ch;
+    ch = in.get_non_whitespace();
   }
   else
   {
-    label = ch;
-    is >> ch;
-    while ((ch != ',') && !is.eof())
-    {
-      label.push_back(ch);
-      is >> ch;
-    }
+    ch = in.read_until(',', label) ? ',' : EOF;
   }
+  remove_whitespace(label);
 
   if (ch != ',')
   {
@@ -291,63 +404,126 @@ static bool read_initial_part_of_an_aut_transition(
 }
 
 static bool read_aut_transition(
-  istream& is,
+  aut_scanner& in,
   std::size_t& from,
   string& label,
   detail::lts_aut_base::probabilistic_state& target_probabilistic_state,
-  const std::size_t line_no)
+  std::size_t& line_no)
 {
-  if (!read_initial_part_of_an_aut_transition(is,from,label,line_no))
+  if (!read_initial_part_of_an_aut_transition(in,from,label,line_no))
   {
     return false;
   }
 
-  read_probabilistic_state(is,target_probabilistic_state,line_no);
+  read_probabilistic_state(in,target_probabilistic_state,line_no);
 
-  char ch;
-  is >> ch;
-  if (ch != ')')
+  if (in.get_non_whitespace() != ')')
   {
     throw mcrl2::runtime_error("Expect a closing bracket at the end of the transition at line " + std::to_string(line_no) + ".");
   }
 
-  read_newline(is,line_no);
+  read_newline(in,line_no);
   return true;
 }
 
 static bool read_aut_transition(
-  istream& is,
+  aut_scanner& in,
   std::size_t& from,
   string& label,
   std::size_t& to,
-  const std::size_t line_no)
+  std::size_t& line_no)
 {
-  if (!read_initial_part_of_an_aut_transition(is,from,label,line_no))
+  if (!read_initial_part_of_an_aut_transition(in,from,label,line_no))
   {
     return false;
   }
 
-  is >> skipws >> to;
+  to = read_state(in, line_no);
 
-  char ch;
-  is >> ch;
-  if (ch != ')')
+  if (in.get_non_whitespace() != ')')
   {
     throw mcrl2::runtime_error("Expect a closing bracket at the end of the transition at line " + std::to_string(line_no) + ".");
   }
 
-  read_newline(is,line_no);
+  read_newline(in,line_no);
   return true;
 }
 
+static void check_number_of_transitions(std::size_t number_of_transitions_read, std::size_t number_of_transitions)
+{
+  if (number_of_transitions != number_of_transitions_read)
+  {
+    throw mcrl2::runtime_error("number of transitions read (" + std::to_string(number_of_transitions_read) +
+                               ") does not correspond to the number of transition given in the header (" + std::to_string(number_of_transitions) + ").");
+  }
+}
+
+// Reads a non probabilistic .aut file. The function header is applied to the initial state, the number of transitions
+// and the number of states, and the function add_transition to the source, label and target of each transition.
+template <typename HeaderFunction, typename TransitionFunction>
+static void read_aut_transitions(std::istream& is, HeaderFunction header, TransitionFunction add_transition)
+{
+  aut_scanner in(is);
+  std::size_t ntrans=0, nstate=0;
+
+  detail::lts_aut_base::probabilistic_state initial_probabilistic_state;
+  read_aut_header(in,initial_probabilistic_state,ntrans,nstate);
+  
+  if (initial_probabilistic_state.size()>1)
+  {
+    throw mcrl2::runtime_error("Encountered an initial probability distribution while reading an non probabilistic .aut file.");
+  }
+
+  check_states(initial_probabilistic_state, nstate, 1);
+
+  if (nstate==0)
+  {
+    throw mcrl2::runtime_error("cannot parse AUT input that has no states; at least an initial state is required.");
+  }
+
+  header(initial_probabilistic_state.begin()->state(), ntrans, nstate);
+
+  std::size_t number_of_transitions = 0;
+  std::size_t line_no;
+  std::size_t from, to;
+  string s;
+  while (read_aut_transition(in,from,s,to,line_no))
+  {
+    check_state(from, nstate, line_no);
+    check_state(to, nstate, line_no);
+    add_transition(from, s, to);
+    number_of_transitions++;
+  }
+
+  check_number_of_transitions(number_of_transitions, ntrans);
+}
+
+template <class AUT_LTS_TYPE>
+static std::size_t find_label_index(const string& s, unordered_map < string, std::size_t >& labs, AUT_LTS_TYPE& l)
+{
+  std::size_t label;
+
+  assert(labs.at(action_label_string::tau_action())==0);
+  const unordered_map < string, std::size_t >::const_iterator i=labs.find(s);
+  if (i==labs.end())
+  {
+    label=l.add_action(action_label_string(s));
+    labs[s]=label;
+  }
+  else
+  {
+    label=i->second;
+  }
+  return label;
+}
 
 static void read_from_aut(probabilistic_lts_aut_t& l, istream& is)
 {
-  std::size_t line_no = 1;
+  aut_scanner in(is);
   std::size_t ntrans=0, nstate=0;
 
   detail::lts_aut_base::probabilistic_state initial_probabilistic_state;
-  read_aut_header(is,initial_probabilistic_state,ntrans,nstate);
+  read_aut_header(in,initial_probabilistic_state,ntrans,nstate);
 
   // The two unordered maps below are used to determine a unique index for each probabilistic state.
   // Because most states consist of one probabilistic state, the unordered maps are duplicated into
@@ -356,7 +532,7 @@ static void read_from_aut(probabilistic_lts_aut_t& l, istream& is)
   unordered_map < std::size_t, std::size_t> indices_of_single_probabilistic_states;
   unordered_map < detail::lts_aut_base::probabilistic_state, std::size_t> indices_of_multiple_probabilistic_states;
   
-  check_states(initial_probabilistic_state, nstate, line_no);
+  check_states(initial_probabilistic_state, nstate, 1);
 
   if (nstate==0)
   {
@@ -371,20 +547,12 @@ static void read_from_aut(probabilistic_lts_aut_t& l, istream& is)
   l.set_initial_probabilistic_state(initial_probabilistic_state); 
 
   detail::lts_aut_base::probabilistic_state probabilistic_target_state;
+  std::size_t line_no;
   std::size_t from;
   string s;
 
-  while (!is.eof())
+  while (read_aut_transition(in,from,s,probabilistic_target_state,line_no))
   {
-    probabilistic_target_state.clear();
-
-    line_no++;
-
-    if (!read_aut_transition(is,from,s,probabilistic_target_state,line_no))
-    {
-      break; // eof encountered
-    }
-
     check_state(from, nstate, line_no);
     check_states(probabilistic_target_state, nstate, line_no);
     // Check whether probabilistic state exists. 
@@ -412,66 +580,31 @@ static void read_from_aut(probabilistic_lts_aut_t& l, istream& is)
     }
 
     l.add_transition(transition(from,find_label_index(s,action_labels,l),index));
+    probabilistic_target_state.clear();
   }
 
-  if (ntrans != l.num_transitions())
-  {
-    throw mcrl2::runtime_error("number of transitions read (" + std::to_string(l.num_transitions()) +
-                               ") does not correspond to the number of transition given in the header (" + std::to_string(ntrans) + ").");
-  }
+  check_number_of_transitions(l.num_transitions(), ntrans);
 }
 
 static void read_from_aut(lts_aut_t& l, istream& is)
 {
-  std::size_t line_no = 1;
-  std::size_t ntrans=0, nstate=0;
-
-  detail::lts_aut_base::probabilistic_state initial_probabilistic_state;
-  read_aut_header(is,initial_probabilistic_state,ntrans,nstate);
-  
-  if (initial_probabilistic_state.size()>1)
-  {
-    throw mcrl2::runtime_error("Encountered an initial probability distribution while reading an non probabilistic .aut file.");
-  }
-
-  check_states(initial_probabilistic_state, nstate, line_no);
-
-  if (nstate==0)
-  {
-    throw mcrl2::runtime_error("cannot parse AUT input that has no states; at least an initial state is required.");
-  }
-
-  l.set_num_states(nstate,false);
-  l.clear_transitions(ntrans); // Reserve enough space for the transitions.
-  
   unordered_map < string, std::size_t > action_labels;
   action_labels[action_label_string::tau_action()]=0; // A tau action is always stored at position 0.
-  l.set_initial_state(initial_probabilistic_state.begin()->state()); 
 
-  std::size_t from, to;
-  string s;
-  while (!is.eof())
-  {
-    line_no++;
-
-    if (!read_aut_transition(is,from,s,to,line_no))
+  read_aut_transitions(is,
+    [&](std::size_t initial_state, std::size_t ntrans, std::size_t nstate)
     {
-      break; // eof encountered
+      l.set_num_states(nstate,false);
+      l.clear_transitions(ntrans); // Reserve enough space for the transitions.
+      l.set_initial_state(initial_state);
+    },
+    [&](std::size_t from, const std::string& label, std::size_t to)
+    {
+      l.add_transition(transition(from,find_label_index(label,action_labels,l),to));
     }
-
-    check_state(from, nstate, line_no);
-    check_state(to, nstate, line_no);
-    l.add_transition(transition(from,find_label_index(s,action_labels,l),to));
-  }
-
-  if (ntrans != l.num_transitions())
-  {
-    throw mcrl2::runtime_error("number of transitions read (" + std::to_string(l.num_transitions()) +
-                               ") does not correspond to the number of transition given in the header (" + std::to_string(ntrans) + ").");
-  }
+  );
 }
 
-
 static void write_probabilistic_state(const detail::lts_aut_base::probabilistic_state& prob_state, ostream& os)
 {
   mcrl2::lts::probabilistic_arbitrary_precision_fraction previous_probability;
@@ -500,9 +633,17 @@ static void write_to_aut(const probabilistic_lts_aut_t& l, ostream& os)
 
   os << "," << l.num_transitions() << "," << l.num_states() << ")" << "\n";
 
+  // The labels are printed only once.
+  std::vector<std::string> labels;
+  labels.reserve(l.num_action_labels());
+  for (std::size_t i = 0; i < l.num_action_labels(); ++i)
+  {
+    labels.push_back(pp(l.action_label(l.apply_hidden_label_map(i))));
+  }
+
   for (const transition& t: l.get_transitions())
   {
-    os << "(" << t.from() << ",\"" << pp(l.action_label(l.apply_hidden_label_map(t.label()))) << "\",";
+    os << "(" << t.from() << ",\"" << labels[t.label()] << "\",";
     write_probabilistic_state(l.probabilistic_state(t.to()),os);
     os << ")" << "\n";
   }
@@ -510,14 +651,18 @@ static void write_to_aut(const probabilistic_lts_aut_t& l, ostream& os)
 
 static void write_to_aut(const lts_aut_t& l, ostream& os)
 {
-  // Do not use "endl" below to avoid flushing. Use "\n" instead.
-  os << "des (" << l.initial_state() << "," << l.num_transitions() << "," << l.num_states() << ")" << "\n"; 
+  // The labels are printed only once.
+  std::vector<std::string> labels;
+  labels.reserve(l.num_action_labels());
+  for (std::size_t i = 0; i < l.num_action_labels(); ++i)
+  {
+    labels.push_back(pp(l.action_label(l.apply_hidden_label_map(i))));
+  }
 
+  aut_writer out(os, l.initial_state(), l.num_transitions(), l.num_states());
   for (const transition& t: l.get_transitions())
   {
-    os << "(" << t.from() << ",\"" 
-       << pp(l.action_label(l.apply_hidden_label_map(t.label()))) << "\"," 
-       << t.to() << ")" << "\n";
+    out.write_transition(t.from(), labels[t.label()], t.to());
   }
 }
 
@@ -526,6 +671,65 @@ namespace mcrl2
 namespace lts
 {
 
+void read_aut(std::istream& is,
+              const std::function<void(std::size_t initial_state, std::size_t number_of_transitions, std::size_t number_of_states)>& header,
+              const std::function<void(std::size_t from, const std::string& label, std::size_t to)>& transition)
+{
+  read_aut_transitions(is, header, transition);
+}
+
+aut_writer::aut_writer(std::ostream& os, std::size_t initial_state, std::size_t number_of_transitions, std::size_t number_of_states)
+  : m_os(os)
+{
+  m_buffer.reserve(1 << 16);
+  m_buffer.append("des (");
+  write_number(initial_state);
+  m_buffer.push_back(',');
+  write_number(number_of_transitions);
+  m_buffer.push_back(',');
+  write_number(number_of_states);
+  m_buffer.append(")\n");
+}
+
+aut_writer::~aut_writer()
+{
+  flush();
+}
+
+void aut_writer::write_number(std::size_t n)
+{
+  char digits[std::numeric_limits<std::size_t>::digits10 + 1];
+  char* p = digits + sizeof(digits);
+  do
+  {
+    *--p = static_cast<char>('0' + n % 10);
+    n = n / 10;
+  }
+  while (n != 0);
+  m_buffer.append(p, digits + sizeof(digits));
+}
+
+void aut_writer::write_transition(std::size_t from, const std::string& label, std::size_t to)
+{
+  m_buffer.push_back('(');
+  write_number(from);
+  m_buffer.append(",\"");
+  m_buffer.append(label);
+  m_buffer.append("\",");
+  write_number(to);
+  m_buffer.append(")\n");
+  if (m_buffer.size() >= (1 << 16))
+  {
+    flush();
+  }
+}
+
+void aut_writer::flush()
+{
+  m_os.write(m_buffer.data(), m_buffer.size());
+  m_buffer.clear();
+}
+
 void probabilistic_lts_aut_t::load(const string& filename)
 {
   if (filename=="")
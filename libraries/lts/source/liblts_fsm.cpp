@@ -119,12 +119,21 @@ struct fsm_writer
   void write_transitions()
   {
     mCRL2log(log::verbose) << "writing transitions..." << std::endl;
+
+    // The labels are printed only once.
+    std::vector<std::string> labels;
+    labels.reserve(fsm.num_action_labels());
+    for (std::size_t i = 0; i < fsm.num_action_labels(); ++i)
+    {
+      labels.push_back(mcrl2::lts::pp(fsm.action_label(fsm.apply_hidden_label_map(i))));
+    }
+
     for (const transition& t: fsm.get_transitions())
     {
       // correct state numbering, by adding 1.
       out << swap_initial_state(t.from()) + 1 << " ";
       write_probabilistic_state(fsm.probabilistic_state(t.to())); 
-      out << " \"" << mcrl2::lts::pp(fsm.action_label(fsm.apply_hidden_label_map(t.label()))) << "\"" << std::endl;
+      out << " \"" << labels[t.label()] << "\"\n"; // Intentionally do not use std::endl to avoid flushing.
     }
   }
 
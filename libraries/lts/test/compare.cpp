@@ -8,8 +8,10 @@
 
 #include <boost/test/included/unit_test_framework.hpp>
 
+#include "mcrl2/lps/parse.h"
 #include "mcrl2/lts/lts_algorithm.h"
 #include "mcrl2/lts/lts_aut.h"
+#include "mcrl2/lts/detail/liblts_onthefly_refinement.h"
 
 using namespace mcrl2::lts;
 
@@ -389,6 +391,50 @@ BOOST_AUTO_TEST_CASE(verum_test)
   BOOST_CHECK(!preorder_compare(lts_spec,lts_impl,lts_pre_trace_anti_chain));
 }
 
+static inline
+bool onthefly_compare(const std::string& lps_text, const std::string& aut_text, refinement_type refinement, bool weak_reduction)
+{
+  mcrl2::lps::stochastic_specification specification;
+  mcrl2::lps::parse_lps(lps_text, specification);
+  detail::onthefly_action_labels labels;
+  detail::lps_onthefly_state_space impl(specification, labels, std::vector<std::string>());
+  detail::lts_onthefly_state_space<lts_aut_t> spec(parse_aut(aut_text), labels, std::vector<std::string>());
+  return onthefly_refinement_checker(impl, spec, refinement, weak_reduction);
+}
+
+// a.(b+c) as a linear process
+const std::string lps_l1 =
+  "act a, b, c;\n"
+  "proc P(s: Nat) = (s == 0) -> a . P(1) + (s == 1) -> b . P(2) + (s == 1) -> c . P(2);\n"
+  "init P(0);\n";
+
+// A process that does an unbounded number of a's, and a b after the third a.
+const std::string lps_counter =
+  "act a, b;\n"
+  "proc P(n: Nat) = a . P(n + 1) + (n == 3) -> b . P(n);\n"
+  "init P(0);\n";
+
+// a*
+const std::string a_loop =
+  "des (0,1,1)\n"
+  "(0,\"a\",0)\n";
+
+BOOST_AUTO_TEST_CASE(onthefly_refinement_test)
+{
+  BOOST_CHECK(onthefly_compare(lps_l1, l1, trace, false));
+  BOOST_CHECK(onthefly_compare(lps_l1, l1, failures, false));
+  BOOST_CHECK(onthefly_compare(lps_l1, l2, trace, false));
+  BOOST_CHECK(onthefly_compare(lps_l1, l2, failures, false));
+  BOOST_CHECK(!onthefly_compare(lps_l1, l3, trace, false));
+  BOOST_CHECK(onthefly_compare(lps_l1, l3, trace, true));
+  BOOST_CHECK(onthefly_compare(lps_l1, l3, failures, true));
+  BOOST_CHECK(onthefly_compare(lps_l1, l3, failures_divergence, true));
+  BOOST_CHECK(!onthefly_compare(lps_l1, a, trace, false));
+
+  // The state space of lps_counter is infinite, so the check only terminates because it is done on the fly.
+  BOOST_CHECK(!onthefly_compare(lps_counter, a_loop, trace, false));
+}
+
 
 
 
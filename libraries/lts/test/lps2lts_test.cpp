@@ -422,6 +422,39 @@ BOOST_AUTO_TEST_CASE(test_max_states)
   BOOST_CHECK_LT(result.num_states(), 10u);
 }
 
+BOOST_AUTO_TEST_CASE(test_packed_states)
+{
+  std::string spec(
+  "sort D = struct d1 | d2 | d3;\n"
+  "act a: D;\n"
+  "    b;\n"
+  "proc P(d: D, c: Bool, n: Nat) =\n"
+  "  sum e: D. (n < 5) -> a(e) . P(e, !c, n+1)\n"
+  "+ c -> b . P(d, false, n);\n"
+  "init P(d1, true, 0);\n");
+
+  lps::stochastic_specification specification;
+  parse_lps(spec,specification);
+
+  lts::lts_aut_t expected = translate_lps_to_lts<lts::lts_aut_t>(specification);
+
+  lts::lts_generation_options options;
+  options.trace_prefix = "lps2lts_test";
+  options.specification = specification;
+  options.lts = utilities::temporary_filename("lps2lts_test_file");
+  options.packed_states = true;
+
+  lts::lts_aut_t result;
+  options.outformat = result.type();
+  lts::lps2lts_algorithm lps2lts;
+  lps2lts.generate_lts(options);
+  result.load(options.lts);
+  remove(options.lts.c_str()); // Clean up after ourselves
+
+  BOOST_CHECK_EQUAL(result.num_states(), expected.num_states());
+  BOOST_CHECK_EQUAL(result.num_transitions(), expected.num_transitions());
+}
+
 BOOST_AUTO_TEST_CASE(test_interaction_sum_and_assignment_notation1)
 {
   std::string spec(
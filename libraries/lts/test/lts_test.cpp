@@ -82,6 +82,9 @@ static void reduce_lts_in_various_ways(const std::string& test_description,
   reduce(l,lts::lts_eq_bisim_sigref);
   test_lts(test_description + " (bisimulation signature [Blom/Orzan 2003])",l, expected.labels_bisimulation,expected.states_bisimulation, expected.transitions_bisimulation);
   l=l_in;
+  reduce(l,lts::lts_eq_bisim_sigref_parallel);
+  test_lts(test_description + " (bisimulation signature, multi-threaded)",l, expected.labels_bisimulation,expected.states_bisimulation, expected.transitions_bisimulation);
+  l=l_in;
   reduce(l,lts::lts_eq_branching_bisim);
   test_lts(test_description + " (branching bisimulation [Groote/Jansen/Keiren/Wijs 2017])",l, expected.labels_branching_bisimulation,expected.states_branching_bisimulation, expected.transitions_branching_bisimulation);
   l=l_in;
@@ -94,6 +97,9 @@ static void reduce_lts_in_various_ways(const std::string& test_description,
   reduce(l,lts::lts_eq_branching_bisim_sigref);
   test_lts(test_description + " (branching bisimulation signature [Blom/Orzan 2003])",l, expected.labels_branching_bisimulation,expected.states_branching_bisimulation, expected.transitions_branching_bisimulation);
   l=l_in;
+  reduce(l,lts::lts_eq_branching_bisim_sigref_parallel);
+  test_lts(test_description + " (branching bisimulation signature, multi-threaded)",l, expected.labels_branching_bisimulation,expected.states_branching_bisimulation, expected.transitions_branching_bisimulation);
+  l=l_in;
   reduce(l,lts::lts_eq_divergence_preserving_branching_bisim);
   test_lts(test_description + " (divergence-preserving branching bisimulation [Groote/Jansen/Keiren/Wijs 2017])",l,
                                       expected.labels_divergence_preserving_branching_bisimulation,
@@ -118,6 +124,12 @@ static void reduce_lts_in_various_ways(const std::string& test_description,
                                       expected.states_divergence_preserving_branching_bisimulation,
                                       expected.transitions_divergence_preserving_branching_bisimulation);
   l=l_in;
+  reduce(l,lts::lts_eq_divergence_preserving_branching_bisim_sigref_parallel);
+  test_lts(test_description + " (divergence-preserving branching bisimulation signature, multi-threaded)",l,
+                                      expected.labels_divergence_preserving_branching_bisimulation,
+                                      expected.states_divergence_preserving_branching_bisimulation,
+                                      expected.transitions_divergence_preserving_branching_bisimulation);
+  l=l_in;
   reduce(l,lts::lts_eq_weak_bisim);
   test_lts(test_description + " (weak bisimulation)",l, expected.labels_weak_bisimulation,expected.states_weak_bisimulation, expected.transitions_weak_bisimulation);
   l=l_in;
@@ -667,6 +679,59 @@ void test_is_deterministic()
   is_deterministic_test2();
 }
 
+void test_aut_streaming()
+{
+  std::string automaton =
+    "des (0,4,3)\n"
+    "(0,\"a(1, 2)\",1)\n"
+    "\n"
+    "( 1 , tau , 2 )\r\n"
+    "(2,\"b\",0)\n"
+    "(2,\"a(1,2)\",2)";
+
+  std::vector<std::size_t> header;
+  std::vector<std::string> labels;
+  std::istringstream is(automaton);
+  lts::read_aut(is,
+    [&](std::size_t initial_state, std::size_t number_of_transitions, std::size_t number_of_states)
+    {
+      header = { initial_state, number_of_transitions, number_of_states };
+    },
+    [&](std::size_t from, const std::string& label, std::size_t to)
+    {
+      labels.push_back(std::to_string(from) + label + std::to_string(to));
+    }
+  );
+  BOOST_CHECK(header == std::vector<std::size_t>({ 0, 4, 3 }));
+  BOOST_CHECK(labels == std::vector<std::string>({ "0a(1,2)1", "1tau2", "2b0", "2a(1,2)2" }));
+
+  std::istringstream is1(automaton);
+  lts::lts_aut_t l;
+  l.load(is1);
+  test_lts("streaming aut", l, 3, 3, 4);
+
+  std::ostringstream out;
+  {
+    lts::aut_writer writer(out, 0, 2, 12345678901);
+    writer.write_transition(0, "a(1,2)", 12345678900);
+    writer.write_transition(12345678900, "tau", 0);
+  }
+  BOOST_CHECK(out.str() == "des (0,2,12345678901)\n(0,\"a(1,2)\",12345678900)\n(12345678900,\"tau\",0)\n");
+
+  std::istringstream is2("des (0,1,2)\n(0,\"a\",2)\n");
+  bool caught = false;
+  try
+  {
+    lts::lts_aut_t l2;
+    l2.load(is2);
+  }
+  catch (const mcrl2::runtime_error&)
+  {
+    caught = true;
+  }
+  BOOST_CHECK(caught);
+}
+
 int test_main(int /* argc*/, char** /* argv */)
 {
   reduce_simple_loop();
@@ -676,6 +741,7 @@ int test_main(int /* argc*/, char** /* argv */)
   reduce_peterson();
   test_reachability();
   test_is_deterministic();
+  test_aut_streaming();
   failing_test_groote_wijs_algorithm();
   counterexample_jk_1(3);
   counterexample_postprocessing();
@@ -13,6 +13,7 @@
 #ifndef MCRL2_PBES_PBESINST_ALTERNATIVE_LAZY_ALGORITHM_H
 #define MCRL2_PBES_PBESINST_ALTERNATIVE_LAZY_ALGORITHM_H
 
+#include "mcrl2/atermpp/indexed_set.h"
 #include "mcrl2/bes/remove_level.h"
 #include "mcrl2/data/rewriter.h"
 #include "mcrl2/pbes/detail/bes_equation_limit.h"
@@ -25,6 +26,7 @@
 #include "mcrl2/pbes/rewriters/enumerate_quantifiers_rewriter.h"
 #include "mcrl2/pbes/search_strategy.h"
 #include "mcrl2/pbes/transformation_strategy.h"
+#include <algorithm>
 #include <cassert>
 #include <ctime>
 #include <deque>
@@ -33,7 +35,6 @@
 #include <sstream>
 #include <stack>
 #include <unordered_map>
-#include <unordered_set>
 
 namespace mcrl2
 {
@@ -44,27 +45,30 @@ namespace pbes_system
 namespace detail
 {
   // The following function is a helper function to allow to create m_pv_renaming outside
-  // the class such that the class becomes a lightweight object.
-
-  std::unordered_map<propositional_variable_instantiation,propositional_variable_instantiation>
-  create_pv_renaming(std::vector<std::vector<propositional_variable_instantiation> >& instantiations,
-                                bool short_renaming_scheme)
+  // the class such that the class becomes a lightweight object. The result maps the index
+  // of an instantiation to its new name.
+
+  inline
+  std::vector<propositional_variable_instantiation>
+  create_pv_renaming(const atermpp::indexed_set<propositional_variable_instantiation>& instances,
+                     const std::vector<std::vector<std::size_t> >& instantiations,
+                     bool short_renaming_scheme)
   {
     std::size_t index=0;
-    std::unordered_map<propositional_variable_instantiation,propositional_variable_instantiation> pv_renaming;
-    for(const std::vector<propositional_variable_instantiation>& vec: instantiations)
+    std::vector<propositional_variable_instantiation> pv_renaming(instances.size());
+    for(const std::vector<std::size_t>& vec: instantiations)
     {
-      for(const propositional_variable_instantiation& inst:vec)
+      for(std::size_t i: vec)
       {
         if (short_renaming_scheme)
         {
           std::stringstream ss;
           ss << "X" << index;
-          pv_renaming[inst]=propositional_variable_instantiation(ss.str(),data::data_expression_list());
+          pv_renaming[i]=propositional_variable_instantiation(ss.str(),data::data_expression_list());
         }
         else
         {
-          pv_renaming[inst]=pbesinst_rename()(inst);
+          pv_renaming[i]=pbesinst_rename()(instances.get(i));
         }
         index++;
       }
@@ -75,18 +79,22 @@ namespace detail
   class rename_pbesinst_consecutively: public std::unary_function<propositional_variable_instantiation, propositional_variable_instantiation>
   {
     protected:
-      const std::unordered_map<propositional_variable_instantiation,propositional_variable_instantiation>& m_pv_renaming;
+      const atermpp::indexed_set<propositional_variable_instantiation>& m_instances;
+      const std::vector<propositional_variable_instantiation>& m_pv_renaming;
 
     public:
-      rename_pbesinst_consecutively(const std::unordered_map<propositional_variable_instantiation,propositional_variable_instantiation>& pv_renaming)
-       :  m_pv_renaming(pv_renaming)
+      rename_pbesinst_consecutively(const atermpp::indexed_set<propositional_variable_instantiation>& instances,
+                                    const std::vector<propositional_variable_instantiation>& pv_renaming)
+       :  m_instances(instances),
+          m_pv_renaming(pv_renaming)
       {}
 
 
       propositional_variable_instantiation operator()(const propositional_variable_instantiation& v) const
       {
-        assert(m_pv_renaming.count(v)>0);
-        return m_pv_renaming.at(v);
+        const std::size_t i = m_instances.index(v);
+        assert(i != atermpp::indexed_set<propositional_variable_instantiation>::npos && m_pv_renaming[i].defined());
+        return m_pv_renaming[i];
       }
   };
 } // end namespace detail
@@ -140,9 +148,27 @@ inline mcrl2::pbes_system::pbes_expression pbes_expression_order_quantified_vari
 
 /// \brief An alternative lazy algorithm for instantiating a PBES, ported from
 ///         bes_deprecated.h.
+/// \details Every generated propositional variable instantiation is stored once in an indexed set,
+/// and all other information about it is stored in vectors, using its index in this set.
 class pbesinst_alternative_lazy_algorithm
 {
   protected:
+    /// \brief The status of a propositional variable instantiation.
+    enum instance_status
+    {
+      unexplored, // it is neither in the todo buffer, nor does it have an equation
+      in_todo,    // it is in the todo buffer
+      explored    // it has an equation
+    };
+
+    /// \brief The value of a propositional variable instantiation that has a trivial right hand side.
+    enum trivial_value
+    {
+      not_trivial,
+      trivial_false,
+      trivial_true
+    };
+
     const data::data_specification& m_data_spec;
 
     /// \brief Data rewriter.
@@ -171,26 +197,38 @@ class pbesinst_alternative_lazy_algorithm
     /// Values are: none, some or all.
     const mcrl2::bes::remove_level m_erase_unused_bes_variables;
 
-    /// \brief Propositional variable instantiations that need to be handled.
-    std::deque<propositional_variable_instantiation> todo;
+    /// \brief The propositional variable instantiations that have been encountered. The vectors
+    ///        below are indexed by the index of an instantiation in this set.
+    atermpp::indexed_set<propositional_variable_instantiation> m_instances;
+
+    /// \brief The status of every instantiation.
+    std::vector<char> m_status;
+
+    /// \brief The right hand side of every explored instantiation.
+    std::vector<pbes_expression> m_equation;
 
-    /// \brief The content of todo as a set.
-    std::unordered_set<propositional_variable_instantiation> todo_set;
+    /// \brief The value of every instantiation of which the right hand side is known to be
+    ///        trivial (either true or false).
+    std::vector<char> m_trivial;
 
-    /// \brief Map a variable instantiation to a set of other variable
-    ///        instantiations on whose right hand sides it appears.
-    std::unordered_map<propositional_variable_instantiation, std::unordered_set<propositional_variable_instantiation> > occurrence;
+    /// \brief The occurrences of the instantiations on right hand sides, stored as linked lists of
+    ///        edges in two arrays, such that edges can be added without moving existing ones. The edges of
+    ///        instantiation i start at m_occurrence_first[i]. Edge e points to the instantiation
+    ///        m_occurrence_target[e] on whose right hand side i appears, and m_occurrence_next[e] is the
+    ///        next edge of i.
+    std::vector<std::size_t> m_occurrence_first;
+    std::vector<std::size_t> m_occurrence_target;
+    std::vector<std::size_t> m_occurrence_next;
 
-    /// \brief Map a variable instantiation to its right hand side.
-    std::unordered_map<propositional_variable_instantiation, pbes_expression> equation;
+    /// \brief The number of explored instantiations.
+    std::size_t m_equation_count;
 
-    /// \brief Map a variable instantiations to its right hand side
-    ///        when the latter is trivial (either true or false).
-    std::unordered_map<propositional_variable_instantiation, pbes_expression> trivial;
+    /// \brief Indices of the propositional variable instantiations that need to be handled.
+    std::deque<std::size_t> todo;
 
-    /// \brief instantiations[i] contains all instantiations of the variable
+    /// \brief instantiations[i] contains the indices of all explored instantiations of the variable
     ///        of the i-th equation in the PBES.
-    std::vector<std::vector<propositional_variable_instantiation> > instantiations;
+    std::vector<std::vector<std::size_t> > instantiations;
 
     /// \brief symbols[i] contains the fixedpoint symbol of the i-th equation
     ///        in the PBES.
@@ -235,6 +273,61 @@ class pbesinst_alternative_lazy_algorithm
       }
     }
 
+    /// \brief Returns the index of X, and adds X if it has not been encountered before.
+    std::size_t put_instance(const propositional_variable_instantiation& X)
+    {
+      const std::pair<std::size_t, bool> p = m_instances.put(X);
+      if (p.second)
+      {
+        assert(p.first == m_status.size());
+        m_status.push_back(unexplored);
+        m_equation.push_back(pbes_expression());
+        m_trivial.push_back(not_trivial);
+        m_occurrence_first.push_back(atermpp::npos);
+      }
+      return p.first;
+    }
+
+    /// \brief Returns the index of X, which must have been encountered before.
+    std::size_t instance_index(const propositional_variable_instantiation& X) const
+    {
+      const std::size_t i = m_instances.index(X);
+      assert(i != atermpp::indexed_set<propositional_variable_instantiation>::npos);
+      return i;
+    }
+
+    /// \brief Sets the right hand side of the instantiation with index i.
+    void set_equation(std::size_t i, const pbes_expression& phi)
+    {
+      if (m_status[i] != explored)
+      {
+        m_status[i] = explored;
+        m_equation_count++;
+      }
+      m_equation[i] = phi;
+    }
+
+    /// \brief Records that the instantiation with index i appears on the right hand side of the one with index j.
+    void add_occurrence(std::size_t i, std::size_t j)
+    {
+      m_occurrence_target.push_back(j);
+      m_occurrence_next.push_back(m_occurrence_first[i]);
+      m_occurrence_first[i] = m_occurrence_target.size() - 1;
+    }
+
+    static char make_trivial(const pbes_expression& x)
+    {
+      return is_true(x) ? trivial_true : (is_false(x) ? trivial_false : not_trivial);
+    }
+
+    /// \brief Sets the equation of the instantiation with index i to the approximating value.
+    void approximate(std::size_t i)
+    {
+      set_equation(i, m_approximate_true ? false_() : true_());
+      m_trivial[i] = make_trivial(m_equation[i]);
+      instantiations[equation_index[m_instances.get(i).name()]].push_back(i);
+    }
+
   public:
 
     /// \brief Constructor.
@@ -265,6 +358,7 @@ class pbesinst_alternative_lazy_algorithm
         m_approximate_true(approximate_true),
         m_elements_not_stored_in_todo_buffer(0),
         m_erase_unused_bes_variables(erase_unused_bes_variables),
+        m_equation_count(0),
         m_search_strategy(search_strategy),
         m_transformation_strategy(transformation_strategy)
     {
@@ -279,31 +373,31 @@ class pbesinst_alternative_lazy_algorithm
         m_search_strategy = depth_first;
     }
 
-    inline propositional_variable_instantiation next_todo()
+    inline std::size_t next_todo()
     {
-      assert(todo.size()==todo_set.size());
+      std::size_t X_e;
       if (m_search_strategy == breadth_first)
       {
-        const propositional_variable_instantiation X_e = todo.front();
+        X_e = todo.front();
         todo.pop_front();
-        todo_set.erase(X_e);
-        return X_e;
       }
       else
       {
-        const propositional_variable_instantiation X_e = todo.back();
+        X_e = todo.back();
         todo.pop_back();
-        todo_set.erase(X_e);
-        return X_e;
       }
+      assert(m_status[X_e] == in_todo);
+      m_status[X_e] = unexplored;
+      return X_e;
     }
 
-    inline void add_todo(const propositional_variable_instantiation& X)
+    inline void add_todo(std::size_t X)
     {
+      assert(m_status[X] == unexplored);
       if (todo.size()<m_maximum_todo_size)  // If there is no limit on todo, m_maximimum_todo_size is equal to npos.
       {
         todo.push_back(X);
-        todo_set.insert(X); // XXXXX
+        m_status[X] = in_todo;
       }
       else
       {
@@ -311,20 +405,14 @@ class pbesinst_alternative_lazy_algorithm
         if ((rand() % (todo.size() + m_elements_not_stored_in_todo_buffer)) < todo.size())
         {
           std::size_t index = rand() % (todo.size());
-          const propositional_variable_instantiation Y=todo[index];
-          equation[Y]=(m_approximate_true?false_():true_());
-          trivial[Y]=equation[Y];
-          instantiations[equation_index[Y.name()]].push_back(Y);
-
-          todo_set.erase(Y);
+          const std::size_t Y=todo[index];
+          approximate(Y);
           todo[index]=X;
-          todo_set.insert(X);
+          m_status[X] = in_todo;
         }
         else
         {
-          equation[X]=(m_approximate_true?false_():true_());
-          instantiations[equation_index[X.name()]].push_back(X);
-          trivial[X]=equation[X];
+          approximate(X);
         }
       }
     }
@@ -337,9 +425,9 @@ class pbesinst_alternative_lazy_algorithm
     template <bool is_mu>
     bool find_loop_rec(
         const pbes_expression& expr,
-        propositional_variable_instantiation X,
+        const propositional_variable_instantiation& X,
         std::size_t rank,
-        std::unordered_map<propositional_variable_instantiation, bool>& visited)
+        std::unordered_map<std::size_t, bool>& visited)
     {
       if (is_false(expr) || is_true(expr))
       {
@@ -356,17 +444,19 @@ class pbesinst_alternative_lazy_algorithm
         {
           return false;
         }
-        if (visited.count(Y))
+        const std::size_t i = instance_index(Y);
+        auto j = visited.find(i);
+        if (j != visited.end())
         {
-          return visited[Y];
+          return j->second;
         }
-        if (equation.count(Y) == 0)
+        if (m_status[i] != explored)
         {
           return false;
         }
-        visited[Y] = false;
-        bool b = find_loop_rec<is_mu>(equation[Y], X, rank, visited);
-        visited[Y] = b;
+        visited[i] = false;
+        bool b = find_loop_rec<is_mu>(m_equation[i], X, rank, visited);
+        visited[i] = b;
         return b;
       }
 
@@ -404,9 +494,9 @@ class pbesinst_alternative_lazy_algorithm
     }
 
     template <bool is_mu>
-    bool find_loop(pbes_expression expr, propositional_variable_instantiation X)
+    bool find_loop(const pbes_expression& expr, const propositional_variable_instantiation& X)
     {
-      std::unordered_map<propositional_variable_instantiation, bool> visited;
+      std::unordered_map<std::size_t, bool> visited;
       return find_loop_rec<is_mu>(expr, X, get_rank(X), visited);
     }
 
@@ -419,19 +509,14 @@ class pbesinst_alternative_lazy_algorithm
         return;
       }
 
-      // Create a set of reachable propositional_variable_instantiations
-      // and use that to clean up the set of equations.
-      std::unordered_set<propositional_variable_instantiation> reachable;
-
-      todo.clear();
-      todo_set.clear();
-      occurrence.clear();
-      for(std::vector<propositional_variable_instantiation>& vec: instantiations)
+      // Determine the reachable propositional_variable_instantiations, and put
+      // the ones without an equation in the todo buffer again.
+      std::vector<bool> reachable(m_instances.size(), false);
+      for (std::size_t X: todo)
       {
-        vec.clear();
+        m_status[X] = unexplored;
       }
-      assert(instantiations.size()==0 || instantiations[0].size()==0);
-
+      todo.clear();
 
       std::stack<pbes_expression> stack;
       stack.push(init);
@@ -443,13 +528,13 @@ class pbesinst_alternative_lazy_algorithm
 
         if (is_propositional_variable_instantiation(expr))
         {
-          const propositional_variable_instantiation& X = atermpp::vertical_cast<propositional_variable_instantiation>(expr);
-          if (reachable.count(X) == 0)
+          const std::size_t X = instance_index(atermpp::down_cast<propositional_variable_instantiation>(expr));
+          if (!reachable[X])
           {
-            if (equation.count(X)>0)
+            reachable[X] = true;
+            if (m_status[X] == explored)
             {
-              stack.push(equation[X]);
-              reachable.insert(X);
+              stack.push(m_equation[X]);
             }
             else
             {
@@ -470,42 +555,77 @@ class pbesinst_alternative_lazy_algorithm
           stack.push(expro.right());
         }
       }
-      // erase non reachable equations.
-      std::unordered_map<propositional_variable_instantiation, pbes_expression> new_equations;
-      for(std::unordered_map<propositional_variable_instantiation, pbes_expression>::const_iterator i=equation.begin(); i!=equation.end(); ++i)
+
+      // Keep the reachable instantiations, and the ones with a right hand side true or false
+      // if m_erase_unused_bes_variables is set to some. They are renumbered consecutively.
+      std::vector<std::size_t> new_index(m_instances.size(), atermpp::indexed_set<propositional_variable_instantiation>::npos);
+      atermpp::indexed_set<propositional_variable_instantiation> instances;
+      std::vector<char> status;
+      std::vector<pbes_expression> equation;
+      std::vector<char> trivial;
+      for (std::size_t X = 0; X < m_instances.size(); ++X)
+      {
+        if (reachable[X] || (m_erase_unused_bes_variables==bes::some && m_status[X] == explored && (is_true(m_equation[X]) || is_false(m_equation[X]))))
+        {
+          new_index[X] = instances.put(m_instances.get(X)).first;
+          status.push_back(m_status[X]);
+          equation.push_back(m_equation[X]);
+          trivial.push_back(m_trivial[X]);
+        }
+      }
+      m_instances = std::move(instances);
+      m_status.swap(status);
+      m_equation.swap(equation);
+      m_trivial.swap(trivial);
+      m_equation_count = std::count(m_status.begin(), m_status.end(), static_cast<char>(explored));
+
+      for (std::size_t& X: todo)
+      {
+        X = new_index[X];
+      }
+      for (std::vector<std::size_t>& vec: instantiations)
       {
-        // Insert the new equation if it is reachable, or if it equal to true or false and m_erase_unused_bes_variables is set to some.
-        if (reachable.count(i->first)>0 || (m_erase_unused_bes_variables==bes::some && (is_true(i->second) || is_false(i->second))))
-        {
-          new_equations.insert(*i);
-          std::size_t index = equation_index[i->first.name()];
-          instantiations[index].push_back(i->first);
-          std::set<propositional_variable_instantiation> rhs_variables = find_propositional_variable_instantiations(i->second);
-          for (const propositional_variable_instantiation& v: rhs_variables)
+        std::vector<std::size_t> new_vec;
+        for (std::size_t X: vec)
+        {
+          if (new_index[X] != atermpp::indexed_set<propositional_variable_instantiation>::npos)
           {
-            occurrence[v].insert(i->first);
+            new_vec.push_back(new_index[X]);
           }
+        }
+        vec.swap(new_vec);
+      }
 
+      // Rebuild the occurrences from the remaining equations.
+      m_occurrence_first.assign(m_instances.size(), atermpp::npos);
+      m_occurrence_target.clear();
+      m_occurrence_next.clear();
+      for (std::size_t Y = 0; Y < m_instances.size(); ++Y)
+      {
+        if (m_status[Y] == explored)
+        {
+          for (const propositional_variable_instantiation& v: find_propositional_variable_instantiations(m_equation[Y]))
+          {
+            add_occurrence(instance_index(v), Y);
+          }
         }
       }
-      equation.swap(new_equations);
     }
 
-    // The function below simplifies a boolean_expression, given the knowledge that some propositional variables in trivial
+    // The function below simplifies a boolean_expression, given the knowledge that some propositional variables
     // are known to be true or false. The idea is that variables that are redundant can be removed. If p = p1 && p2, and p1 is
     // false, then p2 can be removed, as its value does not influence the rewrite system.
     // The result of the function is a pair, with the simplified expression as first term, and the expression that is rewritten under the
     // simplifications in trivial as the second term.
     typedef std::pair < pbes_expression, pbes_expression > pbes_expression_pair;
-    pbes_expression_pair simplify_pbes_expression(const pbes_expression& p, const std::unordered_map<propositional_variable_instantiation, pbes_expression>& trivial)
+    pbes_expression_pair simplify_pbes_expression(const pbes_expression& p)
     {
       if (is_propositional_variable_instantiation(p))
       {
-        const std::unordered_map<propositional_variable_instantiation, pbes_expression>::const_iterator i=
-                                            trivial.find(atermpp::down_cast<propositional_variable_instantiation>(p));
-        if (i!=trivial.end() && (is_true(i->second) || is_false(i->second)))
+        const std::size_t i = m_instances.index(atermpp::down_cast<propositional_variable_instantiation>(p));
+        if (i != atermpp::indexed_set<propositional_variable_instantiation>::npos && m_trivial[i] != not_trivial)
         {
-          return pbes_expression_pair(p,i->second);
+          return pbes_expression_pair(p, m_trivial[i] == trivial_true ? true_() : false_());
         }
         return pbes_expression_pair(p,p);
       }
@@ -516,8 +636,8 @@ class pbesinst_alternative_lazy_algorithm
       else if (is_and(p))
       {
         const and_& pa=atermpp::down_cast<and_>(p);
-        const pbes_expression_pair lhs=simplify_pbes_expression(pa.left(),trivial);
-        const pbes_expression_pair rhs=simplify_pbes_expression(pa.right(),trivial);
+        const pbes_expression_pair lhs=simplify_pbes_expression(pa.left());
+        const pbes_expression_pair rhs=simplify_pbes_expression(pa.right());
         if (is_false(lhs.second))
         {
           return lhs;
@@ -538,8 +658,8 @@ class pbesinst_alternative_lazy_algorithm
       }
       assert(is_or(p));
       const or_& po=atermpp::down_cast<or_>(p);
-      const pbes_expression_pair lhs=simplify_pbes_expression(po.left(),trivial);
-      const pbes_expression_pair rhs=simplify_pbes_expression(po.right(),trivial);
+      const pbes_expression_pair lhs=simplify_pbes_expression(po.left());
+      const pbes_expression_pair rhs=simplify_pbes_expression(po.right());
       if (is_true(lhs.second))
       {
         return lhs;
@@ -603,12 +723,13 @@ class pbesinst_alternative_lazy_algorithm
       }
 
       init = atermpp::down_cast<propositional_variable_instantiation>(R(p.initial_state()));
-      add_todo(init);
+      add_todo(put_instance(init));
       while (!todo.empty())
       {
-        const propositional_variable_instantiation X_e = next_todo();
+        const std::size_t i_e = next_todo();
+        const propositional_variable_instantiation X_e = m_instances.get(i_e);
         std::size_t index = equation_index[X_e.name()];
-        instantiations[index].push_back(X_e);
+        instantiations[index].push_back(i_e);
 
         const pbes_equation& eqn = pbes_equations[index];
         data::rewriter::substitution_type sigma;
@@ -628,7 +749,7 @@ class pbesinst_alternative_lazy_algorithm
         if (m_transformation_strategy >= optimize)
         {
           // Substitute all trivial variable instantiations by their values
-          pbes_expression_pair p=simplify_pbes_expression(psi_e,trivial);
+          pbes_expression_pair p=simplify_pbes_expression(psi_e);
           psi_e=p.first;
           rewritten_psi_e=p.second;
         }
@@ -637,7 +758,7 @@ class pbesinst_alternative_lazy_algorithm
           rewritten_psi_e=psi_e;
         }
         // Store the result
-        equation[X_e] = psi_e;
+        set_equation(i_e, psi_e);
 
         if (m_transformation_strategy >= on_the_fly_with_fixed_points)
         {
@@ -664,58 +785,57 @@ class pbesinst_alternative_lazy_algorithm
         std::set<propositional_variable_instantiation> psi_variables = find_propositional_variable_instantiations(psi_e);
         for (const propositional_variable_instantiation& v: psi_variables)
         {
-          if (todo_set.count(v) == 0 && equation.count(v) == 0)
+          const std::size_t i = put_instance(v);
+          if (m_status[i] == unexplored)
           {
-            add_todo(v);
+            add_todo(i);
           }
-          occurrence[v].insert(X_e);
+          add_occurrence(i, i_e);
         }
 
         if (m_transformation_strategy >= optimize && (is_true(rewritten_psi_e) || is_false(rewritten_psi_e)))
         {
-          trivial[X_e] = rewritten_psi_e;
+          m_trivial[i_e] = make_trivial(rewritten_psi_e);
           if (m_transformation_strategy >= on_the_fly)
           {
             // Substitute X_e to its value in all its occurrences, and
             // substitute all other variables to their values that are found
             // to be either true or false in all their occurrences.
-            std::stack<propositional_variable_instantiation> new_trivials;
-            new_trivials.push(X_e);
+            std::stack<std::size_t> new_trivials;
+            new_trivials.push(i_e);
             while (!new_trivials.empty())
             {
-              const propositional_variable_instantiation X = new_trivials.top();
+              const std::size_t X = new_trivials.top();
               new_trivials.pop();
 
-              const std::unordered_set<propositional_variable_instantiation> oc = occurrence[X];
-              std::unordered_map<propositional_variable_instantiation, pbes_expression> trivial_X;
-              trivial_X[X] = psi_e;
-              for (const propositional_variable_instantiation& Y: oc)
+              for (std::size_t edge = m_occurrence_first[X]; edge != atermpp::npos; edge = m_occurrence_next[edge])
               {
-                pbes_expression_pair p=simplify_pbes_expression(equation[Y],trivial);
-                equation[Y]=p.first;
-                const pbes_expression f=p.second;
+                const std::size_t Y = m_occurrence_target[edge];
+                pbes_expression_pair p=simplify_pbes_expression(m_equation[Y]);
+                m_equation[Y]=p.first;
+                const pbes_expression& f=p.second;
                 if (is_true(f) || is_false(f))
                 {
-                  trivial[Y] = f;
+                  m_trivial[Y] = make_trivial(f);
                   new_trivials.push(Y);
                 }
               }
-              occurrence.erase(X);
+              m_occurrence_first[X] = atermpp::npos;
             }
           }
         }
 
         if (m_transformation_strategy >= on_the_fly)
         {
-          if (--regeneration_count == 0 || trivial.count(init)>0 )
+          if (--regeneration_count == 0 || m_trivial[instance_index(init)] != not_trivial)
           {
-            regeneration_count = equation.size() / 2;
+            regeneration_count = m_equation_count / 2;
             regenerate_states();
           }
         }
 
-        print_equation_count(equation.size(), equation.size()+todo.size(), todo.size()); // Print the number of equations every second in verbose mode.
-        detail::check_bes_equation_limit(equation.size());
+        print_equation_count(m_equation_count, m_equation_count+todo.size(), todo.size()); // Print the number of equations every second in verbose mode.
+        detail::check_bes_equation_limit(m_equation_count);
       }
       // Remove unnessary equations.
       regenerate_states();
@@ -725,19 +845,18 @@ class pbesinst_alternative_lazy_algorithm
     /// \return The computed bes in pbes format
     pbes get_result(bool short_rename_scheme=true)
     {
-      mCRL2log(log::verbose) << "Generated " << equation.size() << " BES equations in total, generating BES" << std::endl;
+      mCRL2log(log::verbose) << "Generated " << m_equation_count << " BES equations in total, generating BES" << std::endl;
       pbes result;
       std::size_t index = 0;
-      const std::unordered_map<propositional_variable_instantiation,propositional_variable_instantiation>
-            pv_renaming = detail::create_pv_renaming(instantiations,short_rename_scheme);
-      detail::rename_pbesinst_consecutively renamer(pv_renaming);
-      for (const std::vector<propositional_variable_instantiation>& vec: instantiations)
+      const std::vector<propositional_variable_instantiation> pv_renaming = detail::create_pv_renaming(m_instances, instantiations, short_rename_scheme);
+      detail::rename_pbesinst_consecutively renamer(m_instances, pv_renaming);
+      for (const std::vector<std::size_t>& vec: instantiations)
       {
         const fixpoint_symbol symbol = symbols[index++];
-        for (const propositional_variable_instantiation& X_e: vec)
+        for (std::size_t X_e: vec)
         {
-          const propositional_variable lhs = propositional_variable(renamer(X_e).name(), data::variable_list());
-          const pbes_expression rhs = replace_propositional_variables(equation[X_e], renamer);
+          const propositional_variable lhs = propositional_variable(pv_renaming[X_e].name(), data::variable_list());
+          const pbes_expression rhs = replace_propositional_variables(m_equation[X_e], renamer);
           result.equations().push_back(pbes_equation(symbol, lhs, rhs));
           mCRL2log(log::debug) << "BESEquation: " << atermpp::aterm(symbol) << " " << lhs << " = " << rhs << std::endl;
 
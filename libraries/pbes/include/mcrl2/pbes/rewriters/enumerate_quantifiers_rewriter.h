@@ -15,6 +15,7 @@
 #include "mcrl2/core/detail/print_utility.h"
 #include "mcrl2/data/data_specification.h"
 #include "mcrl2/data/detail/split_finite_variables.h"
+#include "mcrl2/data/enumerator_queue.h"
 #include "mcrl2/data/optimized_boolean_operators.h"
 #include "mcrl2/pbes/enumerator.h"
 #include "mcrl2/pbes/rewriters/simplify_rewriter.h"
@@ -54,6 +55,29 @@ struct enumerate_quantifiers_builder: public simplify_data_rewriter_builder<Deri
   /// The enumerator
   data::enumerator_algorithm<self> E;
 
+  /// \brief The todo lists of the enumerator. Since quantifiers can be nested, the todo list
+  /// of a nested quantifier is the one after the todo list of the surrounding quantifier.
+  /// The todo lists are kept, such that their storage can be reused.
+  std::deque<data::enumerator_queue<enumerator_element> > m_queues;
+
+  /// \brief The number of todo lists that is currently in use.
+  std::size_t m_queue_depth;
+
+  data::enumerator_queue<enumerator_element>& acquire_queue()
+  {
+    if (m_queue_depth == m_queues.size())
+    {
+      m_queues.emplace_back();
+    }
+    return m_queues[m_queue_depth++];
+  }
+
+  void release_queue(data::enumerator_queue<enumerator_element>& P)
+  {
+    P.clear();
+    m_queue_depth--;
+  }
+
   /// \brief Constructor.
   /// \param r A data rewriter.
   /// \param sigma A mutable substitution.
@@ -65,7 +89,7 @@ struct enumerate_quantifiers_builder: public simplify_data_rewriter_builder<Deri
                                 const data::data_specification& dataspec, 
                                 data::enumerator_identifier_generator& id_generator, 
                                 bool enumerate_infinite_sorts = true)
-    : super(r, sigma), m_dataspec(dataspec), m_enumerate_infinite_sorts(enumerate_infinite_sorts), E(*this, m_dataspec, r, id_generator, (std::numeric_limits<std::size_t>::max)(), true)
+    : super(r, sigma), m_dataspec(dataspec), m_enumerate_infinite_sorts(enumerate_infinite_sorts), E(*this, m_dataspec, r, id_generator, (std::numeric_limits<std::size_t>::max)(), true), m_queue_depth(0)
   {
     id_generator.clear();
   }
@@ -101,8 +125,8 @@ struct enumerate_quantifiers_builder: public simplify_data_rewriter_builder<Deri
   {
     auto undo = undo_substitution(v);
     pbes_expression result = true_();
-    std::deque<enumerator_element> P;
-    P.push_back(enumerator_element(v, derived().apply(phi)));
+    auto& P = acquire_queue();
+    P.emplace_back(v, derived().apply(phi));
     E.next(P, sigma, is_not_true());
     while (!P.empty())
     {
@@ -114,6 +138,7 @@ struct enumerate_quantifiers_builder: public simplify_data_rewriter_builder<Deri
       }
       E.next(P, sigma, is_not_true());
     }
+    release_queue(P);
     redo_substitution(v, undo);
     return result;
   }
@@ -122,8 +147,8 @@ struct enumerate_quantifiers_builder: public simplify_data_rewriter_builder<Deri
   {
     auto undo = undo_substitution(v);
     pbes_expression result = false_();
-    std::deque<enumerator_element> P;
-    P.push_back(enumerator_element(v, derived().apply(phi)));
+    auto& P = acquire_queue();
+    P.emplace_back(v, derived().apply(phi));
     E.next(P, sigma, is_not_false());
     while (!P.empty())
     {
@@ -135,6 +160,7 @@ struct enumerate_quantifiers_builder: public simplify_data_rewriter_builder<Deri
       }
       E.next(P, sigma, is_not_false());
     }
+    release_queue(P);
     redo_substitution(v, undo);
     return result;
   }
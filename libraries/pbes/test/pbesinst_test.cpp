@@ -11,6 +11,8 @@
 
 #define BOOST_TEST_MODULE pbesinst_test
 #include <boost/test/included/unit_test_framework.hpp>
+#include "mcrl2/bes/local_fixpoints.h"
+#include "mcrl2/bes/pbesinst_conversion.h"
 #include "mcrl2/data/enumerator.h"
 #include "mcrl2/lps/detail/test_input.h"
 #include "mcrl2/lps/linearise.h"
@@ -21,6 +23,7 @@
 #include "mcrl2/pbes/is_bes.h"
 #include "mcrl2/pbes/lps2pbes.h"
 #include "mcrl2/pbes/pbesinst_algorithm.h"
+#include "mcrl2/pbes/pbesinst_alternative_lazy_algorithm.h"
 #include "mcrl2/pbes/pbesinst_finite_algorithm.h"
 #include "mcrl2/pbes/pbesinst_symbolic.h"
 #include "mcrl2/pbes/rewriter.h"
@@ -264,6 +267,45 @@ BOOST_AUTO_TEST_CASE(test_abp_no_deadlock)
   BOOST_CHECK(is_bes(q));
 }
 
+void test_alternative_lazy(const pbes& p, bool expected_outcome)
+{
+  data::rewriter datar(p.data());
+  for (transformation_strategy trans_strat: { lazy, optimize, on_the_fly, on_the_fly_with_fixed_points })
+  {
+    for (search_strategy search_strat: { breadth_first, depth_first })
+    {
+      for (bes::remove_level erase: { bes::none, bes::some, bes::all })
+      {
+        pbes q = p;
+        pbesinst_alternative_lazy_algorithm algorithm(q.data(), datar, search_strat, trans_strat, erase);
+        algorithm.run(q);
+        pbes result = algorithm.get_result();
+        BOOST_CHECK(is_bes(result));
+        bes::boolean_equation_system b = bes::pbesinst_conversion(result);
+        bool outcome = bes::local_fixpoints(b);
+        if (outcome != expected_outcome)
+        {
+          std::cerr << "alternative lazy failed for strategy " << trans_strat << ", " << search_strat << ", " << erase << std::endl;
+        }
+        BOOST_CHECK_EQUAL(outcome, expected_outcome);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_pbesinst_alternative_lazy)
+{
+  test_alternative_lazy(txt2pbes(test2), true);
+  test_alternative_lazy(txt2pbes(test4), true);
+  test_alternative_lazy(txt2pbes("pbes mu X(n: Nat) = val(n >= 5) || X(n + 1); init X(0);"), true);
+  test_alternative_lazy(txt2pbes("pbes mu X(b: Bool) = X(!b); init X(true);"), false);
+  test_alternative_lazy(txt2pbes("pbes nu X(b: Bool) = Y(b) && X(!b); mu Y(b: Bool) = X(b) || val(b); init X(true);"), true);
+
+  lps::specification spec=remove_stochastic_operators(lps::linearise(lps::detail::ABP_SPECIFICATION()));
+  state_formulas::state_formula formula = state_formulas::parse_state_formula(lps::detail::NO_DEADLOCK(), spec);
+  test_alternative_lazy(lps2pbes(spec, formula, false), true);
+}
+
 // Example supplied by Tim Willemse, 23-05-2011
 BOOST_AUTO_TEST_CASE(test_functions)
 {
@@ -10,23 +10,24 @@
 #ifndef MCRL2_PG_ABORTABLE_H
 #define MCRL2_PG_ABORTABLE_H
 
+#include "mcrl2/utilities/thread_pool.h"
+
 /*! Mix-in class for classes whose operations can be aborted asynchronously.
 
     Classes inheriting Abortable should periodically check whether they are
     aborted by calling aborted() in time-consuming procedures.
+
+    Aborting uses the process wide abort request of the thread pool, so
+    aborting also cancels the tasks that are executed by the thread pool.
 */
 class Abortable
 {
 public:
     //! Abort all abortable processes.
-    static void abort_all() { global_abort_ = true; }
+    static void abort_all() { mcrl2::utilities::request_abort(); }
 
     //! Returns whether this instance has been aborted.
-    bool aborted() { return global_abort_; }
-
-private:
-    //! Global variable indicating whether the process has been aborted.
-    static volatile bool global_abort_;
+    bool aborted() { return mcrl2::utilities::abort_requested(); }
 };
 
 #endif /* ndef MCRL2_PG_ABORTABLE_H */
@@ -1,12 +0,0 @@
-// Copyright (c) 2009-2013 University of Twente
-// Copyright (c) 2009-2013 Michael Weber <michaelw@cs.utwente.nl>
-// Copyright (c) 2009-2013 Maks Verver <maksverver@geocities.com>
-// Copyright (c) 2009-2013 Eindhoven University of Technology
-//
-// Distributed under the Boost Software License, Version 1.0.
-// (See accompanying file LICENSE_1_0.txt or copy at
-// http://www.boost.org/LICENSE_1_0.txt)
-
-#include "mcrl2/pg/Abortable.h"
-
-volatile bool Abortable::global_abort_ = false;
@@ -0,0 +1,55 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/utilities/benchmark.h
+/// \brief Functions for writing micro-benchmarks of the libraries.
+
+#ifndef MCRL2_UTILITIES_BENCHMARK_H
+#define MCRL2_UTILITIES_BENCHMARK_H
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "mcrl2/utilities/metrics.h"
+
+namespace mcrl2
+{
+
+namespace utilities
+{
+
+/// \brief Measures the wall clock time of f(), which is supposed to perform the given number of operations.
+/// \details The measurements are stored in the metrics registry as the gauges benchmark.<name>.seconds,
+/// benchmark.<name>.operations and benchmark.<name>.operations_per_second.
+/// \return The number of seconds that f took.
+template <typename Function>
+double run_benchmark(const std::string& name, std::size_t operations, Function f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  metrics_registry& registry = metrics();
+  registry.gauge("benchmark." + name + ".seconds").set(seconds);
+  registry.gauge("benchmark." + name + ".operations").set(operations);
+  registry.gauge("benchmark." + name + ".operations_per_second").set(seconds > 0 ? operations / seconds : 0.0);
+  return seconds;
+}
+
+/// \brief Writes the results of all benchmarks, together with the other metrics, in JSON format to standard output.
+inline
+void report_benchmarks(const std::string& benchmark_name)
+{
+  metrics().write_json(std::cout, benchmark_name);
+}
+
+} // namespace utilities
+
+} // namespace mcrl2
+
+#endif // MCRL2_UTILITIES_BENCHMARK_H
@@ -0,0 +1,413 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/utilities/detail/worker_processes.h
+/// \brief Child processes that handle requests on behalf of the calling process.
+
+#ifndef MCRL2_UTILITIES_DETAIL_WORKER_PROCESSES_H
+#define MCRL2_UTILITIES_DETAIL_WORKER_PROCESSES_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <functional>
+#include <string>
+#include <vector>
+#include "mcrl2/utilities/exception.h"
+#include "mcrl2/utilities/logger.h"
+
+#if !(defined(_MSC_VER) || defined(__MINGW32__) || defined(__CYGWIN__))
+#define MCRL2_WORKER_PROCESSES_AVAILABLE
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace mcrl2 {
+
+namespace utilities {
+
+namespace detail {
+
+#ifdef MCRL2_WORKER_PROCESSES_AVAILABLE
+
+/// \brief Writes size bytes of data to the file descriptor fd.
+inline
+bool write_to_pipe(int fd, const void* data, std::size_t size)
+{
+  const char* p = static_cast<const char*>(data);
+  while (size > 0)
+  {
+    ssize_t n = ::write(fd, p, size);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    p += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+/// \brief Reads size bytes from the file descriptor fd. Returns false if the end of the input
+///        is reached before size bytes are read.
+inline
+bool read_from_pipe(int fd, void* data, std::size_t size)
+{
+  char* p = static_cast<char*>(data);
+  while (size > 0)
+  {
+    ssize_t n = ::read(fd, p, size);
+    if (n < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (n <= 0)
+    {
+      return false;
+    }
+    p += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+/// \brief Writes the size of text followed by text to the file descriptor fd.
+inline
+bool write_message(int fd, const std::string& text)
+{
+  std::size_t size = text.size();
+  return write_to_pipe(fd, &size, sizeof(size)) && write_to_pipe(fd, text.data(), size);
+}
+
+/// \brief Reads a message that was written by write_message from the file descriptor fd.
+inline
+bool read_message(int fd, std::string& text)
+{
+  std::size_t size;
+  if (!read_from_pipe(fd, &size, sizeof(size)))
+  {
+    return false;
+  }
+  text.assign(size, '\0');
+  return size == 0 || read_from_pipe(fd, &text[0], size);
+}
+
+#endif // MCRL2_WORKER_PROCESSES_AVAILABLE
+
+/// \brief Collects the log messages that are written during its lifetime, instead of writing them
+///        to the default output. This is used to send the log messages of a child process to the parent,
+///        that can write them in a deterministic order using replay.
+class log_message_collector: public log::output_policy
+{
+  protected:
+    std::string m_messages;
+
+  public:
+    log_message_collector()
+    {
+      log::logger::unregister_output_policy(log::default_output_policy());
+      log::logger::register_output_policy(*this);
+    }
+
+    ~log_message_collector()
+    {
+      log::logger::unregister_output_policy(*this);
+      log::logger::register_output_policy(log::default_output_policy());
+    }
+
+    void output(const log::log_level_t level, const std::string& /* hint */, const time_t /* timestamp */, const std::string& msg, const bool /* print_time_information */) override
+    {
+      m_messages += std::to_string(static_cast<int>(level)) + ' ' + std::to_string(msg.size()) + ' ' + msg;
+    }
+
+    /// \brief Returns the collected messages in a format that can be read by replay.
+    const std::string& messages() const
+    {
+      return m_messages;
+    }
+
+    /// \brief Writes the messages in text, starting at position pos, to the log.
+    /// \param text A string that ends with a value that was returned by messages()
+    static void replay(const std::string& text, std::size_t pos = 0)
+    {
+      while (pos < text.size())
+      {
+        std::size_t i = text.find(' ', pos);
+        std::size_t j = text.find(' ', i + 1);
+        if (i == std::string::npos || j == std::string::npos)
+        {
+          throw mcrl2::runtime_error("Invalid log messages received from a child process.");
+        }
+        log::log_level_t level = static_cast<log::log_level_t>(std::stoi(text.substr(pos, i - pos)));
+        std::size_t size = std::stoul(text.substr(i + 1, j - i - 1));
+        log::mcrl2_logger().get(level) << text.substr(j + 1, size);
+        pos = j + 1 + size;
+      }
+    }
+};
+
+/// \brief A fixed number of child processes that compute replies to requests.
+/// \details Since the term library is not thread safe, computations that create terms cannot be
+/// distributed over threads. Instead, each worker is a child process with its own copy of the memory of
+/// the calling process at the time the workers are created. Requests and replies are exchanged as
+/// strings over pipes. A worker stays alive until the object is destroyed, so that the state it builds
+/// up while handling requests, like the caches of a prover, is reused for subsequent requests.
+/// On platforms without fork(), or if no child process could be created, there are no workers, and
+/// the caller is expected to do the computations itself.
+class worker_processes
+{
+  protected:
+#ifdef MCRL2_WORKER_PROCESSES_AVAILABLE
+    struct worker
+    {
+      pid_t pid;
+      int request_fd;
+      int reply_fd;
+    };
+
+    std::vector<worker> m_workers;
+#endif
+
+    void stop_workers()
+    {
+#ifdef MCRL2_WORKER_PROCESSES_AVAILABLE
+      // Closing the request pipes causes the workers to terminate.
+      for (const worker& w: m_workers)
+      {
+        ::close(w.request_fd);
+        ::close(w.reply_fd);
+      }
+      for (const worker& w: m_workers)
+      {
+        int status;
+        while (::waitpid(w.pid, &status, 0) < 0 && errno == EINTR)
+        {
+        }
+      }
+      m_workers.clear();
+#endif
+    }
+
+  public:
+    /// \brief Creates number_of_workers child processes that compute the reply to a request using f.
+    /// \details If f throws an exception, its message is passed to the calling process, where it is
+    /// rethrown by map.
+    /// \param number_of_workers The number of child processes
+    /// \param f A function that maps a request to a reply
+    worker_processes(std::size_t number_of_workers, std::function<std::string(const std::string&)> f)
+    {
+#ifdef MCRL2_WORKER_PROCESSES_AVAILABLE
+      // Avoid that buffered output is written by the workers as well.
+      std::cout.flush();
+      std::cerr.flush();
+      std::fflush(nullptr);
+
+      for (std::size_t k = 0; k < number_of_workers; k++)
+      {
+        int request_fds[2];
+        int reply_fds[2];
+        if (::pipe(request_fds) < 0)
+        {
+          break;
+        }
+        if (::pipe(reply_fds) < 0)
+        {
+          ::close(request_fds[0]);
+          ::close(request_fds[1]);
+          break;
+        }
+        pid_t pid = ::fork();
+        if (pid < 0)
+        {
+          ::close(request_fds[0]);
+          ::close(request_fds[1]);
+          ::close(reply_fds[0]);
+          ::close(reply_fds[1]);
+          break;
+        }
+        if (pid == 0)
+        {
+          // The worker. It leaves via _exit, to prevent that the destructors of the objects of the
+          // calling process are run twice.
+          ::close(request_fds[1]);
+          ::close(reply_fds[0]);
+          for (const worker& w: m_workers)
+          {
+            ::close(w.request_fd);
+            ::close(w.reply_fd);
+          }
+          std::string request;
+          while (read_message(request_fds[0], request))
+          {
+            bool failed = false;
+            std::string reply;
+            try
+            {
+              reply = f(request);
+            }
+            catch (const std::exception& e)
+            {
+              failed = true;
+              reply = e.what();
+            }
+            if (!write_to_pipe(reply_fds[1], &failed, sizeof(failed)) || !write_message(reply_fds[1], reply))
+            {
+              break;
+            }
+          }
+          std::cout.flush();
+          std::cerr.flush();
+          std::fflush(nullptr);
+          ::_exit(0);
+        }
+        ::close(request_fds[0]);
+        ::close(reply_fds[1]);
+        m_workers.push_back(worker{pid, request_fds[1], reply_fds[0]});
+      }
+#else
+      (void)number_of_workers;
+      (void)f;
+#endif
+    }
+
+    worker_processes(const worker_processes&) = delete;
+    worker_processes& operator=(const worker_processes&) = delete;
+
+    ~worker_processes()
+    {
+      stop_workers();
+    }
+
+    /// \brief Returns the number of workers.
+    std::size_t size() const
+    {
+#ifdef MCRL2_WORKER_PROCESSES_AVAILABLE
+      return m_workers.size();
+#else
+      return 0;
+#endif
+    }
+
+    /// \brief Lets the workers compute the replies to the given requests, and returns them in the
+    ///        order of the requests.
+    /// \details Requests are handed out to the workers one at a time. If stop(reply) holds for the
+    /// reply to request i, the requests with an index larger than i are no longer handed out. Hence all
+    /// replies to requests with an index smaller than the smallest index for which stop holds are
+    /// available, while the replies to requests that were not handed out are empty.
+    /// \pre size() > 0
+    template <typename StopPredicate>
+    std::vector<std::string> map(const std::vector<std::string>& requests, StopPredicate stop)
+    {
+      std::vector<std::string> result(requests.size());
+#ifdef MCRL2_WORKER_PROCESSES_AVAILABLE
+      const std::size_t idle = std::size_t(-1);
+      std::vector<std::size_t> busy_with(m_workers.size(), idle);
+      std::size_t next = 0;
+      std::size_t stop_index = requests.size();
+      std::size_t number_of_busy_workers = 0;
+      std::string error;
+
+      auto hand_out = [&](std::size_t k)
+      {
+        if (next < requests.size() && next <= stop_index)
+        {
+          if (!write_message(m_workers[k].request_fd, requests[next]))
+          {
+            stop_workers();
+            throw mcrl2::runtime_error("Could not send a request to a worker process.");
+          }
+          busy_with[k] = next++;
+          number_of_busy_workers++;
+        }
+      };
+
+      for (std::size_t k = 0; k < m_workers.size(); k++)
+      {
+        hand_out(k);
+      }
+
+      std::vector<pollfd> fds(m_workers.size());
+      while (number_of_busy_workers > 0)
+      {
+        for (std::size_t k = 0; k < m_workers.size(); k++)
+        {
+          fds[k].fd = busy_with[k] == idle ? -1 : m_workers[k].reply_fd;
+          fds[k].events = POLLIN;
+          fds[k].revents = 0;
+        }
+        if (::poll(fds.data(), fds.size(), -1) < 0)
+        {
+          if (errno == EINTR)
+          {
+            continue;
+          }
+          stop_workers();
+          throw mcrl2::runtime_error(std::string("Waiting for the worker processes failed: ") + std::strerror(errno));
+        }
+        for (std::size_t k = 0; k < m_workers.size(); k++)
+        {
+          if (busy_with[k] == idle || fds[k].revents == 0)
+          {
+            continue;
+          }
+          std::size_t i = busy_with[k];
+          bool failed;
+          std::string reply;
+          if (!read_from_pipe(m_workers[k].reply_fd, &failed, sizeof(failed)) || !read_message(m_workers[k].reply_fd, reply))
+          {
+            stop_workers();
+            throw mcrl2::runtime_error("A worker process terminated unexpectedly.");
+          }
+          busy_with[k] = idle;
+          number_of_busy_workers--;
+          if (failed)
+          {
+            error = reply;
+            stop_index = 0;
+            next = requests.size();
+          }
+          else
+          {
+            result[i] = reply;
+            if (stop(result[i]) && i < stop_index)
+            {
+              stop_index = i;
+            }
+          }
+          hand_out(k);
+        }
+      }
+
+      if (!error.empty())
+      {
+        throw mcrl2::runtime_error(error);
+      }
+#else
+      (void)requests;
+      (void)stop;
+#endif
+      return result;
+    }
+};
+
+} // namespace detail
+
+} // namespace utilities
+
+} // namespace mcrl2
+
+#endif // MCRL2_UTILITIES_DETAIL_WORKER_PROCESSES_H
@@ -13,6 +13,7 @@
 #define MCRL2_UTILITIES_EXECUTION_TIMER_H
 
 #include "mcrl2/utilities/exception.h"
+#include "mcrl2/utilities/metrics.h"
 #include <ctime>
 #include <fstream>
 #include <map>
@@ -134,6 +135,18 @@ class execution_timer
       m_timings[timing_name].finish = clock();
     }
 
+    /// \brief Add all finished timings in seconds to the given registry, as gauges named <tool>.timing.<name>.
+    void add_to_metrics(metrics_registry& registry) const
+    {
+      for (const auto& t: m_timings)
+      {
+        if (t.second.finish != 0 && t.second.start <= t.second.finish)
+        {
+          registry.gauge(m_tool_name + ".timing." + t.first).set(static_cast<double>(t.second.finish - t.second.start)/CLOCKS_PER_SEC);
+        }
+      }
+    }
+
     /// \brief Write all timing information that has been recorded.
     ///
     /// Timing information is written to the filename that was provided in
@@ -0,0 +1,288 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/utilities/metrics.h
+/// \brief A registry of named performance metrics (counters, gauges and histograms)
+///        that can be written in JSON format.
+
+#ifndef MCRL2_UTILITIES_METRICS_H
+#define MCRL2_UTILITIES_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+namespace mcrl2
+{
+
+namespace utilities
+{
+
+/// \brief A monotonically increasing count, e.g. the number of rewrite steps.
+/// \details Updates are atomic with relaxed ordering, so they are cheap and may be done from any thread.
+class metrics_counter
+{
+  protected:
+    std::atomic<std::size_t> m_value;
+
+  public:
+    metrics_counter()
+      : m_value(0)
+    {}
+
+    void increment(std::size_t n = 1)
+    {
+      m_value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    std::size_t value() const
+    {
+      return m_value.load(std::memory_order_relaxed);
+    }
+};
+
+/// \brief A value that is set to the latest observation, e.g. a load factor or a queue size.
+class metrics_gauge
+{
+  protected:
+    std::atomic<double> m_value;
+
+  public:
+    metrics_gauge()
+      : m_value(0.0)
+    {}
+
+    void set(double value)
+    {
+      m_value.store(value, std::memory_order_relaxed);
+    }
+
+    double value() const
+    {
+      return m_value.load(std::memory_order_relaxed);
+    }
+};
+
+/// \brief A distribution of observed non-negative values, e.g. pause times in microseconds.
+/// \details Observations are counted in buckets of exponentially increasing size: bucket 0 contains
+/// the value 0 and bucket i > 0 contains the values in [2^(i-1), 2^i).
+class metrics_histogram
+{
+  public:
+    static const std::size_t number_of_buckets = 65;
+
+  protected:
+    std::atomic<std::size_t> m_buckets[number_of_buckets];
+    std::atomic<std::size_t> m_count;
+    std::atomic<std::uint64_t> m_sum;
+    std::atomic<std::uint64_t> m_max;
+
+  public:
+    metrics_histogram()
+      : m_count(0), m_sum(0), m_max(0)
+    {
+      for (std::atomic<std::size_t>& bucket: m_buckets)
+      {
+        bucket.store(0, std::memory_order_relaxed);
+      }
+    }
+
+    static std::size_t bucket(std::uint64_t value)
+    {
+      std::size_t result = 0;
+      for (; value != 0; value >>= 1)
+      {
+        result++;
+      }
+      return result;
+    }
+
+    void observe(std::uint64_t value)
+    {
+      m_buckets[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+      m_count.fetch_add(1, std::memory_order_relaxed);
+      m_sum.fetch_add(value, std::memory_order_relaxed);
+      std::uint64_t max = m_max.load(std::memory_order_relaxed);
+      while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+      {}
+    }
+
+    std::size_t count() const
+    {
+      return m_count.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t sum() const
+    {
+      return m_sum.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t max() const
+    {
+      return m_max.load(std::memory_order_relaxed);
+    }
+
+    std::size_t bucket_count(std::size_t i) const
+    {
+      return m_buckets[i].load(std::memory_order_relaxed);
+    }
+};
+
+/// \brief The collection of all metrics of a process, identified by name.
+/// \details Metric names are dot separated, with the library or tool as the first component,
+/// e.g. "data.rewrite_count" or "atermpp.garbage_collection_time_us". The references returned
+/// by counter, gauge and histogram remain valid for the lifetime of the registry, so code on a
+/// hot path should look a metric up once and keep the reference:
+/// \code
+/// static metrics_counter& count = metrics().counter("data.rewrite_count");
+/// count.increment();
+/// \endcode
+class metrics_registry
+{
+  protected:
+    mutable std::mutex m_mutex;
+    std::map<std::string, std::unique_ptr<metrics_counter> > m_counters;
+    std::map<std::string, std::unique_ptr<metrics_gauge> > m_gauges;
+    std::map<std::string, std::unique_ptr<metrics_histogram> > m_histograms;
+    std::chrono::steady_clock::time_point m_start;
+
+    template <typename Metric>
+    Metric& find_or_create(std::map<std::string, std::unique_ptr<Metric> >& metrics, const std::string& name)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      std::unique_ptr<Metric>& result = metrics[name];
+      if (!result)
+      {
+        result.reset(new Metric());
+      }
+      return *result;
+    }
+
+  public:
+    metrics_registry()
+      : m_start(std::chrono::steady_clock::now())
+    {}
+
+    /// \brief Returns the counter with the given name, which is created if it does not exist yet.
+    metrics_counter& counter(const std::string& name)
+    {
+      return find_or_create(m_counters, name);
+    }
+
+    /// \brief Returns the gauge with the given name, which is created if it does not exist yet.
+    metrics_gauge& gauge(const std::string& name)
+    {
+      return find_or_create(m_gauges, name);
+    }
+
+    /// \brief Returns the histogram with the given name, which is created if it does not exist yet.
+    metrics_histogram& histogram(const std::string& name)
+    {
+      return find_or_create(m_histograms, name);
+    }
+
+    /// \brief Returns the number of seconds since the creation of the registry.
+    double elapsed_seconds() const
+    {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+    /// \brief Writes all metrics as a single JSON object to out.
+    /// \param tool_name The name of the tool, which is included in the output.
+    void write_json(std::ostream& out, const std::string& tool_name = "") const;
+
+    /// \brief Writes all metrics as JSON to the file with the given name, replacing its contents.
+    void write_json(const std::string& filename, const std::string& tool_name = "") const;
+};
+
+/// \brief Returns the metrics registry of this process.
+metrics_registry& metrics();
+
+/// \brief Measures the time between its construction and destruction and adds it in microseconds to a histogram.
+class scoped_metrics_timer
+{
+  protected:
+    metrics_histogram& m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+
+  public:
+    scoped_metrics_timer(metrics_histogram& histogram)
+      : m_histogram(histogram),
+        m_start(std::chrono::steady_clock::now())
+    {}
+
+    ~scoped_metrics_timer()
+    {
+      m_histogram.observe(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count());
+    }
+};
+
+/// \brief Periodically writes the metrics registry to a file using a background thread.
+/// \details The file is written a final time when the writer is destroyed.
+class periodic_metrics_writer
+{
+  protected:
+    std::string m_filename;
+    std::string m_tool_name;
+    std::mutex m_mutex;
+    std::condition_variable m_stop_requested;
+    bool m_stopped;
+    std::thread m_thread;
+
+  public:
+    /// \param filename The file to which the metrics are written.
+    /// \param tool_name The name of the tool that is included in the output.
+    /// \param interval The number of seconds between two writes. If it is zero, the
+    ///                 metrics are only written when the writer is destroyed.
+    periodic_metrics_writer(const std::string& filename, const std::string& tool_name, std::size_t interval)
+      : m_filename(filename),
+        m_tool_name(tool_name),
+        m_stopped(false)
+    {
+      if (interval > 0)
+      {
+        m_thread = std::thread([this, interval]()
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          while (!m_stop_requested.wait_for(lock, std::chrono::seconds(interval), [this]() { return m_stopped; }))
+          {
+            metrics().write_json(m_filename, m_tool_name);
+          }
+        });
+      }
+    }
+
+    ~periodic_metrics_writer()
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopped = true;
+      }
+      m_stop_requested.notify_all();
+      if (m_thread.joinable())
+      {
+        m_thread.join();
+      }
+      metrics().write_json(m_filename, m_tool_name);
+    }
+};
+
+} // namespace utilities
+
+} // namespace mcrl2
+
+#endif // MCRL2_UTILITIES_METRICS_H
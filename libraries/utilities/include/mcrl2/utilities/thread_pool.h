@@ -0,0 +1,210 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/utilities/thread_pool.h
+/// \brief A work-stealing thread pool with task groups, parallel_for and cooperative cancellation.
+
+#ifndef MCRL2_UTILITIES_THREAD_POOL_H
+#define MCRL2_UTILITIES_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mcrl2
+{
+
+namespace utilities
+{
+
+/// \brief Requests all cooperative computations of this process to stop as soon as possible.
+/// \details Task groups do not start tasks anymore, and parallel_for does not apply its function to
+/// the remaining indices. Long running algorithms can check abort_requested() themselves.
+void request_abort();
+
+/// \brief Returns true if request_abort has been called, and reset_abort has not been called since.
+bool abort_requested();
+
+/// \brief Clears an abort request.
+void reset_abort();
+
+/// \brief A pool of worker threads that execute tasks.
+/// \details Each worker has its own deque of tasks. A worker pushes the tasks that it creates to the back of
+/// its own deque, and takes tasks from the back of it, so that it works depth first on recently created
+/// tasks. A worker with an empty deque steals a task from the front of the deque of another worker. Tasks
+/// that are submitted by threads outside the pool are put in a separate deque.
+///
+/// A pool with n threads has n - 1 worker threads. The n-th thread is the thread that waits for a task
+/// group, since it executes tasks while it waits. So a pool with one thread has no workers, and executes
+/// all tasks sequentially in task_group::wait.
+class thread_pool
+{
+  public:
+    typedef std::function<void()> task;
+
+  protected:
+    struct task_queue
+    {
+      std::mutex mutex;
+      std::deque<task> tasks;
+    };
+
+    std::size_t m_number_of_threads;
+
+    // m_queues[0] contains the tasks submitted by other threads, and m_queues[i] the tasks of worker i.
+    std::vector<std::unique_ptr<task_queue> > m_queues;
+    std::vector<std::thread> m_workers;
+
+    // The number of tasks in the queues.
+    std::atomic<std::size_t> m_queued;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stop;
+
+    void work(std::size_t index);
+
+    // Returns the index of the queue of the calling thread.
+    std::size_t queue_index() const;
+
+    // Removes a task from the queue with the given index, from the back if own is true and from the front
+    // otherwise. Returns false if the queue is empty.
+    bool pop(std::size_t index, bool own, task& t);
+
+  public:
+    /// \brief Constructor.
+    /// \param number_of_threads The number of threads that execute tasks, including the waiting thread.
+    ///        If it is 0, the number of hardware threads is used.
+    explicit thread_pool(std::size_t number_of_threads = 1);
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /// \brief Destructor. Waits until the workers have finished their current tasks.
+    ~thread_pool();
+
+    /// \brief Returns the number of threads that execute tasks.
+    std::size_t number_of_threads() const
+    {
+      return m_number_of_threads;
+    }
+
+    /// \brief Adds a task to the pool.
+    /// \details Exceptions must not escape from t; use a task_group to run tasks that may throw.
+    void submit(task t);
+
+    /// \brief Executes one queued task in the calling thread. Returns false if there are no queued tasks.
+    bool run_one();
+};
+
+/// \brief Returns the thread pool that is shared by the algorithms of this process.
+/// \details The number of threads is 1, unless it has been changed with set_number_of_threads. The pool
+/// is created when this function is called for the first time.
+thread_pool& default_thread_pool();
+
+/// \brief Sets the number of threads of the default thread pool. If it is 0, the number of hardware threads is used.
+/// \pre The default thread pool is not executing any tasks, and no references to it are used anymore.
+void set_number_of_threads(std::size_t number_of_threads);
+
+/// \brief Returns the number of threads of the default thread pool.
+std::size_t number_of_threads();
+
+/// \brief A set of tasks that can be waited for, and cancelled, together.
+/// \details If a task throws an exception, the group is cancelled, and the first exception is rethrown by
+/// wait. Tasks of a cancelled group that have not started yet are not executed, and tasks that are running
+/// can check is_cancelled to stop early. A group is also cancelled if abort_requested() holds.
+class task_group
+{
+  protected:
+    thread_pool& m_pool;
+    std::atomic<std::size_t> m_pending;
+    std::atomic<bool> m_cancelled;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::exception_ptr m_exception;
+
+    void finish_task();
+
+  public:
+    explicit task_group(thread_pool& pool = default_thread_pool());
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    /// \brief Destructor. Cancels the group and waits for the running tasks.
+    ~task_group();
+
+    /// \brief Adds the task f to the group.
+    void run(std::function<void()> f);
+
+    /// \brief Waits until all tasks of the group have finished, executing queued tasks in the meantime.
+    /// \details Rethrows the first exception that was thrown by a task.
+    void wait();
+
+    /// \brief Cancels the tasks of the group.
+    void cancel()
+    {
+      m_cancelled = true;
+    }
+
+    /// \brief Returns true if the group has been cancelled.
+    bool is_cancelled() const
+    {
+      return m_cancelled || abort_requested();
+    }
+};
+
+/// \brief Applies f to the indices begin, ..., end - 1 using the threads of pool.
+/// \details The range is split into chunks of at least grain_size indices, which are executed as tasks
+/// of a task group. The function is not applied to the remaining indices once the group has been
+/// cancelled. The first exception thrown by f is rethrown.
+/// \param grain_size The minimal number of indices in a chunk. If it is 0, a size is chosen such that
+///        there are a few chunks per thread.
+inline
+void parallel_for(std::size_t begin, std::size_t end, const std::function<void(std::size_t)>& f,
+                  std::size_t grain_size = 0, thread_pool& pool = default_thread_pool())
+{
+  if (begin >= end)
+  {
+    return;
+  }
+  const std::size_t n = end - begin;
+  if (grain_size == 0)
+  {
+    grain_size = std::max<std::size_t>(1, n / (4 * pool.number_of_threads()));
+  }
+
+  task_group group(pool);
+  for (std::size_t first = begin; first < end; first += std::min(grain_size, end - first))
+  {
+    const std::size_t last = first + std::min(grain_size, end - first);
+    group.run([first, last, &f, &group]()
+    {
+      for (std::size_t i = first; i < last && !group.is_cancelled(); i++)
+      {
+        f(i);
+      }
+    });
+  }
+  group.wait();
+}
+
+} // namespace utilities
+
+} // namespace mcrl2
+
+#endif // MCRL2_UTILITIES_THREAD_POOL_H
@@ -20,6 +20,8 @@
 
 #include "mcrl2/utilities/command_line_interface.h"
 #include "mcrl2/utilities/execution_timer.h"
+#include "mcrl2/utilities/metrics.h"
+#include "mcrl2/utilities/thread_pool.h"
 
 #ifdef WIN32
 #include <io.h>
@@ -65,6 +67,15 @@ class tool
     /// Determines whether timing output should be written
     bool m_timing_enabled;
 
+    /// The filename to which metrics must be written, or the empty string if metrics are not written
+    std::string m_metrics_filename;
+
+    /// The number of seconds between two writes of the metrics, or 0 if they are only written at exit
+    std::size_t m_metrics_interval;
+
+    /// The number of threads that may be used
+    std::size_t m_number_of_threads;
+
     /// \brief Add options to an interface description.
     /// \param desc An interface description
     virtual void add_options(interface_description& desc)
@@ -72,6 +83,12 @@ class tool
       desc.add_option("timings", make_optional_argument<std::string>("FILE", ""),
                       "append timing measurements to FILE. Measurements are written to "
                       "standard error if no FILE is provided");
+      desc.add_option("metrics", make_mandatory_argument("FILE"),
+                      "write performance metrics (counters, gauges and histograms) in JSON format to FILE at exit");
+      desc.add_option("metrics-interval", make_mandatory_argument("NUM"),
+                      "also write the performance metrics to the file of --metrics every NUM seconds");
+      desc.add_option("threads", make_mandatory_argument("NUM"),
+                      "use at most NUM threads for the parts of the computation that can be done in parallel (default 1)");
     }
 
     /// \brief Parse non-standard options
@@ -84,6 +101,27 @@ class tool
         log::mcrl2_logger::set_report_time_info();
         m_timing_filename = parser.option_argument("timings");
       }
+      if (parser.options.count("metrics") > 0)
+      {
+        m_metrics_filename = parser.option_argument("metrics");
+      }
+      if (parser.options.count("metrics-interval") > 0)
+      {
+        if (m_metrics_filename.empty())
+        {
+          throw parser.error("option --metrics-interval can only be used in combination with --metrics");
+        }
+        m_metrics_interval = parser.option_argument_as<std::size_t>("metrics-interval");
+      }
+      if (parser.options.count("threads") > 0)
+      {
+        m_number_of_threads = parser.option_argument_as<std::size_t>("threads");
+        if (m_number_of_threads < 1)
+        {
+          throw parser.error("the number of threads must be at least 1");
+        }
+        set_number_of_threads(m_number_of_threads);
+      }
     }
 
     /// \brief Executed only if run would be executed and invoked before run.
@@ -159,7 +197,9 @@ class tool
         m_known_issues(known_issues),
         m_timing_filename(""),
         m_timer(name),
-        m_timing_enabled(false)
+        m_timing_enabled(false),
+        m_metrics_interval(0),
+        m_number_of_threads(1)
     {}
 
     /// \brief Destructor.
@@ -176,6 +216,13 @@ class tool
       return m_timing_filename;
     }
 
+    /// \brief Returns the number of threads that may be used, as given by the option --threads.
+    /// \details The default thread pool (see default_thread_pool) has this number of threads.
+    std::size_t number_of_threads() const
+    {
+      return m_number_of_threads;
+    }
+
     /// \brief Return reference to the timer that can be used.
     execution_timer& timer()
     {
@@ -187,6 +234,7 @@ class tool
     /// \param argv Command line arguments
     /// \return The execution result
     /// \post If timing was enabled, timer().report() has been called
+    /// \post If metrics were requested, they have been written to the metrics file
     int execute(int argc, char* argv[])
     {
 #ifdef WIN32
@@ -219,9 +267,16 @@ class tool
             // method.
             m_timer = execution_timer(m_name, timing_filename());
 
+            std::unique_ptr<periodic_metrics_writer> metrics_writer;
+            if (!m_metrics_filename.empty())
+            {
+              metrics_writer.reset(new periodic_metrics_writer(m_metrics_filename, m_name, m_metrics_interval));
+            }
+
             timer().start("total");
             result = run();
             timer().finish("total");
+            timer().add_to_metrics(metrics());
 
             if (m_timing_enabled)
             {
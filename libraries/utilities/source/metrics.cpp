@@ -0,0 +1,147 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file metrics.cpp
+
+#include "mcrl2/utilities/metrics.h"
+#include "mcrl2/utilities/logger.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace mcrl2
+{
+
+namespace utilities
+{
+
+static std::string json_string(const std::string& s)
+{
+  std::string result = "\"";
+  for (char c: s)
+  {
+    switch (c)
+    {
+      case '"': result += "\\\""; break;
+      case '\\': result += "\\\\"; break;
+      case '\n': result += "\\n"; break;
+      case '\t': result += "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+        {
+          char buffer[8];
+          std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned int>(c));
+          result += buffer;
+        }
+        else
+        {
+          result += c;
+        }
+    }
+  }
+  return result + "\"";
+}
+
+static std::string json_number(double value)
+{
+  if (!std::isfinite(value))
+  {
+    return "null";
+  }
+  std::ostringstream out;
+  out.precision(std::numeric_limits<double>::max_digits10);
+  out << value;
+  return out.str();
+}
+
+void metrics_registry::write_json(std::ostream& out, const std::string& tool_name) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  out << "{\n";
+  out << "  \"tool\": " << json_string(tool_name) << ",\n";
+  out << "  \"elapsed_seconds\": " << json_number(elapsed_seconds()) << ",\n";
+
+  out << "  \"counters\": {";
+  std::string separator = "\n";
+  for (const auto& p: m_counters)
+  {
+    out << separator << "    " << json_string(p.first) << ": " << p.second->value();
+    separator = ",\n";
+  }
+  out << (m_counters.empty() ? "" : "\n  ") << "},\n";
+
+  out << "  \"gauges\": {";
+  separator = "\n";
+  for (const auto& p: m_gauges)
+  {
+    out << separator << "    " << json_string(p.first) << ": " << json_number(p.second->value());
+    separator = ",\n";
+  }
+  out << (m_gauges.empty() ? "" : "\n  ") << "},\n";
+
+  out << "  \"histograms\": {";
+  separator = "\n";
+  for (const auto& p: m_histograms)
+  {
+    const metrics_histogram& h = *p.second;
+    out << separator << "    " << json_string(p.first) << ": {"
+        << "\"count\": " << h.count()
+        << ", \"sum\": " << h.sum()
+        << ", \"max\": " << h.max()
+        << ", \"buckets\": [";
+
+    // Every bucket is written as a pair of its (exclusive) upper bound and its count.
+    std::string bucket_separator;
+    for (std::size_t i = 0; i < metrics_histogram::number_of_buckets; ++i)
+    {
+      std::size_t count = h.bucket_count(i);
+      if (count > 0)
+      {
+        out << bucket_separator << "[" << json_number(std::ldexp(1.0, static_cast<int>(i))) << ", " << count << "]";
+        bucket_separator = ", ";
+      }
+    }
+    out << "]}";
+    separator = ",\n";
+  }
+  out << (m_histograms.empty() ? "" : "\n  ") << "}\n";
+  out << "}\n";
+}
+
+void metrics_registry::write_json(const std::string& filename, const std::string& tool_name) const
+{
+  // The metrics are first written to a temporary file, such that a reader never sees a partially written file.
+  const std::string temporary_filename = filename + ".tmp";
+  {
+    std::ofstream out(temporary_filename.c_str());
+    if (!out)
+    {
+      mCRL2log(log::warning) << "Could not write metrics to " << filename << "." << std::endl;
+      return;
+    }
+    write_json(out, tool_name);
+  }
+  // On some platforms rename fails if the target exists.
+  if (std::rename(temporary_filename.c_str(), filename.c_str()) != 0 &&
+      (std::remove(filename.c_str()) != 0 || std::rename(temporary_filename.c_str(), filename.c_str()) != 0))
+  {
+    mCRL2log(log::warning) << "Could not write metrics to " << filename << "." << std::endl;
+  }
+}
+
+metrics_registry& metrics()
+{
+  static metrics_registry registry;
+  return registry;
+}
+
+} // namespace utilities
+
+} // namespace mcrl2
@@ -0,0 +1,276 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file thread_pool.cpp
+/// \brief A work-stealing thread pool with task groups, parallel_for and cooperative cancellation.
+
+#include "mcrl2/utilities/thread_pool.h"
+#include <chrono>
+
+namespace mcrl2
+{
+
+namespace utilities
+{
+
+namespace
+{
+
+std::atomic<bool> abort_flag(false);
+
+// The pool of which the calling thread is a worker, and the index of its queue.
+thread_local const thread_pool* current_pool = nullptr;
+thread_local std::size_t current_queue_index = 0;
+
+// The default thread pool is created when it is used for the first time, such that no threads are
+// started by tools that do not use it.
+std::mutex default_thread_pool_mutex;
+std::unique_ptr<thread_pool> default_thread_pool_instance;
+std::size_t default_number_of_threads = 1;
+
+} // namespace
+
+void request_abort()
+{
+  abort_flag = true;
+}
+
+bool abort_requested()
+{
+  return abort_flag.load(std::memory_order_relaxed);
+}
+
+void reset_abort()
+{
+  abort_flag = false;
+}
+
+thread_pool::thread_pool(std::size_t number_of_threads)
+  : m_number_of_threads(number_of_threads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : number_of_threads),
+    m_queued(0),
+    m_stop(false)
+{
+  for (std::size_t i = 0; i < m_number_of_threads; i++)
+  {
+    m_queues.emplace_back(new task_queue());
+  }
+  for (std::size_t i = 1; i < m_number_of_threads; i++)
+  {
+    m_workers.emplace_back([this, i]() { work(i); });
+  }
+}
+
+thread_pool::~thread_pool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_condition.notify_all();
+  for (std::thread& worker: m_workers)
+  {
+    worker.join();
+  }
+}
+
+std::size_t thread_pool::queue_index() const
+{
+  return current_pool == this ? current_queue_index : 0;
+}
+
+bool thread_pool::pop(std::size_t index, bool own, task& t)
+{
+  task_queue& q = *m_queues[index];
+  std::lock_guard<std::mutex> lock(q.mutex);
+  if (q.tasks.empty())
+  {
+    return false;
+  }
+  if (own)
+  {
+    t = std::move(q.tasks.back());
+    q.tasks.pop_back();
+  }
+  else
+  {
+    t = std::move(q.tasks.front());
+    q.tasks.pop_front();
+  }
+  m_queued--;
+  return true;
+}
+
+void thread_pool::submit(task t)
+{
+  task_queue& q = *m_queues[queue_index()];
+  {
+    std::lock_guard<std::mutex> lock(q.mutex);
+    q.tasks.push_back(std::move(t));
+  }
+  m_queued++;
+  if (!m_workers.empty())
+  {
+    // Taking the lock ensures that a worker that is about to wait sees the new task.
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_condition.notify_one();
+  }
+}
+
+bool thread_pool::run_one()
+{
+  if (m_queued == 0)
+  {
+    return false;
+  }
+  const std::size_t index = queue_index();
+  task t;
+  bool found = pop(index, true, t);
+  for (std::size_t k = 1; !found && k < m_queues.size(); k++)
+  {
+    found = pop((index + k) % m_queues.size(), false, t);
+  }
+  if (found)
+  {
+    t();
+  }
+  return found;
+}
+
+void thread_pool::work(std::size_t index)
+{
+  current_pool = this;
+  current_queue_index = index;
+  while (true)
+  {
+    if (run_one())
+    {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]() { return m_stop || m_queued > 0; });
+    if (m_stop)
+    {
+      return;
+    }
+  }
+}
+
+thread_pool& default_thread_pool()
+{
+  std::lock_guard<std::mutex> lock(default_thread_pool_mutex);
+  if (!default_thread_pool_instance)
+  {
+    default_thread_pool_instance.reset(new thread_pool(default_number_of_threads));
+  }
+  return *default_thread_pool_instance;
+}
+
+void set_number_of_threads(std::size_t number_of_threads)
+{
+  std::lock_guard<std::mutex> lock(default_thread_pool_mutex);
+  default_number_of_threads = number_of_threads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : number_of_threads;
+  default_thread_pool_instance.reset();
+}
+
+std::size_t number_of_threads()
+{
+  std::lock_guard<std::mutex> lock(default_thread_pool_mutex);
+  return default_number_of_threads;
+}
+
+task_group::task_group(thread_pool& pool)
+  : m_pool(pool),
+    m_pending(0),
+    m_cancelled(false)
+{}
+
+task_group::~task_group()
+{
+  cancel();
+  try
+  {
+    wait();
+  }
+  catch (...)
+  {
+    // The exception is lost, since wait has not been called explicitly.
+  }
+}
+
+void task_group::finish_task()
+{
+  // The counter is decremented while holding the lock, such that wait cannot return, and the group
+  // cannot be destroyed, before this function has finished.
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (--m_pending == 0)
+  {
+    m_condition.notify_all();
+  }
+}
+
+void task_group::run(std::function<void()> f)
+{
+  m_pending++;
+  m_pool.submit([this, f]()
+  {
+    if (!is_cancelled())
+    {
+      try
+      {
+        f();
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_exception)
+        {
+          m_exception = std::current_exception();
+        }
+        m_cancelled = true;
+      }
+    }
+    finish_task();
+  });
+}
+
+void task_group::wait()
+{
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      if (m_pending == 0)
+      {
+        break;
+      }
+    }
+    if (!m_pool.run_one())
+    {
+      // The remaining tasks are executed by other threads. Wake up regularly, since they may create
+      // new tasks that this thread can help with.
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait_for(lock, std::chrono::milliseconds(1), [this]() { return m_pending == 0; });
+    }
+  }
+
+  std::exception_ptr e;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::swap(e, m_exception);
+  }
+  if (e)
+  {
+    std::rethrow_exception(e);
+  }
+}
+
+} // namespace utilities
+
+} // namespace mcrl2
@@ -0,0 +1,87 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file metrics_test.cpp
+/// \brief Tests for the metrics registry.
+
+#include "mcrl2/utilities/metrics.h"
+#include <boost/test/minimal.hpp>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace mcrl2;
+
+void test_counter()
+{
+  utilities::metrics_registry registry;
+  utilities::metrics_counter& c = registry.counter("test.counter");
+  BOOST_CHECK(&c == &registry.counter("test.counter"));
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    threads.emplace_back([&c]() { for (std::size_t j = 0; j < 1000; ++j) { c.increment(); } });
+  }
+  for (std::thread& t: threads)
+  {
+    t.join();
+  }
+  BOOST_CHECK(c.value() == 4000);
+}
+
+void test_histogram()
+{
+  BOOST_CHECK(utilities::metrics_histogram::bucket(0) == 0);
+  BOOST_CHECK(utilities::metrics_histogram::bucket(1) == 1);
+  BOOST_CHECK(utilities::metrics_histogram::bucket(2) == 2);
+  BOOST_CHECK(utilities::metrics_histogram::bucket(3) == 2);
+  BOOST_CHECK(utilities::metrics_histogram::bucket(4) == 3);
+  BOOST_CHECK(utilities::metrics_histogram::bucket(~std::uint64_t(0)) == 64);
+
+  utilities::metrics_histogram h;
+  h.observe(0);
+  h.observe(3);
+  h.observe(3);
+  h.observe(100);
+  BOOST_CHECK(h.count() == 4);
+  BOOST_CHECK(h.sum() == 106);
+  BOOST_CHECK(h.max() == 100);
+  BOOST_CHECK(h.bucket_count(2) == 2);
+  BOOST_CHECK(h.bucket_count(7) == 1);
+}
+
+void test_json()
+{
+  utilities::metrics_registry registry;
+  registry.counter("a.count").increment(3);
+  registry.gauge("a.\"quoted\"").set(0.5);
+  registry.histogram("a.histogram").observe(2);
+
+  std::ostringstream out;
+  registry.write_json(out, "tool");
+  std::string text = out.str();
+  std::cout << text;
+  BOOST_CHECK(text.find("\"tool\": \"tool\"") != std::string::npos);
+  BOOST_CHECK(text.find("\"a.count\": 3") != std::string::npos);
+  BOOST_CHECK(text.find("\"a.\\\"quoted\\\"\": 0.5") != std::string::npos);
+  BOOST_CHECK(text.find("\"a.histogram\": {\"count\": 1, \"sum\": 2, \"max\": 2, \"buckets\": [[4, 1]]}") != std::string::npos);
+
+  std::ostringstream empty;
+  utilities::metrics_registry().write_json(empty);
+  BOOST_CHECK(empty.str().find("\"counters\": {},") != std::string::npos);
+}
+
+int test_main(int, char*[])
+{
+  test_counter();
+  test_histogram();
+  test_json();
+
+  return 0;
+}
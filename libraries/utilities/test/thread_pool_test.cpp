@@ -0,0 +1,128 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file thread_pool_test.cpp
+/// \brief Tests for the thread pool.
+
+#include "mcrl2/utilities/thread_pool.h"
+#include <boost/test/minimal.hpp>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace mcrl2;
+
+void test_parallel_for(std::size_t number_of_threads)
+{
+  utilities::thread_pool pool(number_of_threads);
+  std::vector<std::size_t> v(10000, 0);
+  utilities::parallel_for(0, v.size(), [&](std::size_t i) { v[i] = i * i; }, 0, pool);
+  for (std::size_t i = 0; i < v.size(); i++)
+  {
+    BOOST_CHECK(v[i] == i * i);
+  }
+
+  // Empty ranges and chunks that do not divide the range.
+  std::atomic<std::size_t> count(0);
+  utilities::parallel_for(5, 5, [&](std::size_t) { count++; }, 0, pool);
+  BOOST_CHECK(count == 0);
+  utilities::parallel_for(3, 1000, [&](std::size_t) { count++; }, 7, pool);
+  BOOST_CHECK(count == 997);
+}
+
+// Computes the n-th Fibonacci number with nested task groups.
+std::size_t fibonacci(std::size_t n, utilities::thread_pool& pool)
+{
+  if (n < 2)
+  {
+    return n;
+  }
+  std::size_t x = 0;
+  std::size_t y = 0;
+  utilities::task_group group(pool);
+  group.run([&]() { x = fibonacci(n - 1, pool); });
+  group.run([&]() { y = fibonacci(n - 2, pool); });
+  group.wait();
+  return x + y;
+}
+
+void test_nested_task_groups(std::size_t number_of_threads)
+{
+  utilities::thread_pool pool(number_of_threads);
+  BOOST_CHECK(fibonacci(18, pool) == 2584);
+}
+
+void test_exceptions(std::size_t number_of_threads)
+{
+  utilities::thread_pool pool(number_of_threads);
+  bool caught = false;
+  try
+  {
+    utilities::parallel_for(0, 1000, [](std::size_t i)
+    {
+      if (i == 500)
+      {
+        throw std::runtime_error("error at 500");
+      }
+    }, 1, pool);
+  }
+  catch (const std::runtime_error& e)
+  {
+    caught = std::string(e.what()) == "error at 500";
+  }
+  BOOST_CHECK(caught);
+}
+
+void test_cancellation(std::size_t number_of_threads)
+{
+  utilities::thread_pool pool(number_of_threads);
+  std::atomic<std::size_t> count(0);
+  {
+    utilities::task_group group(pool);
+    group.cancel();
+    for (std::size_t i = 0; i < 100; i++)
+    {
+      group.run([&]() { count++; });
+    }
+    group.wait();
+  }
+  BOOST_CHECK(count == 0);
+
+  utilities::request_abort();
+  BOOST_CHECK(utilities::abort_requested());
+  utilities::parallel_for(0, 1000, [&](std::size_t) { count++; }, 1, pool);
+  BOOST_CHECK(count == 0);
+  utilities::reset_abort();
+  utilities::parallel_for(0, 1000, [&](std::size_t) { count++; }, 1, pool);
+  BOOST_CHECK(count == 1000);
+}
+
+void test_default_thread_pool()
+{
+  BOOST_CHECK(utilities::number_of_threads() == 1);
+  utilities::set_number_of_threads(3);
+  BOOST_CHECK(utilities::number_of_threads() == 3);
+  BOOST_CHECK(utilities::default_thread_pool().number_of_threads() == 3);
+  std::atomic<std::size_t> sum(0);
+  utilities::parallel_for(0, 100, [&](std::size_t i) { sum += i; });
+  BOOST_CHECK(sum == 4950);
+  utilities::set_number_of_threads(1);
+}
+
+int test_main(int argc, char** argv)
+{
+  for (std::size_t number_of_threads: { 1, 2, 4 })
+  {
+    test_parallel_for(number_of_threads);
+    test_nested_task_groups(number_of_threads);
+    test_exceptions(number_of_threads);
+    test_cancellation(number_of_threads);
+  }
+  test_default_thread_pool();
+  return 0;
+}
@@ -25,6 +25,8 @@
 #include "mcrl2/bes/gauss_elimination.h"
 #include "mcrl2/bes/small_progress_measures.h"
 #include "mcrl2/bes/local_fixpoints.h"
+#include "mcrl2/bes/indexed_scc_solver.h"
+#include "mcrl2/bes/indexed_solvers.h"
 #include "mcrl2/bes/justification.h"
 #include "mcrl2/bes/solution_strategy.h"
 
@@ -66,7 +68,18 @@ class bessolve_tool: public bes_input_tool<input_tool>
       std::vector<bool> full_solution;
 
       timer().start("solving");
-      switch (strategy)
+      if (decompose)
+      {
+        indexed_boolean_equation_system b(bes);
+        result = indexed_scc_solve(b, &full_solution);
+      }
+      else if (indexed)
+      {
+        indexed_boolean_equation_system b(bes);
+        result = strategy == small_progr_measures ? indexed_small_progress_measures(b, &full_solution)
+                                                  : indexed_local_fixpoints(b, &full_solution);
+      }
+      else switch (strategy)
       {
         case gauss:
           result = gauss_elimination(bes);
@@ -96,6 +109,8 @@ class bessolve_tool: public bes_input_tool<input_tool>
   protected:
     solution_strategy_t strategy;
     bool print_justification;
+    bool indexed;
+    bool decompose;
 
     void add_options(interface_description& desc)
     {
@@ -106,6 +121,11 @@ class bessolve_tool: public bes_input_tool<input_tool>
                       .add_value(local_fixed_point),
                       "solve the BES using the specified STRATEGY:", 's');
       desc.add_option("print-justification", "print justification for solution. Works only with the local fixpoint strategy.", 'j');
+      desc.add_option("indexed", "solve the BES on a compact representation in which variables are numbered. "
+                      "Works only with the small progress measures and local fixpoint strategies.");
+      desc.add_option("scc", "solve the strongly connected components of the dependency graph of the BES "
+                      "separately, bottom components first and independent components in parallel. Implies "
+                      "--indexed, and works only with the local fixpoint strategy.");
     }
 
     void parse_options(const command_line_parser& parser)
@@ -113,6 +133,16 @@ class bessolve_tool: public bes_input_tool<input_tool>
       super::parse_options(parser);
       strategy = parser.option_argument_as<solution_strategy_t>("strategy");
       print_justification = parser.options.count("print-justification") > 0;
+      indexed = parser.options.count("indexed") > 0;
+      decompose = parser.options.count("scc") > 0;
+      if (decompose && strategy != local_fixed_point)
+      {
+        throw mcrl2::runtime_error("The strongly connected components can only be solved separately with the strategy lf.");
+      }
+      if (indexed && strategy == gauss)
+      {
+        throw mcrl2::runtime_error("The indexed representation cannot be used with the strategy gauss.");
+      }
       if (print_justification && strategy!=local_fixed_point)
       {
         throw mcrl2::runtime_error("Justifications can only be printed when the solving strategy is lf.");
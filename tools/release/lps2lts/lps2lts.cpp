@@ -156,6 +156,12 @@ class lps2lts_tool : public lps2lts_base
                  "they are mapped to the same hash), it can be useful to explore very "
                  "large LTSs that are otherwise not explorable. The default value for NUM is "
                  "2*10^8 (this corresponds to 25MB of memory). ",'b').
+      add_option("packed-states",
+                 "store the visited states as bit vectors, in which every process parameter takes "
+                 "a fixed number of bits. Parameters of sort Bool or of an enumerated sort take only "
+                 "as many bits as needed for their values, other parameters take 32 bits. This "
+                 "substantially reduces the memory that is needed for states when the state space is "
+                 "written in aut format or not written at all. ").
       add_option("max", make_mandatory_argument("NUM"),
                  "explore at most NUM states", 'l').
       add_option("todo-max", make_mandatory_argument("NUM"),
@@ -267,6 +273,14 @@ class lps2lts_tool : public lps2lts_base
         m_options.bithashing  = true;
         m_options.bithashsize = parser.option_argument_as< unsigned long > ("bit-hash");
       }
+      if (parser.options.count("packed-states"))
+      {
+        if (m_options.bithashing)
+        {
+          throw parser.error("Option --packed-states cannot be used in combination with -b/--bit-hash.");
+        }
+        m_options.packed_states = true;
+      }
       if (parser.options.count("max"))
       {
         m_options.max_states = parser.option_argument_as< unsigned long > ("max");
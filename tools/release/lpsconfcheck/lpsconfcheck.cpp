@@ -196,7 +196,8 @@ class lpsconfcheck_tool : public prover_tool< rewriter_tool<input_output_tool> >
         "mark confluent tau-summands of an LPS",
         "Checks which tau-summands of the mCRL2 LPS in INFILE are confluent, marks them by "
         "renaming them to ctau, and write the result to OUTFILE. If INFILE is not present "
-        "stdin is used. If OUTFILE is not present, stdout is used."),
+        "stdin is used. If OUTFILE is not present, stdout is used. With --threads=NUM the "
+        "confluence conditions are proven by NUM worker processes."),
       m_summand_number(0),
       m_generate_invariants(false),
       m_no_check(false),
@@ -244,7 +245,7 @@ class lpsconfcheck_tool : public prover_tool< rewriter_tool<input_output_tool> >
           spec, rewrite_strategy(),
           m_time_limit, m_path_eliminator, solver_type(),
           m_apply_induction, m_check_all, m_no_sums, m_conditions,
-          m_counter_example, m_generate_invariants, m_dot_file_name);
+          m_counter_example, m_generate_invariants, m_dot_file_name, number_of_threads());
 
         v_confluence_checker.check_confluence_and_mark(m_invariant, m_summand_number);
         save_lps(spec, output_filename());
@@ -17,6 +17,8 @@
 
 #include "mcrl2/utilities/input_tool.h"
 #include "mcrl2/utilities/tool.h"
+#include "mcrl2/data/rewriter_tool.h"
+#include "mcrl2/lps/io.h"
 
 #include "mcrl2/lts/lts_algorithm.h"
 #include "mcrl2/lts/lts_io.h"
@@ -25,12 +27,14 @@
 #include "mcrl2/lts/lts_aut.h"
 #include "mcrl2/lts/lts_fsm.h"
 #include "mcrl2/lts/lts_dot.h"
+#include "mcrl2/lts/detail/liblts_onthefly_refinement.h"
 
 
 using namespace std;
 using namespace mcrl2::lts;
 using namespace mcrl2::lts::detail;
 using namespace mcrl2::utilities::tools;
+using namespace mcrl2::data::tools;
 using namespace mcrl2::utilities;
 using namespace mcrl2::core;
 using namespace mcrl2::log;
@@ -59,7 +63,7 @@ struct t_tool_options
   bool generate_counter_examples;
 };
 
-typedef  input_tool ltscompare_base;
+typedef  rewriter_tool<input_tool> ltscompare_base;
 class ltscompare_tool : public ltscompare_base
 {
   private:
@@ -96,7 +100,11 @@ class ltscompare_tool : public ltscompare_base
                       "The input formats are determined by the contents of INFILE1 and INFILE2. "
                       "Options --in1 and --in2 can be used to force the input format of INFILE1 and INFILE2, respectively. "
                       "The supported formats are:\n"
-                      + mcrl2::lts::detail::supported_lts_formats_text()
+                      + mcrl2::lts::detail::supported_lts_formats_text() + "\n"
+                      "If INFILE1 or INFILE2 is a linear process specification (with extension .lps), the state spaces "
+                      "are generated on the fly while they are compared, and the comparison stops as soon as a difference "
+                      "is found. This is supported for the trace, weak trace and failures preorders and for trace and weak "
+                      "trace equivalence."
                      )
     {
     }
@@ -146,12 +154,146 @@ class ltscompare_tool : public ltscompare_base
       return true; // The tool terminates in a correct way.
     }
 
+    static bool is_lps_file(const std::string& filename)
+    {
+      const std::string extension = ".lps";
+      return filename.size() >= extension.size() &&
+             filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+    }
+
+    std::unique_ptr<onthefly_state_space> load_onthefly_state_space(const std::string& filename,
+                                                                    lts_type format,
+                                                                    onthefly_action_labels& labels)
+    {
+      if (is_lps_file(filename))
+      {
+        mcrl2::lps::stochastic_specification specification;
+        mcrl2::lps::load_lps(specification, filename);
+        return std::unique_ptr<onthefly_state_space>(
+                 new lps_onthefly_state_space(specification, labels, tool_options.tau_actions, rewrite_strategy()));
+      }
+
+      if (format == lts_none)
+      {
+        format = guess_format(filename);
+      }
+
+      switch (format)
+      {
+        case lts_lts:
+        {
+          lts_lts_t l;
+          l.load(filename);
+          return std::unique_ptr<onthefly_state_space>(new lts_onthefly_state_space<lts_lts_t>(l, labels, tool_options.tau_actions));
+        }
+        case lts_fsm:
+        {
+          lts_fsm_t l;
+          l.load(filename);
+          return std::unique_ptr<onthefly_state_space>(new lts_onthefly_state_space<lts_fsm_t>(l, labels, tool_options.tau_actions));
+        }
+        default:
+        {
+          lts_aut_t l;
+          l.load(filename);
+          return std::unique_ptr<onthefly_state_space>(new lts_onthefly_state_space<lts_aut_t>(l, labels, tool_options.tau_actions));
+        }
+      }
+    }
+
+    // Checks whether the state space first is included in the state space second.
+    bool onthefly_included(onthefly_state_space& first, onthefly_state_space& second, refinement_type refinement, bool weak_reduction)
+    {
+      std::vector<std::string> counter_example;
+      bool result = onthefly_refinement_checker(first, second, refinement, weak_reduction,
+                                                tool_options.generate_counter_examples ? &counter_example : nullptr);
+      if (!result && tool_options.generate_counter_examples)
+      {
+        mCRL2log(info) << "A counter example is the trace:";
+        for (const std::string& a: counter_example)
+        {
+          mCRL2log(info) << " " << a;
+        }
+        mCRL2log(info) << std::endl;
+      }
+      return result;
+    }
+
+    // Compares two state spaces of which at least one is given by a linear process specification.
+    bool onthefly_compare()
+    {
+      onthefly_action_labels labels;
+      std::unique_ptr<onthefly_state_space> first = load_onthefly_state_space(tool_options.name_for_first, tool_options.format_for_first, labels);
+      std::unique_ptr<onthefly_state_space> second = load_onthefly_state_space(tool_options.name_for_second, tool_options.format_for_second, labels);
+
+      if (tool_options.equivalence != lts_eq_none)
+      {
+        if (tool_options.equivalence != lts_eq_trace && tool_options.equivalence != lts_eq_weak_trace)
+        {
+          throw mcrl2::runtime_error("linear process specifications can only be compared on the fly modulo trace or weak trace equivalence");
+        }
+        const bool weak_reduction = tool_options.equivalence == lts_eq_weak_trace;
+        mCRL2log(verbose) << "comparing state spaces on the fly using " <<
+                     tool_options.equivalence << "..." << std::endl;
+        const bool result = onthefly_included(*first, *second, trace, weak_reduction) &&
+                            onthefly_included(*second, *first, trace, weak_reduction);
+        mCRL2log(info) << "LTSs are " << ((result) ? "" : "not ")
+                       << "equal ("
+                       << description(tool_options.equivalence) << ")\n";
+      }
+
+      if (tool_options.preorder != lts_pre_none)
+      {
+        refinement_type refinement = trace;
+        bool weak_reduction = false;
+        switch (tool_options.preorder)
+        {
+          case lts_pre_trace:
+          case lts_pre_trace_anti_chain:
+            break;
+          case lts_pre_weak_trace:
+          case lts_pre_weak_trace_anti_chain:
+            weak_reduction = true;
+            break;
+          case lts_pre_failures_refinement:
+            refinement = failures;
+            break;
+          case lts_pre_weak_failures_refinement:
+            refinement = failures;
+            weak_reduction = true;
+            break;
+          case lts_pre_failures_divergence_refinement:
+            refinement = failures_divergence;
+            weak_reduction = true;
+            break;
+          default:
+            throw mcrl2::runtime_error("linear process specifications can only be compared on the fly using a trace or failures preorder");
+        }
+        mCRL2log(verbose) << "comparing state spaces on the fly using " <<
+                     description(tool_options.preorder) << "..." << std::endl;
+        const bool result = onthefly_included(*first, *second, refinement, weak_reduction);
+        mCRL2log(info) << "The LTS in " << tool_options.name_for_first
+                       << " is " << ((result) ? "" : "not ")
+                       << "included in"
+                       << " the LTS in " << tool_options.name_for_second
+                       << " (using " << description(tool_options.preorder)
+                       << ")." << std::endl;
+      }
+
+      return true; // The tool terminates in a correct way.
+    }
+
   public:
     bool run()
     {
 
       check_preconditions();
 
+      if (is_lps_file(tool_options.name_for_first) || is_lps_file(tool_options.name_for_second))
+      {
+        return onthefly_compare();
+      }
+
       if (tool_options.format_for_first==lts_none)
       {
         tool_options.format_for_first = guess_format(tool_options.name_for_first);
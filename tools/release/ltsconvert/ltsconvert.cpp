@@ -261,14 +261,17 @@ class ltsconvert_tool : public input_output_tool
                       .add_value(lts_eq_bisim_gv)
                       .add_value(lts_eq_bisim_dnj)
                       .add_value(lts_eq_bisim_sigref)
+                      .add_value(lts_eq_bisim_sigref_parallel)
                       .add_value(lts_eq_branching_bisim)
                       .add_value(lts_eq_branching_bisim_gv)
                       .add_value(lts_eq_branching_bisim_dnj)
                       .add_value(lts_eq_branching_bisim_sigref)
+                      .add_value(lts_eq_branching_bisim_sigref_parallel)
                       .add_value(lts_eq_divergence_preserving_branching_bisim)
                       .add_value(lts_eq_divergence_preserving_branching_bisim_gv)
                       .add_value(lts_eq_divergence_preserving_branching_bisim_dnj)
                       .add_value(lts_eq_divergence_preserving_branching_bisim_sigref)
+                      .add_value(lts_eq_divergence_preserving_branching_bisim_sigref_parallel)
                       .add_value(lts_eq_weak_bisim)
                       .add_value(lts_eq_divergence_preserving_weak_bisim)
                       .add_value(lts_eq_sim)
@@ -0,0 +1,262 @@
+// Author(s): Rimco Boudewijns and Sjoerd Cranen
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+/**
+
+  @file barneshut.h
+
+  This file contains an octree that approximates the sum of the repulsive forces
+  between a set of points using the Barnes-Hut algorithm, and a function to
+  compute such forces in parallel. It does not depend on the user interface, such
+  that the force calculation can be benchmarked separately.
+
+*/
+
+#ifndef BARNESHUT_H
+#define BARNESHUT_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace Graph
+{
+
+/**
+ * @brief Calls f(i) for all i in [0, n), distributed over the available hardware threads.
+ * @param n The number of indices.
+ * @param minimumPerThread Below this number of indices per thread, no additional threads are started.
+ */
+template <typename Function>
+void parallelFor(std::size_t n, std::size_t minimumPerThread, Function f)
+{
+  std::size_t threads = (std::min)(static_cast<std::size_t>((std::max)(std::thread::hardware_concurrency(), 1u)),
+                                   n / (std::max)(minimumPerThread, std::size_t(1)));
+  if (threads <= 1)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      f(i);
+    }
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  std::size_t chunk = (n + threads - 1) / threads;
+  for (std::size_t t = 1; t < threads; ++t)
+  {
+    workers.emplace_back([=, &f]()
+    {
+      for (std::size_t i = t * chunk; i < (std::min)(n, (t + 1) * chunk); ++i)
+      {
+        f(i);
+      }
+    });
+  }
+  for (std::size_t i = 0; i < (std::min)(n, chunk); ++i)
+  {
+    f(i);
+  }
+  for (std::thread& worker : workers)
+  {
+    worker.join();
+  }
+}
+
+/**
+ * @brief An octree over a set of points, in which every cell stores the number of points
+ *        it contains and their center of mass.
+ * @details The type Vector must provide a constructor Vector(x, y, z), the accessors x(),
+ *          y() and z(), addition, subtraction, multiplication and division by a scalar, and
+ *          length(). Both QVector3D and simple vector types satisfy these requirements.
+ */
+template <typename Vector>
+class Octree
+{
+  private:
+    /// @brief A cube in the octree. A cell is either a leaf that contains the points
+    ///        m_points[first, first + count), or it has eight children starting at child.
+    struct Cell
+    {
+      Vector center;          ///< The center of the cube.
+      float halfSize;         ///< Half of the width of the cube.
+      Vector centerOfMass;    ///< The average position of the points in the cube.
+      std::size_t count;      ///< The number of points in the cube.
+      std::size_t first;      ///< The offset of the points of a leaf in m_points.
+      std::size_t child;      ///< The index of the first child, or 0 for a leaf.
+    };
+
+    static const std::size_t maximumLeafSize = 4;   ///< Leaves with more points are split.
+    static const std::size_t maximumDepth = 24;     ///< Coinciding points are never split further than this.
+
+    std::vector<Cell> m_cells;                     ///< The cells, of which the root is the first.
+    std::vector<std::size_t> m_points;             ///< The indices of the points, ordered by leaf.
+    std::vector<Vector> m_positions;               ///< The positions of the points, by index.
+
+    static std::size_t octant(const Vector& center, const Vector& p)
+    {
+      return (p.x() >= center.x() ? 1 : 0) + (p.y() >= center.y() ? 2 : 0) + (p.z() >= center.z() ? 4 : 0);
+    }
+
+    // Splits the cell, and recursively the children, until every leaf is small enough.
+    void split(std::size_t index, std::size_t depth)
+    {
+      if (m_cells[index].count <= maximumLeafSize || depth >= maximumDepth)
+      {
+        return;
+      }
+
+      // Sort the points of this cell by octant, such that every child covers a contiguous range.
+      const Cell cell = m_cells[index];
+      std::size_t counts[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+      for (std::size_t i = cell.first; i < cell.first + cell.count; ++i)
+      {
+        counts[octant(cell.center, m_positions[m_points[i]])]++;
+      }
+      std::size_t offsets[8];
+      offsets[0] = cell.first;
+      for (std::size_t o = 1; o < 8; ++o)
+      {
+        offsets[o] = offsets[o - 1] + counts[o - 1];
+      }
+      std::vector<std::size_t> sorted(cell.count);
+      std::size_t next[8];
+      std::copy(offsets, offsets + 8, next);
+      for (std::size_t i = cell.first; i < cell.first + cell.count; ++i)
+      {
+        std::size_t p = m_points[i];
+        sorted[next[octant(cell.center, m_positions[p])]++ - cell.first] = p;
+      }
+      std::copy(sorted.begin(), sorted.end(), m_points.begin() + cell.first);
+
+      const std::size_t child = m_cells.size();
+      m_cells[index].child = child;
+      const float quarter = cell.halfSize / 2.0f;
+      for (std::size_t o = 0; o < 8; ++o)
+      {
+        Cell c;
+        c.center = cell.center + Vector((o & 1) ? quarter : -quarter, (o & 2) ? quarter : -quarter, (o & 4) ? quarter : -quarter);
+        c.halfSize = quarter;
+        c.count = counts[o];
+        c.first = offsets[o];
+        c.child = 0;
+        Vector sum(0.0f, 0.0f, 0.0f);
+        for (std::size_t i = c.first; i < c.first + c.count; ++i)
+        {
+          sum = sum + m_positions[m_points[i]];
+        }
+        c.centerOfMass = c.count > 0 ? sum / static_cast<float>(c.count) : c.center;
+        m_cells.push_back(c);
+      }
+      for (std::size_t o = 0; o < 8; ++o)
+      {
+        split(child + o, depth + 1);
+      }
+    }
+
+  public:
+    /**
+     * @brief Builds the octree for the given points.
+     * @param positions The positions of the points. The index of a point is its index in this vector.
+     * @param points The indices of the points that are included in the tree.
+     */
+    void build(const std::vector<Vector>& positions, const std::vector<std::size_t>& points)
+    {
+      m_positions = positions;
+      m_points = points;
+      m_cells.clear();
+      if (m_points.empty())
+      {
+        return;
+      }
+
+      Vector minimum = m_positions[m_points.front()];
+      Vector maximum = minimum;
+      Vector sum(0.0f, 0.0f, 0.0f);
+      for (std::size_t p : m_points)
+      {
+        const Vector& v = m_positions[p];
+        minimum = Vector((std::min)(minimum.x(), v.x()), (std::min)(minimum.y(), v.y()), (std::min)(minimum.z(), v.z()));
+        maximum = Vector((std::max)(maximum.x(), v.x()), (std::max)(maximum.y(), v.y()), (std::max)(maximum.z(), v.z()));
+        sum = sum + v;
+      }
+
+      Cell root;
+      root.center = (minimum + maximum) / 2.0f;
+      root.halfSize = (std::max)((std::max)(maximum.x() - minimum.x(), maximum.y() - minimum.y()), maximum.z() - minimum.z()) / 2.0f + 1.0f;
+      root.centerOfMass = sum / static_cast<float>(m_points.size());
+      root.count = m_points.size();
+      root.first = 0;
+      root.child = 0;
+      m_cells.push_back(root);
+      split(0, 0);
+    }
+
+    /**
+     * @brief Returns the sum of the forces exerted on the point with the given index by all other points in the tree.
+     * @param index The index of a point in the tree.
+     * @param force A function such that force(a, b) is the force that a point at position b exerts on a point at position a.
+     * @param theta A cell that is seen at an angle (its width divided by its distance) below theta is
+     *        approximated by its center of mass. If theta is 0, the result is exact.
+     */
+    template <typename Force>
+    Vector force(std::size_t index, Force force, float theta) const
+    {
+      Vector result(0.0f, 0.0f, 0.0f);
+      if (m_cells.empty())
+      {
+        return result;
+      }
+
+      const Vector& position = m_positions[index];
+      std::vector<std::size_t> todo(1, 0);
+      while (!todo.empty())
+      {
+        const Cell& cell = m_cells[todo.back()];
+        todo.pop_back();
+        if (cell.count == 0)
+        {
+          continue;
+        }
+        if (cell.child == 0)
+        {
+          for (std::size_t i = cell.first; i < cell.first + cell.count; ++i)
+          {
+            if (m_points[i] != index)
+            {
+              result = result + force(position, m_positions[m_points[i]]);
+            }
+          }
+          continue;
+        }
+
+        // A cell that contains the point itself is never approximated.
+        const Vector diff = cell.center - position;
+        bool inside = std::abs(diff.x()) <= cell.halfSize && std::abs(diff.y()) <= cell.halfSize && std::abs(diff.z()) <= cell.halfSize;
+        if (!inside && 2.0f * cell.halfSize < theta * (cell.centerOfMass - position).length())
+        {
+          result = result + force(position, cell.centerOfMass) * static_cast<float>(cell.count);
+        }
+        else
+        {
+          for (std::size_t o = 0; o < 8; ++o)
+          {
+            todo.push_back(cell.child + o);
+          }
+        }
+      }
+      return result;
+    }
+};
+
+} // namespace Graph
+
+#endif // BARNESHUT_H
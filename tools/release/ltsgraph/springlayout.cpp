@@ -27,7 +27,8 @@ inline float frand(float min, float max)
 {
   //return ((float)qrand() / RAND_MAX) * (max - min) + min;
   // Fast pseudo rand, source: http://www.musicdsp.org/showone.php?id=273
-  static int32_t seed = 1;
+  // The seed is thread local, as the forces are calculated by multiple threads.
+  static thread_local int32_t seed = 1;
   seed *= 16807;
   return ((((float)seed) * 4.6566129e-010f) + 1.0) * (max - min) / 2.0 + min;
 }
@@ -52,7 +53,7 @@ inline void clip(float& f, float min, float max)
 //
 
 SpringLayout::SpringLayout(Graph& graph, GLWidget& glwidget)
-  : m_speed(0.001f), m_attraction(0.13f), m_repulsion(50.0f), m_natLength(50.0f), m_controlPointWeight(0.001f),
+  : m_speed(0.001f), m_attraction(0.13f), m_repulsion(50.0f), m_natLength(50.0f), m_controlPointWeight(0.001f), m_theta(0.5f),
     m_clipMin(QVector3D(0.0f, 0.0f, 0.0f)), m_clipMax(QVector3D(1000.0f, 1000.0f, 1000.0f)),
     m_graph(graph), m_ui(nullptr), m_forceCalculation(&SpringLayout::forceLTSGraph), m_glwidget(glwidget)
 {
@@ -144,32 +145,59 @@ void SpringLayout::apply()
     m_lforces.resize(m_graph.edgeCount());
     m_sforces.resize(m_graph.nodeCount());
 
+    // The repulsive forces are approximated using an octree for each kind of object, which
+    // reduces the cost of an iteration from quadratic to O(n log n) in the number of objects.
+    std::vector<std::size_t> nodes(nodeCount);
+    std::vector<QVector3D> nodePositions(m_graph.nodeCount());
     for (std::size_t i = 0; i < nodeCount; ++i)
     {
-      std::size_t n = sel ? m_graph.selectionNode(i) : i;
-
-      m_nforces[n] = QVector3D(0, 0, 0);
-      for (std::size_t j = 0; j < i; ++j)
-      {
-        std::size_t m = sel ? m_graph.selectionNode(j) : j;
+      nodes[i] = sel ? m_graph.selectionNode(i) : i;
+      nodePositions[nodes[i]] = m_graph.node(nodes[i]).pos();
+    }
+    std::vector<std::size_t> edges(edgeCount);
+    std::vector<QVector3D> handlePositions(m_graph.edgeCount());
+    std::vector<QVector3D> labelPositions(m_graph.edgeCount());
+    for (std::size_t i = 0; i < edgeCount; ++i)
+    {
+      edges[i] = sel ? m_graph.selectionEdge(i) : i;
+      handlePositions[edges[i]] = m_graph.handle(edges[i]).pos();
+      labelPositions[edges[i]] = m_graph.transitionLabel(edges[i]).pos();
+    }
+    m_nodeTree.build(nodePositions, nodes);
+    m_handleTree.build(handlePositions, edges);
+    m_labelTree.build(labelPositions, edges);
+
+    const float repulsion = m_repulsion;
+    const float controlPointRepulsion = m_repulsion * m_controlPointWeight;
+    const float natLength = m_natLength;
+    auto nodeRepulsion = [repulsion, natLength](const QVector3D& a, const QVector3D& b)
+    {
+      return repulsionForce(a, b, repulsion, natLength);
+    };
+    auto controlPointRepulsionForce = [controlPointRepulsion, natLength](const QVector3D& a, const QVector3D& b)
+    {
+      return repulsionForce(a, b, controlPointRepulsion, natLength);
+    };
 
-        QVector3D diff = repulsionForce(m_graph.node(n).pos(), m_graph.node(m).pos(), m_repulsion, m_natLength);
-        m_nforces[n] += diff;
-        m_nforces[m] -= diff;
-      }
+    parallelFor(nodeCount, parallelMinimumSize, [&](std::size_t i)
+    {
+      std::size_t n = nodes[i];
+      m_nforces[n] = m_nodeTree.force(n, nodeRepulsion, m_theta);
       m_sforces[n] = (this->*m_forceCalculation)(m_graph.node(n).pos(), m_graph.stateLabel(n).pos(), 0.0);
-    }
+    });
 
-    for (std::size_t i = 0; i < edgeCount; ++i)
+    parallelFor(edgeCount, parallelMinimumSize, [&](std::size_t i)
     {
-      std::size_t n = sel ? m_graph.selectionEdge(i) : i;
+      std::size_t n = edges[i];
+      m_hforces[n] = m_handleTree.force(n, controlPointRepulsionForce, m_theta);
+      m_lforces[n] = m_labelTree.force(n, controlPointRepulsionForce, m_theta);
+    });
 
+    // The spring forces change the forces on both end points of an edge, hence they are added sequentially.
+    for (std::size_t n : edges)
+    {
       Edge e = m_graph.edge(n);
       QVector3D f;
-      // Variables for repulsion calculations
-
-      m_hforces[n] = QVector3D(0, 0, 0);
-      m_lforces[n] = QVector3D(0, 0, 0);
 
       if (e.from() == e.to())
       {
@@ -185,27 +213,10 @@ void SpringLayout::apply()
 
       f = (this->*m_forceCalculation)(m_graph.handle(n).pos(), m_graph.transitionLabel(n).pos(), 0.0);
       m_lforces[n] += f;
-
-      for (std::size_t j = 0; j < i; ++j)
-      {
-        std::size_t m = sel ? m_graph.selectionEdge(j) : j;
-
-        // Handles
-        f = repulsionForce(m_graph.handle(n).pos(), m_graph.handle(m).pos(), m_repulsion * m_controlPointWeight, m_natLength);
-        m_hforces[n] += f;
-        m_hforces[m] -= f;
-
-        // Labels
-        f = repulsionForce(m_graph.transitionLabel(n).pos(), m_graph.transitionLabel(m).pos(), m_repulsion * m_controlPointWeight, m_natLength);
-        m_lforces[n] += f;
-        m_lforces[m] -= f;
-      }
     }
 
-    for (std::size_t i = 0; i < nodeCount; ++i)
+    for (std::size_t n : nodes)
     {
-      std::size_t n = sel ? m_graph.selectionNode(i) : i;
-
       if (!m_graph.node(n).anchored())
       {
         m_graph.node(n).pos_mutable() = applyForce(m_graph.node(n).pos(), m_nforces[n], m_speed);
@@ -218,10 +229,8 @@ void SpringLayout::apply()
       }
     }
 
-    for (std::size_t i = 0; i < edgeCount; ++i)
+    for (std::size_t n : edges)
     {
-      std::size_t n = sel ? m_graph.selectionEdge(i) : i;
-
       if (!m_graph.handle(n).anchored())
       {
         m_graph.handle(n).pos_mutable() = applyForce(m_graph.handle(n).pos(), m_hforces[n], m_speed);
@@ -317,6 +326,7 @@ SpringLayoutUi::SpringLayoutUi(SpringLayout& layout, QWidget* parent)
   m_ui.sldSpeed->setValue(m_layout.speed());
   m_ui.sldHandleWeight->setValue(m_layout.controlPointWeight());
   m_ui.sldNatLength->setValue(m_layout.naturalTransitionLength());
+  m_ui.sldTheta->setValue(m_layout.theta());
   m_ui.cmbForceCalculation->setCurrentIndex(m_layout.forceCalculation());
   connect(&m_updateTimer, SIGNAL(timeout()), this, SLOT(onTimeout()));
 }
@@ -340,7 +350,8 @@ QByteArray SpringLayoutUi::settings()
       quint32(m_ui.sldSpeed->value()) <<
       quint32(m_ui.sldHandleWeight->value()) <<
       quint32(m_ui.sldNatLength->value()) <<
-      quint32(m_ui.cmbForceCalculation->currentIndex());
+      quint32(m_ui.cmbForceCalculation->currentIndex()) <<
+      quint32(m_ui.sldTheta->value());
 
   return result;
 }
@@ -366,6 +377,14 @@ void SpringLayoutUi::setSettings(QByteArray state)
     m_ui.cmbForceCalculation->setCurrentIndex(ForceCalculation);
   }
 
+  // Settings that were saved before the approximation was introduced do not contain theta.
+  quint32 theta;
+  in >> theta;
+  if (in.status() == QDataStream::Ok)
+  {
+    m_ui.sldTheta->setValue(theta);
+  }
+
 }
 
 void SpringLayoutUi::onAttractionChanged(int value)
@@ -395,6 +414,11 @@ void SpringLayoutUi::onNatLengthChanged(int value)
   m_layout.setNaturalTransitionLength(value);
 }
 
+void SpringLayoutUi::onThetaChanged(int value)
+{
+  m_layout.setTheta(value);
+}
+
 void SpringLayoutUi::onForceCalculationChanged(int value)
 {
   switch (value)
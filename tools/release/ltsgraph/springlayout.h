@@ -23,6 +23,7 @@
 #include "ui_springlayout.h"
 #include <QtOpenGL>
 
+#include "barneshut.h"
 #include "graph.h"
 #include "glwidget.h"
 
@@ -48,8 +49,11 @@ class SpringLayout
     float m_repulsion;            ///< The repulsion of other nodes.
     float m_natLength;            ///< The natural length of springs.
     float m_controlPointWeight;   ///< The handle repulsion wight factor.
+    float m_theta;                ///< The accuracy of the Barnes-Hut approximation of the repulsion; 0 is exact.
     float m_z;
     std::vector<QVector3D> m_nforces, m_hforces, m_lforces, m_sforces;  ///< Vector of the calculated forces..
+    Octree<QVector3D> m_nodeTree, m_handleTree, m_labelTree;            ///< Octrees used to approximate the repulsion.
+    static const std::size_t parallelMinimumSize = 1000;               ///< The minimal number of objects per thread.
     QVector3D m_clipMin;            ///< The minimum coordinates for any node.
     QVector3D m_clipMax;            ///< The maximum coordinates for any node.
 
@@ -133,6 +137,9 @@ class SpringLayout
     int naturalTransitionLength() const {
       return m_natLength;
     }
+    int theta() const {
+      return m_theta * 100.0;
+    }
     void setSpeed(int v) {
       m_speed = (float)v / 10000.0;
     }
@@ -145,6 +152,9 @@ class SpringLayout
     void setControlPointWeight(int v) {
       m_controlPointWeight = (float)v / 1000.0;
     }
+    void setTheta(int v) {
+      m_theta = (float)v / 100.0;
+    }
     void setNaturalTransitionLength(int v) {
       m_repulsion /= m_natLength * m_natLength * m_natLength;
       m_natLength = v;
@@ -224,6 +234,12 @@ class SpringLayoutUi : public QDockWidget
      */
     void onNatLengthChanged(int value);
 
+    /**
+     * @brief Updates the accuracy of the approximation of the repulsion.
+     * @param value The new value.
+     */
+    void onThetaChanged(int value);
+
     /**
      * @brief Updates the force calculation.
      * @param value The new index selected.
@@ -15,6 +15,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include "mcrl2/utilities/logger.h"
 #include "mcrl2/lps/io.h"
@@ -22,6 +23,8 @@
 #include "mcrl2/utilities/input_output_tool.h"
 #include "mcrl2/data/rewriter_tool.h"
 #include "mcrl2/process/parse.h"
+#include "mcrl2/process/print.h"
+#include "mcrl2/utilities/toolset_version.h"
 
 // #include "gc.h"  Required for ad hoc garbage collection. This is possible with ATcollect,
 // useful to find garbage collection problems.
@@ -37,6 +40,7 @@ class mcrl22lps_tool : public rewriter_tool< input_output_tool >
     mcrl2::lps::t_lin_options m_linearisation_options;
     bool noalpha;   // indicates whether alpha reduction is needed.
     bool opt_check_only;
+    bool opt_cache;
 
   protected:
 
@@ -129,6 +133,11 @@ class mcrl22lps_tool : public rewriter_tool< input_output_tool >
                       "process.");
       desc.add_option("check-only",
                       "check syntax and static semantics; do not linearise", 'e');
+      desc.add_option("cache",
+                      "store the linearised specification together with the input specification and the "
+                      "linearisation options in the file OUTFILE.lincache. If this file exists and neither the "
+                      "specification nor the options have changed, the LPS is taken from it instead of "
+                      "linearising the specification again. Requires that OUTFILE is present.");
     }
 
     void parse_options(const mcrl2::utilities::command_line_parser& parser)
@@ -136,6 +145,7 @@ class mcrl22lps_tool : public rewriter_tool< input_output_tool >
       super::parse_options(parser);
 
       opt_check_only                                  = 0 < parser.options.count("check-only");
+      opt_cache                                       = 0 < parser.options.count("cache");
       noalpha                                         = 0 < parser.options.count("no-alpha");
       m_linearisation_options.final_cluster           = 0 < parser.options.count("cluster");
       m_linearisation_options.no_intermediate_cluster = 0 < parser.options.count("no-cluster");
@@ -157,6 +167,10 @@ class mcrl22lps_tool : public rewriter_tool< input_output_tool >
       {
         throw parser.error("option -w/--newstate cannot be used with -lstack/--lin-method=stack");
       }
+      if (opt_cache && output_filename().empty())
+      {
+        throw parser.error("option --cache requires that an output file is specified");
+      }
 
       m_linearisation_options.rewrite_strategy = rewrite_strategy();
     }
@@ -169,9 +183,71 @@ class mcrl22lps_tool : public rewriter_tool< input_output_tool >
         "translate an mCRL2 specification to an LPS",
         "Linearises the mCRL2 specification in INFILE and writes the resulting LPS to "
         "OUTFILE. If OUTFILE is not present, stdout is used. If INFILE is not present, "
-        "stdin is used."), noalpha(false), opt_check_only(false)
+        "stdin is used."), noalpha(false), opt_check_only(false), opt_cache(false)
     {}
 
+    std::string cache_filename() const
+    {
+      return output_filename() + ".lincache";
+    }
+
+    // Returns a text that determines the result of the linearisation of spec. It consists of the
+    // version of the toolset, the linearisation options and the specification itself.
+    std::string cache_key(const mcrl2::process::process_specification& spec) const
+    {
+      const mcrl2::lps::t_lin_options& o = m_linearisation_options;
+      std::ostringstream out;
+      out << mcrl2::utilities::get_toolset_version() << "\n"
+          << o.lin_method << " " << o.no_intermediate_cluster << o.final_cluster << o.newstate << o.binary
+          << o.statenames << o.norewrite << o.noglobalvars << o.nosumelm << o.nodeltaelimination
+          << o.ignore_time << o.do_not_apply_constelm << " " << o.rewrite_strategy << "\n"
+          << mcrl2::process::pp(spec);
+      return out.str();
+    }
+
+    // Reads the LPS from the cache file if it was made with the given key.
+    bool load_from_cache(const std::string& key, mcrl2::lps::stochastic_specification& result) const
+    {
+      std::ifstream in(cache_filename().c_str(), std::ifstream::in|std::ifstream::binary);
+      if (!in.is_open())
+      {
+        return false;
+      }
+      std::size_t size = 0;
+      if (!(in >> size) || size != key.size() || in.get() != '\n')
+      {
+        return false;
+      }
+      std::string cached_key(size, '\0');
+      if (!in.read(&cached_key[0], size) || cached_key != key)
+      {
+        return false;
+      }
+      try
+      {
+        mcrl2::lps::load_lps(result, in, cache_filename());
+      }
+      catch (mcrl2::runtime_error& e)
+      {
+        mCRL2log(mcrl2::log::warning) << "Ignoring the cache file " << cache_filename() << ": " << e.what() << std::endl;
+        return false;
+      }
+      return true;
+    }
+
+    void save_to_cache(const std::string& key, const mcrl2::lps::stochastic_specification& spec) const
+    {
+      std::ofstream out(cache_filename().c_str(), std::ofstream::out|std::ofstream::binary);
+      if (!out.is_open())
+      {
+        mCRL2log(mcrl2::log::warning) << "Cannot write the cache file " << cache_filename() << "." << std::endl;
+        return;
+      }
+      out << key.size() << "\n";
+      out.write(key.data(), key.size());
+      mcrl2::lps::save_lps(spec, out, cache_filename());
+    }
+
     bool run()
     {
       //linearise infilename with options
@@ -210,8 +286,27 @@ class mcrl22lps_tool : public rewriter_tool< input_output_tool >
         }
         return true;
       }
+      mcrl2::lps::stochastic_specification linear_spec;
+      if (opt_cache)
+      {
+        const std::string key = cache_key(spec);
+        if (load_from_cache(key, linear_spec))
+        {
+          mCRL2log(mcrl2::log::verbose) << "The specification is unchanged; the LPS is read from "
+                                        << cache_filename() << "." << std::endl;
+        }
+        else
+        {
+          linear_spec = mcrl2::lps::linearise(spec, m_linearisation_options);
+          save_to_cache(key, linear_spec);
+        }
+      }
+      else
+      {
+        linear_spec = mcrl2::lps::linearise(spec, m_linearisation_options);
+      }
+
       //store the result
-      mcrl2::lps::stochastic_specification linear_spec(mcrl2::lps::linearise(spec, m_linearisation_options));
       mCRL2log(mcrl2::log::verbose) << "Writing LPS to "
                                     << (output_filename().empty() ? "stdout"
                                                                   : "file " + output_filename())